@@ -1,6 +1,8 @@
 // Example headers
 #include "CaloAxis.h"
 #include "dataobjects/CaloGeoParams.h"
+#include "Utils/ThreadIndex.h"
+#include "Utils/WorkStealingPool.h"
 
 // Root headers
 #include "TMatrixD.h"
@@ -10,6 +12,7 @@
 // C/C++ standard headers
 #include <numeric>
 #include <cmath>
+#include <algorithm>
 
 namespace Herd{
 RegisterAlgorithm(CaloAxis);
@@ -19,67 +22,121 @@ RegisterAlgorithm(CaloAxisStore);
 CaloAxis::CaloAxis(const std::string &name) :
   Algorithm{name},
   filterenable{true},
-  process_clusters{true}
+  process_clusters{true},
+  libclusters{false},
+  edepthreshold{0},
+  topk{-1},
+  mergedistance{-1},
+  nthreads{1},
+  parallelminclusters{8},
+  parallelminhits{2000},
+  perfcounters{false}
    {
     DefineParameter("filterenable",  filterenable); 
     DefineParameter("process_clusters", process_clusters);
+    DefineParameter("libclusters", libclusters);
     DefineParameter("edepthreshold", edepthreshold);
+    DefineParameter("topk", topk);
+    DefineParameter("mergedistance", mergedistance);
+    DefineParameter("nthreads", nthreads);
+    DefineParameter("parallelminclusters", parallelminclusters);
+    DefineParameter("parallelminhits", parallelminhits);
+    DefineParameter("scanthresholds", scanthresholds);
+    DefineParameter("perfcounters", perfcounters);
   }
 
+CaloAxis::~CaloAxis() {}
+
 bool CaloAxis::Initialize() {
   const std::string routineName("CaloAxis::Initialize");
 
   _evStore = GetDataStoreManager()->GetEventDataStore("evStore");      if (!_evStore)   { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
   _globStore = GetDataStoreManager()->GetGlobalDataStore("globStore"); if (!_globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
 
-  _processstore = std::make_shared<CaloAxisStore>("CaloAxisStore");
+  _caloGeoParams = _globStore->GetObject<CaloGeoParams>("caloGeoParams"); if (!_caloGeoParams) { COUT(ERROR) << "caloGeoParams not found." << ENDL; return false; }
+
   
   // Setup the filter                                                                                                                                                                                                                       
   if (filterenable) SetFilterStatus(FilterStatus::ENABLED); else SetFilterStatus(FilterStatus::DISABLED);
 
-  hhitedep = std::make_shared<TH1F>("hhitedep", "Hit.Edep()", 1500, log10(1e-10),log10(1e+5));
+  //Booked in ROOT as 1500 bins in log10(Edep) from -10 to 5, the bin lookup needs no log10 per hit
+  hhitedep.Reset(HitEDepHisto(Log10Axis(1500, 1e-10, 1e+5)));
+
+  // Threshold scan: thresholds are visited from the highest to the lowest
+  if( scanthresholds.size() > (size_t)CaloAxisStore::maxscanthresholds ) { COUT(ERROR) << "At most " << CaloAxisStore::maxscanthresholds << " scan thresholds are supported." << ENDL; return false; }
+  scanorder.resize(scanthresholds.size());
+  std::iota(scanorder.begin(), scanorder.end(), 0);
+  std::sort(scanorder.begin(), scanorder.end(), [this](int a, int b){ return scanthresholds[a] > scanthresholds[b]; });
+
+  // Intra-event parallelism for large events
+  if( nthreads<1 || nthreads>(int)MaxThreadShards ) { COUT(ERROR) << "The number of threads must be between 1 and " << MaxThreadShards << "." << ENDL; return false; }
+  if( nthreads>1 ) _pool.reset(new WorkStealingPool(nthreads));
+
+  _eventstate.caloaxisinfos.reserve(64);
+
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+  _processstores.Init("CaloAxisStore");
 
   return true;
 }
 
 bool CaloAxis::Process() {
-  const std::string routineName("CaloAxis::Process");
+  static const std::string routineName("CaloAxis::Process");
+  ProcessScope timing(_timer);
 
   //Add the ProcessStore object for this event to the event data store
-  //_processstore->Reset();
-  _evStore->AddObject("CaloAxisStore",_processstore);
+  auto store = _processstores.Acquire();
+  _evStore->AddObject("CaloAxisStore",store);
+  CaloAxisStore &processstore = *store;
 
   //Set Filter Status
   SetFilterResult(FilterResult::ACCEPT);
 
-  //Set vector sizes
-  caloaxisinfos.clear();
-  //ShowerEigenvalues.clear();
-  //ShowerEigenvectors.clear();
+  //Release the scratch buffers of the previous event
+  EventState &ev = _eventstate;
+  ev.Clear();
 
-  if( process_clusters ){
+  if( process_clusters && libclusters ){
+    auto caloclusterids = _evStore->GetObject<CaloClusterIDs>("caloClusterIDs");
+    if (!caloclusterids) { COUT(DEBUG) << "caloClusterIDs not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+    BuildAxis( ev, *caloclusterids );
+  }
+  else if( process_clusters ){
     auto caloclusters = _evStore->GetObject<CaloClusters>("caloClusters");
-    if (!_globStore) {COUT(ERROR) << "Global data store not found." << ENDL; return false;}
-    BuildAxis( *caloclusters );
+    if (!caloclusters) { COUT(DEBUG) << "caloClusters not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+    BuildAxis( ev, *caloclusters );
   }
   else{
     auto calohits = _evStore->GetObject<CaloHits>("caloHitsMC");
-    BuildAxis( *calohits );
+    BuildAxis( ev, *calohits );
+  }
+
+  if( !scanthresholds.empty() ){
+    auto calohits = _evStore->GetObject<CaloHits>("caloHitsMC");
+    if (!calohits) { COUT(DEBUG) << "CaloHitsMC not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+    ScanThresholds( ev, processstore, *calohits );
+  }
+
+  //No cluster with hits above edepthreshold (or no cluster at all): no axis, the store keeps its default values
+  if( ev.caloaxisinfos.empty() ){
+    COUT(DEBUG) << "No Calo axis for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
+    SetFilterResult(FilterResult::REJECT);
+    return true;
   }
 
-  _processstore->caloaxishits   = (unsigned int)caloaxisinfos.at(0).ShowerHits;
-  _processstore->caloaxiscog[0] = (float)caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::X];
-  _processstore->caloaxiscog[1] = (float)caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::Y];
-  _processstore->caloaxiscog[2] = (float)caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::Z];
-  _processstore->caloaxisdir[0] = (float)caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::X];
-  _processstore->caloaxisdir[1] = (float)caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::Y];
-  _processstore->caloaxisdir[2] = (float)caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::Z];
+  processstore.caloaxishits   = (unsigned int)ev.caloaxisinfos.at(0).ShowerHits;
+  processstore.caloaxiscog[0] = (float)ev.caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::X];
+  processstore.caloaxiscog[1] = (float)ev.caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::Y];
+  processstore.caloaxiscog[2] = (float)ev.caloaxisinfos.at(0).ShowerCOG[RefFrame::Coo::Z];
+  processstore.caloaxisdir[0] = (float)ev.caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::X];
+  processstore.caloaxisdir[1] = (float)ev.caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::Y];
+  processstore.caloaxisdir[2] = (float)ev.caloaxisinfos.at(0).ShowerDir[RefFrame::Coo::Z];
   for(int i=0; i<3; i++)
     {
-     _processstore->caloaxiseigval[i]    = (float)caloaxisinfos.at(0).ShowerEigenvalues[i];
-     _processstore->caloaxiseigvec[i][0] = (float)caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::X];
-     _processstore->caloaxiseigvec[i][1] = (float)caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::Y];
-     _processstore->caloaxiseigvec[i][2] = (float)caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::Z];
+     processstore.caloaxiseigval[i]    = (float)ev.caloaxisinfos.at(0).ShowerEigenvalues[i];
+     processstore.caloaxiseigvec[i][0] = (float)ev.caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::X];
+     processstore.caloaxiseigvec[i][1] = (float)ev.caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::Y];
+     processstore.caloaxiseigvec[i][2] = (float)ev.caloaxisinfos.at(0).ShowerEigenvectors[i][RefFrame::Coo::Z];
     }
   return true;
 }
@@ -89,164 +146,262 @@ bool CaloAxis::DummyCaloCluster(){
   return true;     
 }
 
-bool CaloAxis::BuildAxis(CaloClusters caloclusters){
+bool CaloAxis::UseParallel(unsigned int nclusters, unsigned int nhits) const{
+  return _pool && ( (int)nclusters>=parallelminclusters || (int)nhits>=parallelminhits );
+}
+
+bool CaloAxis::BuildAxis(EventState &ev, const CaloClusters &caloclusters){
 
-  for( auto const& calohits: caloclusters){
-    BuildAxis(calohits);
+  //Accumulate the moments of every cluster with a single pass over its hits
+  const int nclusters = (int)caloclusters.size();
+  ev.clustermoments = ev.arena.Allocate<CaloMoments>(nclusters);
+  ev.nclustermoments = nclusters;
+  unsigned int nhits=0; for(auto const& calohits: caloclusters) nhits += calohits.size();
+  ev.parallel = UseParallel(nclusters, nhits);
+
+  if( ev.parallel ){
+    //One task per cluster, each writing its own moments (the histogram is sharded per thread)
+    _pool->ParallelFor(nclusters, [this,&ev,&caloclusters](size_t ic, unsigned int){ AccumulateMoments(caloclusters[ic], ev.clustermoments[ic]); });
+  }
+  else{
+    for(int ic=0; ic<nclusters; ic++) AccumulateMoments(caloclusters[ic], ev.clustermoments[ic]);
+  }
+
+  return BuildClusterAxes(ev);
+}
+
+bool CaloAxis::BuildAxis(EventState &ev, const CaloClusterIDs &caloclusterids){
+
+  //Hits are already labelled: one pass over the SoA fills the moments of all clusters
+  const unsigned int nclusters = caloclusterids.NClusters();
+  const unsigned int nhits = caloclusterids.NHits();
+  ev.clustermoments = ev.arena.Allocate<CaloMoments>(nclusters);
+  ev.nclustermoments = nclusters;
+  ev.parallel = UseParallel(nclusters, nhits);
+
+  auto accumulate = [this,&caloclusterids](unsigned int first, unsigned int last, CaloMoments *moments){
+    for(unsigned int ihit=first; ihit<last; ihit++){
+      float edep = caloclusterids.hitEDep[ihit];
+      if( edep > edepthreshold ){
+        const Point &pos = _caloGeoParams->Position(caloclusterids.hitVolumeID[ihit]);
+        moments[caloclusterids.hitCluster[ihit]].Add(pos[RefFrame::Coo::X], pos[RefFrame::Coo::Y], pos[RefFrame::Coo::Z], edep);
+      }
+    }
+  };
+
+  if( ev.parallel ){
+    //Fixed-size hit chunks, each with its own partial moments, summed in chunk order:
+    //the result does not depend on the number of threads
+    const unsigned int nchunks = (nhits + chunkhits - 1) / chunkhits;
+    ev.chunkmoments = ev.arena.Allocate<CaloMoments>((size_t)nchunks*nclusters);
+    _pool->ParallelFor(nchunks, [&](size_t ichunk, unsigned int){
+      accumulate(ichunk*chunkhits, std::min(nhits, (unsigned int)(ichunk+1)*chunkhits), &ev.chunkmoments[ichunk*nclusters]); });
+    for(unsigned int ichunk=0; ichunk<nchunks; ichunk++)
+      for(unsigned int ic=0; ic<nclusters; ic++) ev.clustermoments[ic].Merge(ev.chunkmoments[(size_t)ichunk*nclusters+ic]);
+  }
+  else{
+    accumulate(0, nhits, ev.clustermoments);
+  }
+  for(unsigned int ihit=0; ihit<nhits; ihit++) if( caloclusterids.hitEDep[ihit] > edepthreshold ) hhitedep.Fill(caloclusterids.hitEDep[ihit]);
+
+  return BuildClusterAxes(ev);
+}
+
+bool CaloAxis::BuildClusterAxes(EventState &ev){
+
+  const int nclusters = ev.nclustermoments;
+
+  //Select the clusters to build the axis for
+  ev.clusterorder = ev.arena.Allocate<int>(nclusters);
+  int nsel=0;
+  if( topk<=0 && mergedistance<=0 ){
+    //Legacy mode: one axis per cluster, in input order
+    for(int ic=0; ic<nclusters; ic++) ev.clusterorder[nsel++] = ic;
+  }
+  else{
+    if( mergedistance>0 ) MergeClusters(ev);
+
+    //Rank the (merged) clusters by energy, only the first topk need to be ordered
+    int nranked=0;
+    for(int ic=0; ic<nclusters; ic++) if( ev.clustermoments[ic].n>0 ) ev.clusterorder[nranked++] = ic;
+    nsel = (topk>0 && topk<nranked) ? topk : nranked;
+    std::partial_sort(ev.clusterorder, ev.clusterorder+nsel, ev.clusterorder+nranked, [&ev](int a, int b){
+      if( ev.clustermoments[a].sumw != ev.clustermoments[b].sumw ) return ev.clustermoments[a].sumw > ev.clustermoments[b].sumw;
+      return a < b; });
+  }
+
+  //Each axis goes to its own slot, so the output order is the same in serial and parallel mode
+  ev.caloaxisinfos.resize(nsel);
+  if( ev.parallel ){
+    _pool->ParallelFor(nsel, [this,&ev](size_t i, unsigned int){ ComputeAxis(ev.clustermoments[ev.clusterorder[i]], ev.caloaxisinfos[i]); });
+  }
+  else{
+    for(int i=0; i<nsel; i++) ComputeAxis(ev.clustermoments[ev.clusterorder[i]], ev.caloaxisinfos[i]);
   }
 
   return true;
 }
 
-bool CaloAxis::BuildAxis(CaloHits calohits){
-  const std::string routineName("CaloAxis::BuildAxis");
+void CaloAxis::MergeClusters(EventState &ev){
+
+  //Single-linkage merging of clusters whose COGs are closer than mergedistance.
+  //The result does not depend on the cluster order; merged moments are moved to the root cluster.
+  const int nclusters = ev.nclustermoments;
+  ev.clusterparent = ev.arena.Allocate<int>(nclusters);
+  for(int ic=0; ic<nclusters; ic++) ev.clusterparent[ic] = ic;
+  auto find = [&ev](int i){ while( ev.clusterparent[i]!=i ){ ev.clusterparent[i] = ev.clusterparent[ev.clusterparent[i]]; i = ev.clusterparent[i]; } return i; };
+
+  const double maxdist2 = (double)mergedistance*mergedistance;
+  for(int ic=0; ic<nclusters; ic++){
+    if( ev.clustermoments[ic].n==0 ) continue;
+    for(int jc=ic+1; jc<nclusters; jc++){
+      if( ev.clustermoments[jc].n==0 ) continue;
+      double dist2=0; for(int k=0; k<3; k++) dist2 += pow(ev.clustermoments[ic].Cog(k)-ev.clustermoments[jc].Cog(k),2);
+      if( dist2<maxdist2 ){
+        int ri=find(ic), rj=find(jc);
+        if( ri!=rj ) ev.clusterparent[std::max(ri,rj)] = std::min(ri,rj);
+      }
+    }
+  }
 
-  auto caloGeoParams = _globStore->GetObject<CaloGeoParams>("caloGeoParams");
+  //Clusters are visited in increasing index, so every root precedes its children
+  for(int ic=0; ic<nclusters; ic++){
+    int root = find(ic);
+    if( root!=ic ){ ev.clustermoments[root].Merge(ev.clustermoments[ic]); ev.clustermoments[ic].Reset(); }
+  }
+}
 
-  std::vector<std::array<double,4>> x;
-  CaloAxisInfo caloaxisinfo;
+bool CaloAxis::BuildAxis(EventState &ev, const CaloHits &calohits){
+  CaloMoments moments;
+  AccumulateMoments(calohits, moments);
+  ev.caloaxisinfos.emplace_back();
+  return ComputeAxis(moments, ev.caloaxisinfos.back());
+}
 
+void CaloAxis::AccumulateMoments(const CaloHits &calohits, CaloMoments &moments){
 
-  //Loop on hits, select hits with edep>threshold and create a vector containing coordinates [0,1,2] and weigths [3]
-  //x[0]: Coo::X
-  //x[1]: Coo::Y
-  //x[2]: Coo::Z
-  //x[3]: Hit::EDep
-  int n=0;
-  double sumw=0; 
+  //Loop on hits, select hits with edep>threshold and accumulate the energy-weighted moments of their positions
+  moments.Reset();
   for (auto &hit : calohits) {
-    
     if(hit.EDep() > edepthreshold){
-      //std::array<double,4> x_i;
-      Point pos = caloGeoParams->Position(hit.VolumeID());
-      //x_i[0] = (pos[RefFrame::Coo::X]);
-      //x_i[1] = (pos[RefFrame::Coo::Y]);
-      //x_i[2] = (pos[RefFrame::Coo::Z]);
-      //x_i[3] = (hit.EDep());
-      hhitedep->Fill( log10(hit.EDep()));
-
-      //x.push_back(x_i);
-      x.push_back(std::array<double,4>{pos[RefFrame::Coo::X],pos[RefFrame::Coo::Y],pos[RefFrame::Coo::Z],hit.EDep()});
-      sumw += hit.EDep();
-      n++;
-    }
-  }  
-  //Here we assume that calo hits are uncorrelated, so the covariance matrix is diagonal
-
-  //Calculate the centroid of the energy deposit
-  std::array<double,3> cog = {0,0,0}; 
-  for(int i=0; i<n; i++) { for(int j=0; j<3; j++) { cog[j] += (1/sumw) * x[i][3] * x[i][j]; } }// printf("%f %f\n", x[i][j], cog[j]);} 
-    
-  //Reposition the hit point to the energy centroid
-  for(int i=0; i<n; i++) { for(int j=0; j<3; j++) x[i][j] -= cog[j]; } 
-
- /*for(int i=0; i<n; i=i+10){
-    printf("-- [%d][%d]  %f\n",i,0,X[i][0]);
-    printf("-- [%d][%d]  %f\n",i,1,X[i][1]);
-    printf("-- [%d][%d]  %f\n",i,2,X[i][2]);
-    }
-  printf("\n");
-*/
-  
-  /*
-  TMatrixD X(n,3);    //Data matrix (with respect to centroid)
-  for(int i=0; i<n; i++){ for(int j=0; j<3; j++){ X[i][j] = x[i][j]; }}
-  TMatrixD Xt(3,n);   //Data matrix transp3osed (with respect to centroid)
-  for(int j=0; j<3; j++){ for(int i=0; i<n; i++){ Xt[j][i] = x[i][j]; }}
-  TMatrixD XtX(Xt,TMatrixD::kMult,X);  //Xt * X
-  */
-
-/*printf("%f %f\n", Xt[0][1],  X[1][0]);
-printf("%f %f\n", Xt[1][20], X[20][1]);
-printf("%f %f\n", Xt[2][40], X[40][2]);
-*/
- 
-/* for(int i=0; i<3; i++){
-    printf("-- %f %f %f\n",XtX[i][0],XtX[i][1],XtX[i][2]);
+      const Point &pos = _caloGeoParams->Position(hit.VolumeID());
+      hhitedep.Fill(hit.EDep());
+      moments.Add(pos[RefFrame::Coo::X], pos[RefFrame::Coo::Y], pos[RefFrame::Coo::Z], hit.EDep());
     }
+  }
+}
 
-  printf("\n");
-*/
-  //Calculate the covariance matrix as   C_i,j = (1/(sumw-1)) * sum_k [ (w_k) Xt_i,k * X_k,j ]
-  //https://en.wikipedia.org/wiki/Sample_mean_and_covariance#Weighted_samples
- // https://en.wikipedia.org/wiki/Weighted_least_squares
- 
- /* TMatrixDSym C(3);
-  for(int i=0; i<3; i++){
-    for(int j=0; j<3; j++){
-      C[i][j] = 0; for(int k=0; k<n; k++) C[i][j] += (1/(sumw)) * x[k][3] * XtX[i][j];
-    }
-  }*/
+bool CaloAxis::ComputeAxis(const CaloMoments &moments, CaloAxisInfo &caloaxisinfo){
 
+  //Calculate the covariance matrix as   C_i,j = (1/sumw) * sum_k [ w_k (x_k,i - cog_i) (x_k,j - cog_j) ]
+  //https://en.wikipedia.org/wiki/Sample_mean_and_covariance#Weighted_samples
+  //Here we assume that calo hits are uncorrelated
   TMatrixDSym C(3);
   for(int i=0; i<3; i++){
     for(int j=0; j<3; j++){
-      C[i][j] = 0; for(int k=0; k<n; k++) C[i][j] += (1/(sumw)) * x[k][3] * x[k][i] * x[k][j];
+      C[i][j] = moments.Cov(i,j);
     }
   }
-/*
-  for(int i=0; i<3; i++){
-    printf("%f\t%f\t%f\n",C[i][0],C[i][1],C[i][2]);
-    }
-  printf("\n");
-  */
 
   //Get eigenvalues of the covariance matrix
   TMatrixDSymEigen E(C);
-  TVectorD eigvaluesvec = E.GetEigenValues();
-  TMatrixD eigvecmatrix = E.GetEigenVectors();
-
-  //for(int i=0; i<3; i++) printf("[%d] %f\t {%f,%f,%f}\n", i, eigvaluesvec[i], eigvecmatrix[i][0], eigvecmatrix[i][1], eigvecmatrix[i][2]);
-  //printf("\n");
-  //Sort Eigenvector by decreasing eigenvalues
-  TVectorD eigvec0( TVectorD(TMatrixTColumn_const<double>(eigvecmatrix, 0) ) ); //could be done more elegantly....
-  TVectorD eigvec1( TVectorD(TMatrixTColumn_const<double>(eigvecmatrix, 1) ) );
-  TVectorD eigvec2( TVectorD(TMatrixTColumn_const<double>(eigvecmatrix, 2) ) );
-  double eigval[3];   for(int i=0; i<3; i++){ eigval[i] = eigvaluesvec[i]; }
-  std::vector<std::pair<double,TVectorD>> eigvec = { {eigval[0],eigvec0}, {eigval[1],eigvec1}, {eigval[2],eigvec2} };
-  std::sort(eigvec.begin(),eigvec.end(), []( const std::pair<double,TVectorD>x, std::pair<double,TVectorD>y) {return x.first>y.first;});
-
- /*  
-  if( eigval[0]<1e-10){
-    printf("n::%d\n",n);
-    C.Print();
-  }
-  */
+  const TVectorD &eigvaluesvec = E.GetEigenValues();
+  const TMatrixD &eigvecmatrix = E.GetEigenVectors();
+
+  //Sort Eigenvector by decreasing eigenvalues (eigenvectors are the columns of eigvecmatrix)
+  int order[3] = {0,1,2};
+  std::sort(order, order+3, [&eigvaluesvec](int a, int b) {return eigvaluesvec[a]>eigvaluesvec[b];});
 
   //Store values to containers
-  caloaxisinfo.ShowerHits = (unsigned int)n;
+  caloaxisinfo.ShowerHits = (unsigned int)moments.n;
 
-  caloaxisinfo.ShowerCOG[RefFrame::Coo::X] = cog[0];
-  caloaxisinfo.ShowerCOG[RefFrame::Coo::Y] = cog[1];
-  caloaxisinfo.ShowerCOG[RefFrame::Coo::Z] = cog[2];
+  caloaxisinfo.ShowerCOG[RefFrame::Coo::X] = moments.Cog(0);
+  caloaxisinfo.ShowerCOG[RefFrame::Coo::Y] = moments.Cog(1);
+  caloaxisinfo.ShowerCOG[RefFrame::Coo::Z] = moments.Cog(2);
 
-  double mag=0; for(int i=0; i<3; i++) mag+= pow(eigvec.at(0).second[i],2); mag=sqrt(mag); 
-  caloaxisinfo.ShowerDir[RefFrame::Coo::X] = eigvec.at(0).second[0]/mag;
-  caloaxisinfo.ShowerDir[RefFrame::Coo::Y] = eigvec.at(0).second[1]/mag;
-  caloaxisinfo.ShowerDir[RefFrame::Coo::Z] = eigvec.at(0).second[2]/mag;
+  double mag=0; for(int i=0; i<3; i++) mag+= pow(eigvecmatrix(i,order[0]),2); mag=sqrt(mag); 
+  caloaxisinfo.ShowerDir[RefFrame::Coo::X] = eigvecmatrix(0,order[0])/mag;
+  caloaxisinfo.ShowerDir[RefFrame::Coo::Y] = eigvecmatrix(1,order[0])/mag;
+  caloaxisinfo.ShowerDir[RefFrame::Coo::Z] = eigvecmatrix(2,order[0])/mag;
 
-  for(int i=0; i<3; i++) caloaxisinfo.ShowerEigenvalues.push_back( eigvec.at(i).first );
-  for(int i=0; i<3; i++) { 
-    Vec3D v(eigvec.at(i).second[0],eigvec.at(i).second[1],eigvec.at(i).second[2]);
-    caloaxisinfo.ShowerEigenvectors.push_back(v); }
-  
-  caloaxisinfos.push_back(std::move(caloaxisinfo));
-  x.clear();
+  for(int i=0; i<3; i++) caloaxisinfo.ShowerEigenvalues[i] = eigvaluesvec[order[i]];
+  for(int i=0; i<3; i++) caloaxisinfo.ShowerEigenvectors[i] = Vec3D(eigvecmatrix(0,order[i]),eigvecmatrix(1,order[i]),eigvecmatrix(2,order[i]));
 
   return true;
 }
 
 
+void CaloAxis::ScanThresholds(EventState &ev, CaloAxisStore &processstore, const CaloHits &calohits){
+
+  //Sort the hits once by decreasing energy: the hits above any threshold are then a prefix of the list, and the
+  //moments for a threshold are the cumulative moments of that prefix. Thresholds are visited in decreasing order,
+  //so a single sweep over the sorted hits gives the moments for all of them.
+  const double minthreshold = scanthresholds[scanorder.back()];
+  ev.scanhits = ev.arena.Allocate<std::array<float,4>>(calohits.size());
+  size_t nscanhits=0;
+  for (auto &hit : calohits) {
+    if(hit.EDep() > minthreshold){
+      const Point &pos = _caloGeoParams->Position(hit.VolumeID());
+      ev.scanhits[nscanhits++] = std::array<float,4>{hit.EDep(), (float)pos[RefFrame::Coo::X], (float)pos[RefFrame::Coo::Y], (float)pos[RefFrame::Coo::Z]};
+    }
+  }
+  std::sort(ev.scanhits, ev.scanhits+nscanhits, [](const std::array<float,4> &a, const std::array<float,4> &b){ return a[0] > b[0]; });
+
+  CaloMoments cumulative;
+  size_t ihit=0;
+  processstore.caloaxisscannthr = scanthresholds.size();
+  for(int ithr : scanorder){
+    while( ihit<nscanhits && ev.scanhits[ihit][0] > scanthresholds[ithr] ){
+      cumulative.Add(ev.scanhits[ihit][1], ev.scanhits[ihit][2], ev.scanhits[ihit][3], ev.scanhits[ihit][0]);
+      ihit++;
+    }
+
+    processstore.caloaxisscanthr[ithr] = scanthresholds[ithr];
+    processstore.caloaxisscanhits[ithr] = cumulative.n;
+    for(int i=0; i<3; i++){
+      processstore.caloaxisscancog[ithr][i] = -999.;
+      processstore.caloaxisscandir[ithr][i] = -999.;
+      processstore.caloaxisscaneigval[ithr][i] = -999.;
+    }
+    if( cumulative.n==0 ) continue;
+
+    ev.scanaxisinfo.Reset();
+    ComputeAxis(cumulative, ev.scanaxisinfo);
+    processstore.caloaxisscancog[ithr][0] = (float)ev.scanaxisinfo.ShowerCOG[RefFrame::Coo::X];
+    processstore.caloaxisscancog[ithr][1] = (float)ev.scanaxisinfo.ShowerCOG[RefFrame::Coo::Y];
+    processstore.caloaxisscancog[ithr][2] = (float)ev.scanaxisinfo.ShowerCOG[RefFrame::Coo::Z];
+    processstore.caloaxisscandir[ithr][0] = (float)ev.scanaxisinfo.ShowerDir[RefFrame::Coo::X];
+    processstore.caloaxisscandir[ithr][1] = (float)ev.scanaxisinfo.ShowerDir[RefFrame::Coo::Y];
+    processstore.caloaxisscandir[ithr][2] = (float)ev.scanaxisinfo.ShowerDir[RefFrame::Coo::Z];
+    for(int i=0; i<3; i++) processstore.caloaxisscaneigval[ithr][i] = (float)ev.scanaxisinfo.ShowerEigenvalues[i];
+  }
+}
+
+
 bool CaloAxis::Finalize() {
   const std::string routineName("CaloAxis::Finalize");
 
   auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
   if (!globStore) {COUT(ERROR) << "Global data store not found." << ENDL; return false;}
 
-  globStore->AddObject(hhitedep->GetName(), hhitedep);
+  auto hhitedepROOT = hhitedep.ToROOT<TH1F>("hhitedep", "Hit.Edep()");
+  globStore->AddObject(hhitedepROOT->GetName(), hhitedepROOT);
+  _timer.Publish(*globStore, GetName());
   return true;
 }
 
+void CaloAxis::EventState::Clear(){
+  arena.Reset();
+  clustermoments = nullptr;
+  nclustermoments = 0;
+  clusterparent = nullptr;
+  clusterorder = nullptr;
+  chunkmoments = nullptr;
+  scanhits = nullptr;
+  caloaxisinfos.clear();
+  parallel = false;
+}
+
 //***************************
 
 CaloAxisStore::CaloAxisStore(const std::string &name) :
@@ -261,7 +416,7 @@ CaloAxisStore::CaloAxisStore(const std::string &name) :
 }
 
   bool CaloAxisStore::Process() {
-  const std::string routineName("CaloAxisStore::Process");
+  static const std::string routineName("CaloAxisStore::Process");
   return true;
 }
   bool CaloAxisStore::Finalize() {
@@ -269,8 +424,6 @@ CaloAxisStore::CaloAxisStore(const std::string &name) :
   return true;
 }
 bool CaloAxisStore::Reset() {
-  const std::string routineName("CaloAxisStore::Finalize");
-
   caloaxishits=0;
   for(int i=0; i<3; i++){
     caloaxiscog[i] = -999.;
@@ -283,6 +436,17 @@ bool CaloAxisStore::Reset() {
       }
     }
 
+  caloaxisscannthr=0;
+  for(int ithr=0; ithr<maxscanthresholds; ithr++){
+    caloaxisscanthr[ithr] = -999.;
+    caloaxisscanhits[ithr] = 0;
+    for(int i=0; i<3; i++){
+      caloaxisscancog[ithr][i] = -999.;
+      caloaxisscandir[ithr][i] = -999.;
+      caloaxisscaneigval[ithr][i] = -999.;
+    }
+  }
+
   return true;
 }
 
@@ -7,20 +7,31 @@
 #include "dataobjects/CaloClusters.h"
 #include "dataobjects/CaloHits.h"
 #include "CaloAxisInfo.h"
+#include "CaloMoments.h"
+#include "CaloClusterIDs.h"
+#include "Utils/EventArena.h"
+#include "Utils/StorePool.h"
+#include "Histo/ShardedHisto.h"
+#include "Core/ProcessTimer.h"
 #include "dataobjects/CaloGeoParams.h"
 
 //ROOT headers
 #include "TH1F.h"
 
+// C/C++ standard headers
+#include <array>
+
 using namespace EA;
 
 namespace Herd{
 
 class CaloAxisStore;
+class WorkStealingPool;
 
 class CaloAxis : public Algorithm {
 public:
   CaloAxis(const std::string &name);
+  ~CaloAxis();
 
   bool Initialize();
 
@@ -38,21 +49,64 @@ public:
 private:
   bool filterenable;
   bool process_clusters;
+  bool libclusters;     // Use the in-library clusters (caloClusterIDs from CaloClustering) instead of caloClusters
   bool DummyCaloCluster();
-  bool BuildAxis(CaloHits);
-  bool BuildAxis(CaloClusters);
+
+  //Per-event state: the axes and the scratch buffers, allocated from an arena which is reset at the beginning of
+  //each event. It is passed explicitly to the processing methods, which keep nothing else per event. CaloAxis is not
+  //an AcceptanceKernel and is not re-entrant: EA calls Process serially and every event reuses the one _eventstate
+  //(and _pool), so the arena and the capacity of the vectors are kept warm across events.
+  struct EventState {
+    EventArena arena;
+    CaloMoments *clustermoments = nullptr;
+    int nclustermoments = 0;
+    int *clusterparent = nullptr;
+    int *clusterorder = nullptr;
+    CaloMoments *chunkmoments = nullptr;
+    std::array<float,4> *scanhits = nullptr;   // Edep, X, Y, Z of the hits above the lowest scan threshold
+    std::vector<CaloAxisInfo> caloaxisinfos;   // Capacity is kept across events, elements own no heap memory
+    CaloAxisInfo scanaxisinfo;
+    bool parallel = false;
+    void Clear();
+  };
+
+  bool BuildAxis(EventState &, const CaloHits &);
+  bool BuildAxis(EventState &, const CaloClusters &);
+  bool BuildAxis(EventState &, const CaloClusterIDs &);
+  bool BuildClusterAxes(EventState &);
+  bool ComputeAxis(const CaloMoments &, CaloAxisInfo &);
+  void AccumulateMoments(const CaloHits &, CaloMoments &);
+  void MergeClusters(EventState &);
+  bool UseParallel(unsigned int nclusters, unsigned int nhits) const;
+  void ScanThresholds(EventState &, CaloAxisStore &, const CaloHits &);
 
   float edepthreshold;
+  int topk;             // Number of most energetic clusters to build the axis for (<=0: all clusters, input order)
+  float mergedistance;  // Clusters with COGs closer than this (cm) are merged before ranking (<=0: no merging)
+  int nthreads;            // Threads for intra-event parallelism (1: serial)
+  int parallelminclusters; // Events with at least this many clusters...
+  int parallelminhits;     // ...or this many hits are processed in parallel
+  std::vector<double> scanthresholds; // Edep thresholds for the axis-vs-threshold scan (empty: no scan)
 
-  //Store pointer
-  std::shared_ptr<CaloAxisStore> _processstore;
   CaloHits calohits;
-  std::vector<CaloAxisInfo> caloaxisinfos;
-  std::shared_ptr<TH1F> hhitedep;
+  //Hit energy, uniform in log10(Edep) and sharded per thread (also filled from the pool tasks)
+  typedef Histogram<Int64Storage, Log10Axis> HitEDepHisto;
+  ShardedHistogram<HitEDepHisto> hhitedep;
+
+  static const unsigned int chunkhits = 1024;
+  std::vector<int> scanorder;                // Scan thresholds indexes by decreasing threshold
+
+  EventState _eventstate;
+
+  std::unique_ptr<WorkStealingPool> _pool;
 
   // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  StorePool<CaloAxisStore> _processstores; // A store of its own for every event, without allocating
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
   observer_ptr<GlobalDataStore> _globStore; // Pointer to the event data store
+  observer_ptr<CaloGeoParams> _caloGeoParams; // Calo geometry, retrieved once at initialization
 };
 
 class CaloAxisStore : public Algorithm {
@@ -72,6 +126,15 @@ public:
   float caloaxisdir[3];
   float caloaxiseigval[3];
   float caloaxiseigvec[3][3];
+
+  //Axis-vs-threshold scan, one entry per threshold in the order given by the scanthresholds parameter
+  static const int maxscanthresholds = 16;
+  unsigned short caloaxisscannthr;
+  float caloaxisscanthr[maxscanthresholds];
+  unsigned short caloaxisscanhits[maxscanthresholds];
+  float caloaxisscancog[maxscanthresholds][3];
+  float caloaxisscandir[maxscanthresholds][3];
+  float caloaxisscaneigval[maxscanthresholds][3];
 private:
   // Algorithm parameters
   // Created global objects
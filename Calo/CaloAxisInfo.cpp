@@ -14,8 +14,8 @@ void CaloAxisInfo::Reset() {
   ShowerHits = 0;
   ShowerCOG = Point();        
   ShowerDir = Point();            
-  ShowerEigenvalues.clear();  
-  ShowerEigenvectors.clear(); 
+  ShowerEigenvalues.fill(0);
+  ShowerEigenvectors.fill(Vec3D());
 
 }
     
@@ -15,6 +15,7 @@
 #include "dataobjects/Point.h"
 
 // C/C++ standard headers
+#include <array>
 #include <numeric>
 #include <vector>
 
@@ -29,8 +30,8 @@ struct CaloAxisInfo {
   unsigned short ShowerHits;                           ///Number of hits used for shower axis reconstruction
   Point ShowerCOG;                          ///Shower Center of Gravity
   Point ShowerDir;                          ///Shower axis Directions
-  std::vector<double> ShowerEigenvalues;    ///Eigenvalues of Shower Covariance matrix
-  std::vector<Vec3D> ShowerEigenvectors;    ///Eignevectors of Shower Covariance matrix
+  std::array<double,3> ShowerEigenvalues;   ///Eigenvalues of Shower Covariance matrix, in decreasing order
+  std::array<Vec3D,3> ShowerEigenvectors;   ///Eignevectors of Shower Covariance matrix
 
   /*! @brief Default constructor.
    *
@@ -0,0 +1,25 @@
+/*! @file CaloClusterIDs.cpp CaloClusterIDs struct implementation. */
+
+#include "CaloClusterIDs.h"
+
+namespace Herd {
+
+void CaloClusterIDs::Reserve(unsigned int nhits) {
+
+  hitVolumeID.reserve(nhits);
+  hitEDep.reserve(nhits);
+  hitCluster.reserve(nhits);
+  clusterEDep.reserve(nhits);
+  clusterNHits.reserve(nhits);
+}
+
+void CaloClusterIDs::Reset() {
+
+  hitVolumeID.clear();
+  hitEDep.clear();
+  hitCluster.clear();
+  clusterEDep.clear();
+  clusterNHits.clear();
+}
+
+} // namespace Herd
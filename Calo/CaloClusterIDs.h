@@ -0,0 +1,41 @@
+/*! @file CaloClusterIDs.h CaloClusterIDs struct declaration. */
+
+#ifndef HERD_CALOCLUSTERIDS_H_
+#define HERD_CALOCLUSTERIDS_H_
+
+// C/C++ standard headers
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Calo clusters in structure-of-arrays form.
+ * @struct CaloClusterIDs CaloClusterIDs.h
+ *
+ * Per-hit arrays hold the hits above threshold and the ID of the cluster each one belongs to; per-cluster arrays are
+ * indexed by cluster ID. Cluster IDs are assigned in order of the first hit of each cluster in the input collection.
+ * The vectors are cleared but never shrunk, so after the first events no allocation takes place.
+ */
+struct CaloClusterIDs {
+
+  std::vector<unsigned int> hitVolumeID; ///Cube ID of each hit
+  std::vector<float> hitEDep;            ///Energy deposit of each hit
+  std::vector<int> hitCluster;           ///Cluster ID of each hit
+
+  std::vector<float> clusterEDep;          ///Total energy deposit of each cluster
+  std::vector<unsigned int> clusterNHits;  ///Number of hits of each cluster
+
+  CaloClusterIDs() { Reset(); };
+
+  unsigned int NHits() const { return hitVolumeID.size(); }
+  unsigned int NClusters() const { return clusterEDep.size(); }
+
+  /*! @brief Reserve space for the given maximum number of hits. */
+  void Reserve(unsigned int nhits);
+
+  /*! @brief Remove all the hits and clusters, keeping the allocated memory. */
+  void Reset();
+};
+
+} // namespace Herd
+
+#endif /* HERD_CALOCLUSTERIDS_H_ */
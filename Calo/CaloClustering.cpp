@@ -0,0 +1,120 @@
+// Example headers
+#include "CaloClustering.h"
+#include "dataobjects/CaloGeoParams.h"
+
+// C/C++ standard headers
+#include <numeric>
+
+namespace Herd{
+RegisterAlgorithm(CaloClustering);
+
+
+CaloClustering::CaloClustering(const std::string &name) :
+  Algorithm{name},
+  edepthreshold{0},
+  hitsobject{"caloHitsMC"},
+  perfcounters{false}
+   {
+    DefineParameter("edepthreshold", edepthreshold);
+    DefineParameter("hitsobject",    hitsobject);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+bool CaloClustering::Initialize() {
+  const std::string routineName("CaloClustering::Initialize");
+
+  _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore"); if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  auto caloGeoParams = globStore->GetObject<CaloGeoParams>("caloGeoParams"); if (!caloGeoParams) { COUT(ERROR) << "caloGeoParams not found." << ENDL; return false; }
+
+  if( !_lattice.Build(*caloGeoParams) ) { COUT(ERROR) << "Calo cubes cannot be mapped on a regular lattice." << ENDL; return false; }
+
+  const unsigned int ncubes = _lattice.NCubes();
+  _cubehit.assign(ncubes, -1);
+  _parent.reserve(ncubes);
+  _rootlabel.reserve(ncubes);
+
+  _clusterids.Init([ncubes]() {
+    auto clusterids = std::make_shared<CaloClusterIDs>();
+    clusterids->Reserve(ncubes);
+    return clusterids;
+  });
+
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+  return true;
+}
+
+int CaloClustering::FindRoot(int hit) {
+  // Path halving
+  while( _parent[hit]!=hit ){ _parent[hit] = _parent[_parent[hit]]; hit = _parent[hit]; }
+  return hit;
+}
+
+bool CaloClustering::Process() {
+  static const std::string routineName("CaloClustering::Process");
+  ProcessScope timing(_timer);
+
+  auto clusterids = _clusterids.Acquire();
+  _evStore->AddObject("caloClusterIDs", clusterids);
+
+  auto caloHits = _evStore->GetObject<CaloHits>(hitsobject);
+  if (!caloHits) { COUT(DEBUG) << hitsobject << " not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+
+  //Select the hits and map each cube to its hit
+  auto &volumeid = clusterids->hitVolumeID;
+  for (auto &hit : *caloHits) {
+    if( hit.EDep() > edepthreshold && hit.VolumeID() < _lattice.NCubes() ){
+      int &cubehit = _cubehit[hit.VolumeID()];
+      if( cubehit>=0 ){ clusterids->hitEDep[cubehit] += hit.EDep(); continue; } // several hits in the same cube
+      cubehit = (int)volumeid.size();
+      volumeid.push_back(hit.VolumeID());
+      clusterids->hitEDep.push_back(hit.EDep());
+    }
+  }
+  const int nhits = (int)volumeid.size();
+
+  //Union of each hit with its already visited neighbours; the smaller index becomes the root
+  _parent.resize(nhits);
+  for(int ihit=0; ihit<nhits; ihit++){
+    _parent[ihit] = ihit;
+    const unsigned int *neighbours = _lattice.Neighbours(volumeid[ihit]);
+    for(int in=0; in<_lattice.NNeighbours(volumeid[ihit]); in++){
+      int jhit = _cubehit[neighbours[in]];
+      if( jhit<0 || jhit>=ihit ) continue;
+      int ri = FindRoot(ihit), rj = FindRoot(jhit);
+      if( ri<rj ) _parent[rj] = ri; else if( rj<ri ) _parent[ri] = rj;
+    }
+  }
+
+  //Label the clusters in order of their first hit and accumulate their energy
+  _rootlabel.resize(nhits);
+  clusterids->hitCluster.resize(nhits);
+  for(int ihit=0; ihit<nhits; ihit++){
+    int root = FindRoot(ihit);
+    if( root==ihit ){
+      _rootlabel[ihit] = (int)clusterids->clusterEDep.size();
+      clusterids->clusterEDep.push_back(0);
+      clusterids->clusterNHits.push_back(0);
+    }
+    int icluster = _rootlabel[root];
+    clusterids->hitCluster[ihit] = icluster;
+    clusterids->clusterEDep[icluster] += clusterids->hitEDep[ihit];
+    clusterids->clusterNHits[icluster]++;
+  }
+
+  //Clear the cube map for the next event, touching only the cubes used in this one
+  for(int ihit=0; ihit<nhits; ihit++) _cubehit[volumeid[ihit]] = -1;
+
+  return true;
+}
+
+bool CaloClustering::Finalize() {
+  const std::string routineName("CaloClustering::Finalize");
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+} //namespace Herd
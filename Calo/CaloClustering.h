@@ -0,0 +1,70 @@
+#ifndef CALOCLUSTERING_H_
+#define CALOCLUSTERING_H_
+
+#include "algorithm/Algorithm.h"
+
+// HerdSoftware headers
+#include "dataobjects/CaloHits.h"
+#include "CaloClusterIDs.h"
+#include "CaloLattice.h"
+#include "Core/ProcessTimer.h"
+#include "Utils/StorePool.h"
+
+using namespace EA;
+
+namespace Herd{
+
+/*! @brief Connected-component clustering of Calo hits on the cube lattice.
+ * @class CaloClustering CaloClustering.h
+ *
+ * Hits above edepthreshold are grouped into clusters of touching cubes (faces, edges and corners) with a union-find
+ * over the neighbour table of the CaloLattice, which is built once at initialization. The cost is linear in the
+ * number of hits and the output buffers are reused, so no allocation takes place in the event loop.
+ *
+ * <B>Needed event objects:</B>
+ *
+ *   name          |     type          |  store      | optional       | description
+ * ----------------|-------------------|-------------|----------------|-------------------------
+ * caloHitsMC      |    CaloHits       | evStore     |    no          | Calo hits (name set by hitsobject)
+ *
+ * <B>Produced event objects:</B>
+ *
+ *   name                       | type             |   store   | description
+ * -----------------------------|------------------|-----------|----------------------------------------
+ * caloClusterIDs               | CaloClusterIDs   | evStore   | Hits above threshold with their cluster ID
+ *
+ */
+class CaloClustering : public Algorithm {
+public:
+  CaloClustering(const std::string &name);
+
+  bool Initialize();
+
+  bool Process();
+
+  bool Finalize();
+
+private:
+  // Algorithm parameters
+  float edepthreshold;
+  std::string hitsobject;
+
+  int FindRoot(int hit);
+
+  CaloLattice _lattice;
+  StorePool<CaloClusterIDs> _clusterids; // A caloClusterIDs of its own for every event, without allocating
+
+  // Union-find scratch, sized once at initialization
+  std::vector<int> _cubehit;   // Hit index of each cube in the current event, -1 if none
+  std::vector<int> _parent;    // Union-find parent of each hit
+  std::vector<int> _rootlabel; // Cluster ID assigned to each root hit
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+} //namespace Herd
+
+#endif /* CALOCLUSTERING_H_ */
@@ -4,6 +4,7 @@
 #include "dataobjects/CaloClusters.h"
 #include "dataobjects/CaloGeoParams.h"
 #include "dataobjects/MCTruth.h"
+#include "CaloClusterIDs.h"
 
 // Root headers
 
@@ -18,10 +19,12 @@ RegisterAlgorithm(CaloGlobStore);
 CaloGlob::CaloGlob(const std::string &name) :
   Algorithm{name},
   filterenable{true},
-  calohitscutmc{false}
+  calohitscutmc{false},
+  perfcounters{false}
    {
     DefineParameter("filterenable",  filterenable); 
     DefineParameter("calohitscutmc", calohitscutmc);
+    DefineParameter("perfcounters", perfcounters);
   }
 
 bool CaloGlob::Initialize() {
@@ -29,21 +32,22 @@ bool CaloGlob::Initialize() {
 
   _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
 
-  _processstore = std::make_shared<CaloGlobStore>("caloGlobStore");
-  
   // Setup the filter                                                                                                                                                                                                                       
   if (filterenable) SetFilterStatus(FilterStatus::ENABLED); else SetFilterStatus(FilterStatus::DISABLED);
 
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+  _processstores.Init("caloGlobStore");
+
   return true;
 }
 
 bool CaloGlob::Process() {
-  const std::string routineName("CaloGlob::Process");
+  static const std::string routineName("CaloGlob::Process");
+  Herd::ProcessScope timing(_timer);
 
   //Add the ProcessStore object for this event to the event data store
-  //_processstore->Reset();
-  _processstore->Reset();
-  _evStore->AddObject("caloGlobStore",_processstore);
+  auto processstore = _processstores.Acquire();
+  _evStore->AddObject("caloGlobStore",processstore);
 
   //Set Filter Status
   SetFilterResult(FilterResult::ACCEPT);
@@ -61,11 +65,13 @@ bool CaloGlob::Process() {
 
 
   float calototedep = std::accumulate(caloHits->begin(), caloHits->end(), 0.,[](float sum, const Herd::Hit &hit) { return sum + hit.EDep(); });
-  int calonhits =     std::accumulate(caloHits->begin(), caloHits->end(), 0.,[](int n, const Herd::Hit &hit) { if( hit.EDep()>0) return n+1; });
-  _processstore->calonhits = calonhits;
-  _processstore->calototedep = calototedep;
+  int calonhits =     std::accumulate(caloHits->begin(), caloHits->end(), 0.,[](int n, const Herd::Hit &hit) { return hit.EDep()>0 ? n+1 : n; });
+  processstore->calonhits = calonhits;
+  processstore->calototedep = calototedep;
   //COUT(INFO)<<caloClusters->size()<<ENDL;
-  //if( caloClusters ) _processstore->calonclusters = (int)caloClusters->size();
+  //if( caloClusters ) processstore->calonclusters = (int)caloClusters->size();
+  auto caloClusterIDs = _evStore->GetObject<Herd::CaloClusterIDs>("caloClusterIDs");
+  if( caloClusterIDs ) processstore->calonclusters = (int)caloClusterIDs->NClusters();
 
   if(calohitscutmc){
     auto mcTruth = _evStore->GetObject<Herd::MCTruth>("mcTruth");
@@ -83,6 +89,7 @@ bool CaloGlob::Finalize() {
   auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
   if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
 
+  _timer.Publish(*globStore, GetName());
   return true;
 }
 
@@ -100,7 +107,7 @@ CaloGlobStore::CaloGlobStore(const std::string &name) :
 }
 
   bool CaloGlobStore::Process() {
-  const std::string routineName("CaloGlobStore::Process");
+  static const std::string routineName("CaloGlobStore::Process");
   return true;
 }
   bool CaloGlobStore::Finalize() {
@@ -108,8 +115,6 @@ CaloGlobStore::CaloGlobStore(const std::string &name) :
   return true;
 }
 bool CaloGlobStore::Reset() {
-  const std::string routineName("CaloGlobStore::Finalize");
-
   calonhits=0;
   calototedep=0;
   calonclusters=0;
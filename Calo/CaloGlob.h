@@ -3,6 +3,9 @@
 
 #include "algorithm/Algorithm.h"
 
+#include "Core/ProcessTimer.h"
+#include "Utils/StorePool.h"
+
 // HerdSoftware headers
 
 using namespace EA;
@@ -24,11 +27,10 @@ private:
   bool calohitscutmc;
 
 
-  //Store pointer
-  std::shared_ptr<CaloGlobStore> _processstore;
-  
-
   // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  Herd::StorePool<CaloGlobStore> _processstores; // A store of its own for every event, without allocating
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
 
 };
@@ -0,0 +1,78 @@
+/*! @file CaloLattice.cpp CaloLattice class implementation. */
+
+#include "CaloLattice.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+
+namespace Herd {
+
+CaloLattice::CaloLattice() : _ncubes{0}, _cubesize{0}, _pitch{0, 0, 0} {}
+
+bool CaloLattice::Build(const CaloGeoParams &caloGeoParams) {
+
+  _ncubes = caloGeoParams.NCubes();
+  _cubesize = caloGeoParams.CubeSize();
+  if (_ncubes == 0 || _cubesize <= 0) return false;
+
+  _x.resize(_ncubes);
+  _y.resize(_ncubes);
+  _z.resize(_ncubes);
+  for (unsigned int icube = 0; icube < _ncubes; icube++) {
+    const Point &pos = caloGeoParams.Position(icube);
+    _x[icube] = pos[RefFrame::Coo::X];
+    _y[icube] = pos[RefFrame::Coo::Y];
+    _z[icube] = pos[RefFrame::Coo::Z];
+  }
+
+  // Lattice pitch along each axis: smallest spacing between distinct cube coordinates (cube size plus gaps)
+  const std::vector<float> *coo[3] = {&_x, &_y, &_z};
+  float cmin[3];
+  int nsites[3];
+  for (int k = 0; k < 3; k++) {
+    std::vector<float> values(*coo[k]);
+    std::sort(values.begin(), values.end());
+    _pitch[k] = 0;
+    for (size_t i = 1; i < values.size(); i++) {
+      float diff = values[i] - values[i - 1];
+      if (diff > 0.5 * _cubesize && (_pitch[k] == 0 || diff < _pitch[k])) _pitch[k] = diff;
+    }
+    if (_pitch[k] == 0) _pitch[k] = _cubesize; // a single layer along this axis
+    cmin[k] = values.front();
+    nsites[k] = (int)std::lround((values.back() - cmin[k]) / _pitch[k]) + 1;
+  }
+
+  // Dense map from lattice site to cube ID
+  std::vector<int> site((size_t)nsites[0] * nsites[1] * nsites[2], -1);
+  std::vector<int> ix(_ncubes), iy(_ncubes), iz(_ncubes);
+  for (unsigned int icube = 0; icube < _ncubes; icube++) {
+    ix[icube] = (int)std::lround((_x[icube] - cmin[0]) / _pitch[0]);
+    iy[icube] = (int)std::lround((_y[icube] - cmin[1]) / _pitch[1]);
+    iz[icube] = (int)std::lround((_z[icube] - cmin[2]) / _pitch[2]);
+    int &s = site[((size_t)iz[icube] * nsites[1] + iy[icube]) * nsites[0] + ix[icube]];
+    if (s >= 0) return false; // two cubes on the same site: not a lattice
+    s = icube;
+  }
+
+  _nneighbours.assign(_ncubes, 0);
+  _neighbours.assign((size_t)_ncubes * MaxNeighbours, 0);
+  for (unsigned int icube = 0; icube < _ncubes; icube++) {
+    unsigned int *row = &_neighbours[(size_t)icube * MaxNeighbours];
+    for (int dz = -1; dz <= 1; dz++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if (dx == 0 && dy == 0 && dz == 0) continue;
+          int jx = ix[icube] + dx, jy = iy[icube] + dy, jz = iz[icube] + dz;
+          if (jx < 0 || jy < 0 || jz < 0 || jx >= nsites[0] || jy >= nsites[1] || jz >= nsites[2]) continue;
+          int jcube = site[((size_t)jz * nsites[1] + jy) * nsites[0] + jx];
+          if (jcube >= 0) row[_nneighbours[icube]++] = (unsigned int)jcube;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,59 @@
+/*! @file CaloLattice.h CaloLattice class declaration. */
+
+#ifndef HERD_CALOLATTICE_H_
+#define HERD_CALOLATTICE_H_
+
+// HerdSoftware headers
+#include "dataobjects/CaloGeoParams.h"
+
+// C/C++ standard headers
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Flat view of the Calo cube lattice with a precomputed neighbour table.
+ * @class CaloLattice CaloLattice.h
+ *
+ * Cube positions are stored as structure of arrays indexed by the cube (volume) ID. For each cube the IDs of the
+ * (up to 26) cubes touching it by a face, an edge or a corner are stored in a fixed-size row of the neighbour table,
+ * so that neighbour lookups in the event loop are plain array reads.
+ */
+class CaloLattice {
+public:
+  static const int MaxNeighbours = 26;
+
+  CaloLattice();
+
+  /*! @brief Builds positions and neighbour table from the Calo geometry.
+   *
+   * @param caloGeoParams The Calo geometry parameters.
+   * @return true if the cube positions could be mapped on a regular lattice, false otherwise.
+   */
+  bool Build(const CaloGeoParams &caloGeoParams);
+
+  unsigned int NCubes() const { return _ncubes; }
+  float CubeSize() const { return _cubesize; }
+  float Pitch(int coo) const { return _pitch[coo]; }
+
+  const float *X() const { return _x.data(); }
+  const float *Y() const { return _y.data(); }
+  const float *Z() const { return _z.data(); }
+
+  /*! @brief Number of neighbours of a cube. */
+  int NNeighbours(unsigned int cube) const { return _nneighbours[cube]; }
+
+  /*! @brief Pointer to the neighbour IDs of a cube (NNeighbours(cube) valid entries). */
+  const unsigned int *Neighbours(unsigned int cube) const { return &_neighbours[(size_t)cube * MaxNeighbours]; }
+
+private:
+  unsigned int _ncubes;
+  float _cubesize;
+  float _pitch[3];
+  std::vector<float> _x, _y, _z;
+  std::vector<unsigned char> _nneighbours;
+  std::vector<unsigned int> _neighbours;
+};
+
+} // namespace Herd
+
+#endif /* HERD_CALOLATTICE_H_ */
@@ -0,0 +1,66 @@
+/*! @file CaloMoments.h CaloMoments struct declaration. */
+
+#ifndef HERD_CALOMOMENTS_H_
+#define HERD_CALOMOMENTS_H_
+
+// C/C++ standard headers
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Energy-weighted moments of a set of Calo hits.
+ * @struct CaloMoments CaloMoments.h
+ *
+ * Holds the zeroth, first and second order weighted moments of the hit positions, which is all that is needed to
+ * compute the centre of gravity and the covariance matrix of a shower. Moments of disjoint sets of hits can be summed,
+ * so merging two clusters does not require a new pass over their hits.
+ */
+struct CaloMoments {
+
+  unsigned int n; ///Number of hits
+  double sumw;    ///Sum of the weights (energy deposits)
+  double s1[3];   ///Weighted sums of X, Y, Z
+  double s2[6];   ///Weighted sums of XX, XY, XZ, YY, YZ, ZZ
+
+  CaloMoments() { Reset(); };
+
+  /*! @brief Set the members to default values */
+  void Reset() {
+    n = 0;
+    sumw = 0;
+    for (int i = 0; i < 3; i++) s1[i] = 0;
+    for (int i = 0; i < 6; i++) s2[i] = 0;
+  }
+
+  /*! @brief Add a hit at position (x,y,z) with weight w */
+  void Add(double x, double y, double z, double w) {
+    n++;
+    sumw += w;
+    s1[0] += w * x; s1[1] += w * y; s1[2] += w * z;
+    s2[0] += w * x * x; s2[1] += w * x * y; s2[2] += w * x * z;
+    s2[3] += w * y * y; s2[4] += w * y * z; s2[5] += w * z * z;
+  }
+
+  /*! @brief Add the moments of another (disjoint) set of hits */
+  void Merge(const CaloMoments &other) {
+    n += other.n;
+    sumw += other.sumw;
+    for (int i = 0; i < 3; i++) s1[i] += other.s1[i];
+    for (int i = 0; i < 6; i++) s2[i] += other.s2[i];
+  }
+
+  /*! @brief Centre of gravity along coordinate i (0,1,2 for X,Y,Z) */
+  double Cog(int i) const { return s1[i] / sumw; }
+
+  /*! @brief Weighted covariance of coordinates i and j around the centre of gravity */
+  double Cov(int i, int j) const {
+    static const int idx[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+    return s2[idx[i][j]] / sumw - Cog(i) * Cog(j);
+  }
+};
+
+using CaloMomentsVec = std::vector<CaloMoments>;
+
+} // namespace Herd
+
+#endif /* HERD_CALOMOMENTS_H_ */
@@ -4,6 +4,7 @@
 #include "dataobjects/CaloClusters.h"
 #include "dataobjects/CaloGeoParams.h"
 #include "dataobjects/MCTruth.h"
+#include "CaloClusterIDs.h"
 
 // Root headers
 
@@ -15,19 +16,23 @@ RegisterAlgorithm(CaloTest);
 
 
 CaloTest::CaloTest(const std::string &name) :
-  Algorithm{name}
+  Algorithm{name},
+  perfcounters{false}
    {
-    
+    DefineParameter("perfcounters", perfcounters);
   }
 
 bool CaloTest::Initialize() {
   const std::string routineName("CaloTest::Initialize");
   _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
   return true;
 }
 
 bool CaloTest::Process() {
-  const std::string routineName("CaloTest::Process");
+  static const std::string routineName("CaloTest::Process");
+  Herd::ProcessScope timing(_timer);
 
   //Add the ProcessStore object for this event to the event data store
   auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
@@ -44,13 +49,18 @@ bool CaloTest::Process() {
   int calonhits =     std::accumulate(caloHits->begin(), caloHits->end(), 0.,[](int n, const Herd::Hit &hit) { if( hit.EDep()>0) return n+1; });
   int calonclusters = std::accumulate(caloClusters->begin(), caloClusters->end(), 0.,[](int n, const Herd::CaloHits &calohit) { return n+1; });
   
-  COUT(INFO)<<calototedep<<" "<<calonhits<<" "<<caloClusters->size()<<ENDL;
+  auto caloClusterIDs = _evStore->GetObject<Herd::CaloClusterIDs>("caloClusterIDs");
+  
+  COUT(INFO)<<calototedep<<" "<<calonhits<<" "<<caloClusters->size()<<" "<<(caloClusterIDs ? (int)caloClusterIDs->NClusters() : -1)<<ENDL;
 
 return true;
 }
 
 bool CaloTest::Finalize() {
   const std::string routineName("CaloTest::Finalize");
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
   return true;
 }
 
@@ -3,6 +3,8 @@
 
 #include "algorithm/Algorithm.h"
 
+#include "Core/ProcessTimer.h"
+
 // HerdSoftware headers
 
 using namespace EA;
@@ -22,6 +24,8 @@ public:
 private:
 
   // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
 
 };
@@ -0,0 +1,60 @@
+/*! @file AcceptanceEvent.cpp AcceptanceEvent implementation. */
+
+#include "AcceptanceEvent.h"
+
+// HerdSoftware headers
+#include "dataobjects/MCTruth.h"
+#include "dataobjects/StkIntersections.h"
+#include "dataobjects/TrackInfoForCalo.h"
+
+// C/C++ standard headers
+#include <string>
+
+namespace Herd {
+
+namespace {
+
+//Names longer than the small-string buffer would build a heap-allocated temporary std::string on every lookup
+const std::string stkintersectionsname("stkIntersectionsMC");
+const std::string calotrackname("trackInfoForCaloMC");
+
+} // namespace
+
+bool LoadAcceptanceEvent(EA::EventDataStore &evStore, unsigned long long index, AcceptanceEvent &event) {
+
+  event.index = index;
+
+  auto mctruth = evStore.GetObject<MCTruth>("mcTruth");
+  if (!mctruth || mctruth->primaries.empty()) return false;
+  const auto &primary = mctruth->primaries[0];
+  for (int i = 0; i < 3; i++) {
+    event.position[i] = primary.initialPosition[static_cast<RefFrame::Coo>(i)];
+    event.momentum[i] = primary.initialMomentum[static_cast<RefFrame::Coo>(i)];
+  }
+  event.ndiscarded = mctruth->nDiscarded;
+
+  auto stkintersections = evStore.GetObject<StkIntersections>(stkintersectionsname);
+  event.hasstkintersections = (bool)stkintersections;
+  event.nstkintersections = stkintersections ? static_cast<int>(stkintersections->intersections.size()) : -1;
+
+  auto calotrack = evStore.GetObject<TrackInfoForCalo>(calotrackname);
+  event.hascalotrack = (bool)calotrack;
+  if (calotrack) {
+    event.caloentryplane = calotrack->entrancePlane;
+    event.caloexitplane = calotrack->exitPlane;
+    for (int i = 0; i < 3; i++) {
+      event.caloentry[i] = calotrack->entrance[static_cast<RefFrame::Coo>(i)];
+      event.caloexit[i] = calotrack->exit[static_cast<RefFrame::Coo>(i)];
+    }
+    event.tracklengthcalox0 = calotrack->trackLengthCaloX0;
+    event.tracklengthlysox0 = calotrack->trackLengthLYSOX0;
+  } else {
+    event.caloentryplane = event.caloexitplane = RefFrame::Direction::NONE;
+    for (int i = 0; i < 3; i++) event.caloentry[i] = event.caloexit[i] = -999.;
+    event.tracklengthcalox0 = event.tracklengthlysox0 = -999.;
+  }
+
+  return true;
+}
+
+} // namespace Herd
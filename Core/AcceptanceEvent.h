@@ -0,0 +1,57 @@
+/*! @file AcceptanceEvent.h AcceptanceEvent struct declaration. */
+
+#ifndef HERD_ACCEPTANCEEVENT_H_
+#define HERD_ACCEPTANCEEVENT_H_
+
+#include "algorithm/Algorithm.h"
+#include "dataobjects/Point.h"
+
+namespace Herd {
+
+/*! @brief The per-event inputs of the acceptance algorithms.
+ * @struct AcceptanceEvent AcceptanceEvent.h
+ *
+ * A flat copy of the MC truth, calo track and STK intersection information used by the acceptance algorithms, so
+ * that an event can be processed away from the event data store (e.g. on a worker thread, after the store has moved
+ * to the next event). index is the position of the event in the input: outputs which depend on the event order (like
+ * the points of a graph) are sorted by it.
+ */
+struct AcceptanceEvent {
+  unsigned long long index;
+
+  // MC primary
+  float position[3]; // Initial position (cm)
+  float momentum[3]; // Initial momentum (GeV/c)
+  int ndiscarded;    // Events discarded by the generator before this one
+
+  // STK intersections (hasstkintersections false if stkIntersectionsMC is not available)
+  bool hasstkintersections;
+  int nstkintersections;
+
+  // MC track in the calo (hascalotrack false if trackInfoForCaloMC is not available)
+  bool hascalotrack;
+  RefFrame::Direction caloentryplane;
+  RefFrame::Direction caloexitplane;
+  float caloentry[3];
+  float caloexit[3];
+  float tracklengthcalox0;
+  float tracklengthlysox0;
+
+  /*! @brief Squared magnitude of the momentum. */
+  double Momentum2() const {
+    return (double)momentum[0] * momentum[0] + (double)momentum[1] * momentum[1] + (double)momentum[2] * momentum[2];
+  }
+};
+
+/*! @brief Fills an AcceptanceEvent from the objects in the event data store.
+ *
+ * @param evStore The event data store.
+ * @param index The position of the event in the input.
+ * @param event The event to fill.
+ * @return false if mcTruth (which is mandatory) is not available.
+ */
+bool LoadAcceptanceEvent(EA::EventDataStore &evStore, unsigned long long index, AcceptanceEvent &event);
+
+} // namespace Herd
+
+#endif /* HERD_ACCEPTANCEEVENT_H_ */
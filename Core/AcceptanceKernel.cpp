@@ -0,0 +1,43 @@
+/*! @file AcceptanceKernel.cpp KernelRegistry class implementation. */
+
+#include "AcceptanceKernel.h"
+
+namespace Herd {
+
+KernelRegistry &KernelRegistry::Instance() {
+  static KernelRegistry registry;
+  return registry;
+}
+
+void KernelRegistry::Register(const std::string &name, AcceptanceKernel *kernel) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _kernels[name] = kernel;
+}
+
+void KernelRegistry::Unregister(const std::string &name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _kernels.erase(name);
+}
+
+AcceptanceKernel *KernelRegistry::Get(const std::string &name) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = _kernels.find(name);
+  return it == _kernels.end() ? nullptr : it->second;
+}
+
+void KernelRegistry::SetDrain(std::function<void()> drain) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _drain = std::move(drain);
+}
+
+void KernelRegistry::Drain() {
+  if (BatchRunning()) return;
+  std::function<void()> drain;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    drain = _drain;
+  }
+  if (drain) drain();
+}
+
+} // namespace Herd
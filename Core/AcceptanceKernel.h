@@ -0,0 +1,68 @@
+/*! @file AcceptanceKernel.h AcceptanceKernel and KernelRegistry class declarations. */
+
+#ifndef HERD_ACCEPTANCEKERNEL_H_
+#define HERD_ACCEPTANCEKERNEL_H_
+
+#include "AcceptanceEvent.h"
+
+// C/C++ standard headers
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Herd {
+
+/*! @brief Re-entrant per-event processing of an acceptance algorithm.
+ * @class AcceptanceKernel AcceptanceKernel.h
+ *
+ * ProcessEvent must be callable concurrently from several threads: the per-event state lives on the stack or in
+ * event-scoped objects, and the accumulated outputs in per-thread shards which are merged in a fixed order. The
+ * outputs are then identical whatever the number of threads and the order in which the events are processed.
+ */
+class AcceptanceKernel {
+public:
+  virtual ~AcceptanceKernel() {}
+
+  /*! @brief Processes one event.
+   *
+   * @return false if the event is rejected by the algorithm filter.
+   */
+  virtual bool ProcessEvent(const AcceptanceEvent &event) = 0;
+};
+
+/*! @brief Process-wide lookup of the kernels by algorithm name.
+ * @class KernelRegistry AcceptanceKernel.h
+ *
+ * Algorithms running in deferred mode register their kernel at initialization; a driver (see ParallelAcceptance)
+ * retrieves them by name and registers a drain function which processes the events it still holds. Kernels call
+ * Drain before publishing their outputs, so no event is lost whatever the finalization order. The driver flags the
+ * processing of a batch with SetBatchRunning: a Drain from inside a batch (e.g. from a kernel) does nothing.
+ */
+class KernelRegistry {
+public:
+  static KernelRegistry &Instance();
+
+  void Register(const std::string &name, AcceptanceKernel *kernel);
+  void Unregister(const std::string &name);
+  AcceptanceKernel *Get(const std::string &name) const;
+
+  void SetDrain(std::function<void()> drain);
+  void Drain();
+
+  void SetBatchRunning(bool running) { _batchrunning.store(running, std::memory_order_release); }
+  bool BatchRunning() const { return _batchrunning.load(std::memory_order_acquire); }
+
+private:
+  KernelRegistry() : _batchrunning{false} {}
+
+  mutable std::mutex _mutex;
+  std::map<std::string, AcceptanceKernel *> _kernels;
+  std::function<void()> _drain;
+  std::atomic<bool> _batchrunning;
+};
+
+} // namespace Herd
+
+#endif /* HERD_ACCEPTANCEKERNEL_H_ */
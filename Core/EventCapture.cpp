@@ -0,0 +1,290 @@
+/*! @file EventCapture.cpp EventCapture and EventReplay class implementations. */
+
+#include "EventCapture.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cstdint>
+
+namespace Herd {
+
+RegisterAlgorithm(EventCapture);
+RegisterAlgorithm(EventReplay);
+
+namespace {
+
+//Names longer than the small-string buffer would build a heap-allocated temporary std::string on every lookup
+const std::string mctruthname("mcTruth");
+const std::string stkintersectionsname("stkIntersectionsMC");
+const std::string calotrackname("trackInfoForCaloMC");
+const std::string calohitsname("caloHitsMC");
+const std::string caloclustersname("caloClusters");
+
+//The object of the data provider if there is one, otherwise one of the pool added to the store
+template <class T> T &ProvidedOrOwn(EventDataStore &evStore, const std::string &name, StorePool<T> &pool) {
+  observer_ptr<T> provided = evStore.GetObject<T>(name);
+  if (provided) return *provided;
+  auto own = pool.Acquire();
+  evStore.AddObject(name, own);
+  return *own;
+}
+
+//Clears the object of the data provider, if any, for an event captured without it: it belongs to another event
+template <class T, class Clear> void ClearProvided(EventDataStore &evStore, const std::string &name, Clear clear) {
+  observer_ptr<T> provided = evStore.GetObject<T>(name);
+  if (provided) clear(*provided);
+}
+
+void ClearCaloTrack(TrackInfoForCalo &calotrack) {
+  calotrack.entrancePlane = calotrack.exitPlane = RefFrame::Direction::NONE;
+  calotrack.entrance = calotrack.exit = Point();
+  calotrack.trackLengthCaloX0 = calotrack.trackLengthLYSOX0 = 0;
+}
+
+} // namespace
+
+EventCapture::EventCapture(const std::string &name) :
+  Algorithm{name},
+  filename{"eventsample.bin"},
+  nevents{10000},
+  prescale{1},
+  _nseen{0},
+  perfcounters{false}
+   {
+    DeclareConsumedObject("mcTruth", ObjectCategory::EVENT, "evStore");
+    DeclareConsumedObject("stkIntersectionsMC", ObjectCategory::EVENT, "evStore");
+    DeclareConsumedObject("trackInfoForCaloMC", ObjectCategory::EVENT, "evStore");
+    DeclareConsumedObject("caloHitsMC", ObjectCategory::EVENT, "evStore");
+    DeclareConsumedObject("caloClusters", ObjectCategory::EVENT, "evStore");
+
+    DefineParameter("filename", filename);
+    DefineParameter("nevents", nevents);
+    DefineParameter("prescale", prescale);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+bool EventCapture::Initialize() {
+  const std::string routineName("EventCapture::Initialize");
+
+  _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+  if( filename.empty() || nevents<=0 || prescale<=0 ) { COUT(ERROR) << "filename must be set, nevents and prescale must be positive" << ENDL; return false; }
+
+  _sample.Clear();
+  _nseen = 0;
+  COUT(INFO) << "Capturing up to " << nevents << " events, one every " << prescale << ", into " << filename << ENDL;
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+  return true;
+}
+
+bool EventCapture::Process() {
+  static const std::string routineName("EventCapture::Process");
+  ProcessScope timing(_timer);
+
+  if( _nseen++ % prescale != 0 || _sample.Size() >= (size_t)nevents ) return true;
+
+  auto mctruth = _evStore->GetObject<MCTruth>(mctruthname);
+  if (!mctruth || mctruth->primaries.empty()) { COUT(DEBUG) << "mcTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+
+  SampleEvent &event = _sample.AddEvent();
+  const MCParticle &primary = mctruth->primaries[0];
+  for (int i = 0; i < 3; i++) {
+    event.position[i] = primary.initialPosition[static_cast<RefFrame::Coo>(i)];
+    event.momentum[i] = primary.initialMomentum[static_cast<RefFrame::Coo>(i)];
+  }
+  event.pdgcode = primary.PDGCode;
+  event.ndiscarded = mctruth->nDiscarded;
+
+  auto calotrack = _evStore->GetObject<TrackInfoForCalo>(calotrackname);
+  event.caloentryplane = event.caloexitplane = static_cast<int32_t>(RefFrame::Direction::NONE);
+  if( calotrack ){
+    event.flags |= SampleEvent::HASCALOTRACK;
+    event.caloentryplane = static_cast<int32_t>(calotrack->entrancePlane);
+    event.caloexitplane = static_cast<int32_t>(calotrack->exitPlane);
+    for (int i = 0; i < 3; i++) {
+      event.caloentry[i] = calotrack->entrance[static_cast<RefFrame::Coo>(i)];
+      event.caloexit[i] = calotrack->exit[static_cast<RefFrame::Coo>(i)];
+    }
+    event.tracklengthcalox0 = calotrack->trackLengthCaloX0;
+    event.tracklengthlysox0 = calotrack->trackLengthLYSOX0;
+  }
+
+  auto stkintersections = _evStore->GetObject<StkIntersections>(stkintersectionsname);
+  if( stkintersections ){
+    event.flags |= SampleEvent::HASSTKINTERSECTIONS;
+    for(auto const& point: stkintersections->intersections)
+      _sample.AddStkIntersection(point[RefFrame::Coo::X], point[RefFrame::Coo::Y], point[RefFrame::Coo::Z]);
+  }
+
+  auto calohits = _evStore->GetObject<CaloHits>(calohitsname);
+  if( calohits ){
+    event.flags |= SampleEvent::HASCALOHITS;
+    for(auto const& hit: *calohits) _sample.AddHit(hit.VolumeID(), hit.EDep());
+  }
+
+  auto caloclusters = _evStore->GetObject<CaloClusters>(caloclustersname);
+  if( caloclusters ){
+    event.flags |= SampleEvent::HASCALOCLUSTERS;
+    for(auto const& cluster: *caloclusters){
+      _sample.AddCluster();
+      for(auto const& hit: cluster) _sample.AddClusterHit(hit.VolumeID(), hit.EDep());
+    }
+  }
+
+  return true;
+}
+
+bool EventCapture::Finalize() {
+  const std::string routineName("EventCapture::Finalize");
+
+  std::string errmsg;
+  if( !_sample.Write(filename, errmsg) ) { COUT(ERROR) << errmsg << ENDL; return false; }
+  COUT(INFO) << "Captured " << _sample.Size() << " events (" << _sample.NHits() << " Calo hits) into " << filename << ENDL;
+
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+//***************************
+
+EventReplay::EventReplay(const std::string &name) :
+  Algorithm{name},
+  filename{"eventsample.bin"},
+  loops{0},
+  _next{0},
+  _nreplayed{0},
+  _nrejected{0},
+  perfcounters{false}
+   {
+    DeclareProducedObject("mcTruth", ObjectCategory::EVENT, "evStore");
+    DeclareProducedObject("stkIntersectionsMC", ObjectCategory::EVENT, "evStore");
+    DeclareProducedObject("trackInfoForCaloMC", ObjectCategory::EVENT, "evStore");
+    DeclareProducedObject("caloHitsMC", ObjectCategory::EVENT, "evStore");
+    DeclareProducedObject("caloClusters", ObjectCategory::EVENT, "evStore");
+
+    DefineParameter("filename", filename);
+    DefineParameter("loops", loops);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+bool EventReplay::Initialize() {
+  const std::string routineName("EventReplay::Initialize");
+
+  _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+
+  std::string errmsg;
+  if( !_sample.Read(filename, errmsg) ) { COUT(ERROR) << errmsg << ENDL; return false; }
+  if( _sample.Size()==0 ) { COUT(ERROR) << filename << " has no events" << ENDL; return false; }
+  if( loops<0 ) { COUT(ERROR) << "loops must not be negative" << ENDL; return false; }
+  SetFilterStatus(loops>0 ? FilterStatus::ENABLED : FilterStatus::DISABLED);
+
+  //Size the objects for the largest event, so the replay does not allocate
+  uint32_t maxstk = 0, maxhits = 0, maxclusters = 0;
+  for(size_t ievent=0; ievent<_sample.Size(); ievent++){
+    const SampleEvent &event = _sample.Event(ievent);
+    maxstk = std::max(maxstk, event.nstkintersections);
+    maxhits = std::max(maxhits, event.nhits);
+    maxclusters = std::max(maxclusters, event.nclusters);
+  }
+  _mctruth.Init([]() { auto mctruth = std::make_shared<MCTruth>(); mctruth->primaries.resize(1); return mctruth; },
+                [](MCTruth &) {});
+  _stkintersections.Init([maxstk]() { auto stk = std::make_shared<StkIntersections>(); stk->intersections.reserve(maxstk); return stk; },
+                         [](StkIntersections &stk) { stk.intersections.clear(); });
+  _calotrack.Init([]() { return std::make_shared<TrackInfoForCalo>(); }, ClearCaloTrack);
+  _calohits.Init([maxhits]() { auto hits = std::make_shared<CaloHits>(); hits->reserve(maxhits); return hits; },
+                 [](CaloHits &hits) { hits.clear(); });
+  _caloclusters.Init([maxclusters]() { auto clusters = std::make_shared<CaloClusters>(); clusters->reserve(maxclusters); return clusters; },
+                     [](CaloClusters &) {}); // Resized to the clusters of each event, keeping the capacity of their hits
+
+  _next = 0;
+  _nreplayed = 0;
+  _nrejected = 0;
+  COUT(INFO) << "Replaying " << _sample.Size() << " events from " << filename;
+  if( loops>0 ) COUT(INFO) << ", " << loops << " times";
+  COUT(INFO) << ENDL;
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+  return true;
+}
+
+bool EventReplay::Process() {
+  static const std::string routineName("EventReplay::Process");
+  ProcessScope timing(_timer);
+
+  SetFilterResult(FilterResult::ACCEPT);
+  if( loops>0 && _nreplayed >= (unsigned long long)loops * _sample.Size() ){
+    if( _nrejected++ == 0 ) COUT(INFO) << loops << " passes over the sample done, the following events of the data list are rejected" << ENDL;
+    SetFilterResult(FilterResult::REJECT);
+    return true;
+  }
+  const SampleEvent &event = _sample.Event(_next);
+  if( ++_next == _sample.Size() ) _next = 0;
+  _nreplayed++;
+
+  MCTruth &mctruth = ProvidedOrOwn(*_evStore, mctruthname, _mctruth);
+  mctruth.primaries.resize(1);
+  MCParticle &primary = mctruth.primaries[0];
+  primary.initialPosition = Point(event.position[0], event.position[1], event.position[2]);
+  primary.initialMomentum = Momentum(event.momentum[0], event.momentum[1], event.momentum[2]);
+  primary.PDGCode = event.pdgcode;
+  mctruth.nDiscarded = event.ndiscarded;
+
+  if( event.Has(SampleEvent::HASCALOTRACK) ){
+    TrackInfoForCalo &calotrack = ProvidedOrOwn(*_evStore, calotrackname, _calotrack);
+    calotrack.entrancePlane = static_cast<RefFrame::Direction>(event.caloentryplane);
+    calotrack.exitPlane = static_cast<RefFrame::Direction>(event.caloexitplane);
+    calotrack.entrance = Point(event.caloentry[0], event.caloentry[1], event.caloentry[2]);
+    calotrack.exit = Point(event.caloexit[0], event.caloexit[1], event.caloexit[2]);
+    calotrack.trackLengthCaloX0 = event.tracklengthcalox0;
+    calotrack.trackLengthLYSOX0 = event.tracklengthlysox0;
+  }
+  else ClearProvided<TrackInfoForCalo>(*_evStore, calotrackname, ClearCaloTrack);
+
+  if( event.Has(SampleEvent::HASSTKINTERSECTIONS) ){
+    StkIntersections &stkintersections = ProvidedOrOwn(*_evStore, stkintersectionsname, _stkintersections);
+    stkintersections.intersections.clear();
+    for(uint32_t i=0; i<event.nstkintersections; i++){
+      const float *point = _sample.StkIntersection(event.firststkintersection + i);
+      stkintersections.intersections.emplace_back(point[0], point[1], point[2]);
+    }
+  }
+  else ClearProvided<StkIntersections>(*_evStore, stkintersectionsname, [](StkIntersections &stk) { stk.intersections.clear(); });
+
+  if( event.Has(SampleEvent::HASCALOHITS) ){
+    CaloHits &calohits = ProvidedOrOwn(*_evStore, calohitsname, _calohits);
+    calohits.clear();
+    const SampleHit *hit = _sample.Hits(event);
+    for(uint32_t ihit=0; ihit<event.nhits; ihit++, hit++) calohits.emplace_back(hit->volumeid, hit->edep);
+  }
+  else ClearProvided<CaloHits>(*_evStore, calohitsname, [](CaloHits &hits) { hits.clear(); });
+
+  if( event.Has(SampleEvent::HASCALOCLUSTERS) ){
+    CaloClusters &caloclusters = ProvidedOrOwn(*_evStore, caloclustersname, _caloclusters);
+    caloclusters.resize(event.nclusters);
+    const SampleHit *hit = _sample.ClusterHits(event);
+    for(uint32_t icluster=0; icluster<event.nclusters; icluster++){
+      CaloHits &cluster = caloclusters[icluster];
+      const uint32_t nhits = _sample.ClusterSize(event.firstcluster + icluster);
+      cluster.clear();
+      for(uint32_t ihit=0; ihit<nhits; ihit++, hit++) cluster.emplace_back(hit->volumeid, hit->edep);
+    }
+  }
+  else ClearProvided<CaloClusters>(*_evStore, caloclustersname, [](CaloClusters &clusters) { clusters.clear(); });
+
+  return true;
+}
+
+bool EventReplay::Finalize() {
+  const std::string routineName("EventReplay::Finalize");
+
+  COUT(INFO) << "Replayed " << _nreplayed << " events (" << (double)_nreplayed / _sample.Size() << " passes over the sample)" << ENDL;
+  if( _nrejected>0 ) COUT(INFO) << _nrejected << " events of the data list read and rejected after the last pass" << ENDL;
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+} // namespace Herd
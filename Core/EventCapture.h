@@ -0,0 +1,125 @@
+/*! @file EventCapture.h EventCapture and EventReplay class declarations. */
+
+#ifndef HERD_EVENTCAPTURE_H_
+#define HERD_EVENTCAPTURE_H_
+
+#include "algorithm/Algorithm.h"
+
+// HerdSoftware headers
+#include "dataobjects/CaloClusters.h"
+#include "dataobjects/CaloHits.h"
+#include "dataobjects/MCTruth.h"
+#include "dataobjects/StkIntersections.h"
+#include "dataobjects/TrackInfoForCalo.h"
+
+#include "EventSample.h"
+#include "ProcessTimer.h"
+#include "Utils/StorePool.h"
+
+// C/C++ standard headers
+#include <memory>
+#include <string>
+
+using namespace EA;
+
+namespace Herd {
+
+/*! @brief Saves the inputs of the acceptance and Calo algorithms for a sample of events into an EventSample file.
+ * @class EventCapture EventCapture.h
+ *
+ * Every prescale-th event is captured, up to nevents events; the file is written at Finalize. Put it where the
+ * objects are complete (e.g. after the algorithms computing trackInfoForCaloMC and stkIntersectionsMC) and before
+ * any filter, so the sample has the event mix of the input. Missing objects are recorded as such and are not
+ * produced at replay.
+ *
+ * <B>Needed event objects:</B>
+ *
+ *   name               |     type          |  store      | optional       | description
+ * ---------------------|-------------------|-------------|----------------|-------------------------
+ * mcTruth              | MCTruth           | evStore     |    no          | Info about MC truth (first primary only)
+ * stkIntersectionsMC   | StkIntersections  | evStore     |    yes         | MC track intersections with the STK
+ * trackInfoForCaloMC   | TrackInfoForCalo  | evStore     |    yes         | MC track information for the calo
+ * caloHitsMC           | CaloHits          | evStore     |    yes         | Calo hits
+ * caloClusters         | CaloClusters      | evStore     |    yes         | Calo clusters
+ */
+class EventCapture : public Algorithm {
+public:
+  EventCapture(const std::string &name);
+
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  // Algorithm parameters
+  std::string filename; // Output EventSample file
+  int nevents;          // Maximum number of events captured
+  int prescale;         // Capture one event every prescale
+
+  EventSample _sample;
+  unsigned long long _nseen;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+/*! @brief Fills the event with the objects of an EventSample file, to profile the algorithms without the input files.
+ * @class EventReplay EventCapture.h
+ *
+ * Event i gets the objects of the captured event i modulo the sample size, so the sample is replayed over and over.
+ * As SyntheticEvents, put it first in the event loop: the objects already filled by the data provider are replaced,
+ * the others are added. An object missing from the captured event is not produced, and if the data provider filled it
+ * it is cleared (emptied, or without Calo entry for trackInfoForCaloMC), since it belongs to another event. The added
+ * objects come from StorePools sized for the largest event of the sample, so the replay itself does not allocate.
+ *
+ * The sample is read in memory at Initialize and the replay reads nothing from disk, but the event loop is still
+ * driven by the data provider of the configuration, which reads its input files for every event as usual: that I/O
+ * is part of the job time (not of the Process() timings, see ProcessTimer). The number of events is the one of the
+ * data list. With loops > 0 the events after loops passes are rejected (put the algorithms after it in a sequence),
+ * but an algorithm cannot end the event loop, so the provider keeps reading until the end of the data list: size the
+ * data list to loops times the sample size, the number of events rejected after the last pass is logged at Finalize.
+ *
+ * <B>Produced event objects (those present in the sample):</B>
+ *
+ *   name               |     type          |  store      | description
+ * ---------------------|-------------------|-------------|-------------------------
+ * mcTruth              | MCTruth           | evStore     | The captured primary
+ * stkIntersectionsMC   | StkIntersections  | evStore     | MC track intersections with the STK
+ * trackInfoForCaloMC   | TrackInfoForCalo  | evStore     | MC track information for the calo
+ * caloHitsMC           | CaloHits          | evStore     | Calo hits
+ * caloClusters         | CaloClusters      | evStore     | Calo clusters
+ */
+class EventReplay : public Algorithm {
+public:
+  EventReplay(const std::string &name);
+
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  // Algorithm parameters
+  std::string filename; // Input EventSample file
+  int loops;            // Passes over the sample (0: as many as the events of the data list)
+
+  EventSample _sample;
+  size_t _next;
+  unsigned long long _nreplayed;
+  unsigned long long _nrejected; // Events after the last of the loops passes
+  StorePool<MCTruth> _mctruth;
+  StorePool<StkIntersections> _stkintersections;
+  StorePool<TrackInfoForCalo> _calotrack;
+  StorePool<CaloHits> _calohits;
+  StorePool<CaloClusters> _caloclusters;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+} // namespace Herd
+
+#endif /* HERD_EVENTCAPTURE_H_ */
@@ -0,0 +1,154 @@
+/*! @file EventSample.cpp EventSample class implementation. */
+
+#include "EventSample.h"
+
+// C/C++ standard headers
+#include <cstring>
+#include <fstream>
+
+namespace Herd {
+
+namespace {
+
+const char magic[8] = "HERDEVS";
+const uint32_t version = 1;
+const uint32_t byteorder = 0x01020304;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteorder;
+  uint32_t eventsize;
+  uint32_t reserved;
+  uint64_t nevents, nstkintersections, nhits, nclusters, nclusterhits;
+};
+
+template <class T> void WriteArray(std::ofstream &out, const std::vector<T> &array) {
+  out.write(reinterpret_cast<const char *>(array.data()), array.size() * sizeof(T));
+}
+
+template <class T> bool ReadArray(std::ifstream &in, uint64_t size, uint64_t &remaining, std::vector<T> &array) {
+  if (size > remaining / sizeof(T)) return false;
+  remaining -= size * sizeof(T);
+  array.resize(size);
+  return (bool)in.read(reinterpret_cast<char *>(array.data()), size * sizeof(T));
+}
+
+} // namespace
+
+void EventSample::Clear() {
+  _events.clear();
+  _stkintersections.clear();
+  _hits.clear();
+  _clustersizes.clear();
+  _clusterhits.clear();
+}
+
+SampleEvent &EventSample::AddEvent() {
+  _events.emplace_back();
+  SampleEvent &event = _events.back();
+  std::memset(&event, 0, sizeof(event));
+  event.firststkintersection = _stkintersections.size() / 3;
+  event.firsthit = _hits.size();
+  event.firstcluster = _clustersizes.size();
+  event.firstclusterhit = _clusterhits.size();
+  return event;
+}
+
+void EventSample::AddStkIntersection(float x, float y, float z) {
+  _stkintersections.insert(_stkintersections.end(), {x, y, z});
+  _events.back().nstkintersections++;
+}
+
+void EventSample::AddHit(uint32_t volumeid, float edep) {
+  _hits.push_back({volumeid, edep});
+  _events.back().nhits++;
+}
+
+void EventSample::AddCluster() {
+  _clustersizes.push_back(0);
+  _events.back().nclusters++;
+}
+
+void EventSample::AddClusterHit(uint32_t volumeid, float edep) {
+  _clusterhits.push_back({volumeid, edep});
+  _clustersizes.back()++;
+}
+
+bool EventSample::Write(const std::string &filename, std::string &errmsg) const {
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    errmsg = "Cannot write " + filename;
+    return false;
+  }
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.byteorder = byteorder;
+  header.eventsize = sizeof(SampleEvent);
+  header.nevents = _events.size();
+  header.nstkintersections = _stkintersections.size() / 3;
+  header.nhits = _hits.size();
+  header.nclusters = _clustersizes.size();
+  header.nclusterhits = _clusterhits.size();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  WriteArray(out, _events);
+  WriteArray(out, _stkintersections);
+  WriteArray(out, _hits);
+  WriteArray(out, _clustersizes);
+  WriteArray(out, _clusterhits);
+  if (!out.flush()) {
+    errmsg = "Error writing " + filename;
+    return false;
+  }
+  return true;
+}
+
+bool EventSample::Read(const std::string &filename, std::string &errmsg) {
+  Clear();
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+  uint64_t remaining = in.tellg();
+  in.seekg(0);
+  FileHeader header;
+  if (remaining < sizeof(header) || !in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+    errmsg = filename + " is not an event sample";
+    return false;
+  }
+  if (header.version != version || header.byteorder != byteorder || header.eventsize != sizeof(SampleEvent)) {
+    errmsg = filename + ": unsupported version or byte order";
+    return false;
+  }
+  remaining -= sizeof(header);
+  if (!ReadArray(in, header.nevents, remaining, _events) ||
+      !ReadArray(in, 3 * header.nstkintersections, remaining, _stkintersections) ||
+      !ReadArray(in, header.nhits, remaining, _hits) || !ReadArray(in, header.nclusters, remaining, _clustersizes) ||
+      !ReadArray(in, header.nclusterhits, remaining, _clusterhits)) {
+    Clear();
+    errmsg = filename + " is truncated";
+    return false;
+  }
+
+  //The ranges must lie within the pools
+  for (auto const &event : _events) {
+    uint64_t nclusterhits = 0;
+    const bool clustersok = (uint64_t)event.firstcluster + event.nclusters <= _clustersizes.size();
+    for (uint32_t icluster = 0; clustersok && icluster < event.nclusters; icluster++)
+      nclusterhits += _clustersizes[event.firstcluster + icluster];
+    if ((uint64_t)event.firststkintersection + event.nstkintersections > header.nstkintersections ||
+        (uint64_t)event.firsthit + event.nhits > _hits.size() || !clustersok ||
+        event.firstclusterhit + nclusterhits > _clusterhits.size()) {
+      Clear();
+      errmsg = filename + " is corrupted";
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,106 @@
+/*! @file EventSample.h EventSample class declaration. */
+
+#ifndef HERD_EVENTSAMPLE_H_
+#define HERD_EVENTSAMPLE_H_
+
+// C/C++ standard headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief A Calo hit of a captured event: cube index and energy deposit (GeV). */
+struct SampleHit {
+  uint32_t volumeid;
+  float edep;
+};
+
+/*! @brief The fixed-size part of a captured event.
+ * @struct SampleEvent EventSample.h
+ *
+ * The variable-size objects (STK intersections, Calo hits, Calo clusters) are ranges of the pools of the EventSample:
+ * cluster i of the event has ClusterSize(firstcluster + i) hits, stored one cluster after the other from
+ * firstclusterhit in the cluster hit pool.
+ */
+struct SampleEvent {
+  enum Flags : uint32_t {
+    HASSTKINTERSECTIONS = 1, // stkIntersectionsMC was available
+    HASCALOTRACK = 2,        // trackInfoForCaloMC was available
+    HASCALOHITS = 4,         // caloHitsMC was available
+    HASCALOCLUSTERS = 8      // caloClusters was available
+  };
+
+  // MC primary
+  float position[3]; // Initial position (cm)
+  float momentum[3]; // Initial momentum (GeV/c)
+  int32_t pdgcode;
+  uint32_t ndiscarded;
+
+  uint32_t flags;
+
+  // MC track in the calo
+  int32_t caloentryplane; // RefFrame::Direction
+  int32_t caloexitplane;
+  float caloentry[3];
+  float caloexit[3];
+  float tracklengthcalox0;
+  float tracklengthlysox0;
+
+  // Ranges of the pools
+  uint32_t firststkintersection, nstkintersections;
+  uint32_t firsthit, nhits;
+  uint32_t firstcluster, nclusters;
+  uint32_t firstclusterhit;
+
+  bool Has(Flags flag) const { return flags & flag; }
+};
+
+/*! @brief The event data consumed by the acceptance and Calo algorithms for a sample of events, in flat arrays.
+ * @class EventSample EventSample.h
+ *
+ * Filled by EventCapture and replayed by EventReplay, so the algorithms can be profiled on the real event mix without
+ * reading the production files. The file is a header ("HERDEVS", a version and the sizes of the arrays) followed by
+ * the arrays themselves, in the byte order of the machine which wrote it: the events, the STK intersections (x, y, z
+ * in cm), the Calo hits, the cluster sizes and the cluster hits. Read checks the header and the sizes, and fails on a
+ * file of another version or byte order.
+ */
+class EventSample {
+public:
+  void Clear();
+
+  size_t Size() const { return _events.size(); }
+  const SampleEvent &Event(size_t ievent) const { return _events[ievent]; }
+
+  const float *StkIntersection(uint32_t index) const { return &_stkintersections[3 * index]; }
+  const SampleHit *Hits(const SampleEvent &event) const { return _hits.data() + event.firsthit; }
+  uint32_t ClusterSize(uint32_t index) const { return _clustersizes[index]; }
+  const SampleHit *ClusterHits(const SampleEvent &event) const { return _clusterhits.data() + event.firstclusterhit; }
+
+  /*! @brief Total number of Calo hits (caloHitsMC) of the sample. */
+  size_t NHits() const { return _hits.size(); }
+
+  /*! @brief Appends an event: fill its fixed-size part, then add its objects before the next one.
+   *
+   * The ranges of the returned event are set to the (empty) ends of the pools.
+   */
+  SampleEvent &AddEvent();
+  void AddStkIntersection(float x, float y, float z);
+  void AddHit(uint32_t volumeid, float edep);
+  void AddCluster();
+  void AddClusterHit(uint32_t volumeid, float edep);
+
+  bool Write(const std::string &filename, std::string &errmsg) const;
+  bool Read(const std::string &filename, std::string &errmsg);
+
+private:
+  std::vector<SampleEvent> _events;
+  std::vector<float> _stkintersections;
+  std::vector<SampleHit> _hits;
+  std::vector<uint32_t> _clustersizes;
+  std::vector<SampleHit> _clusterhits;
+};
+
+} // namespace Herd
+
+#endif /* HERD_EVENTSAMPLE_H_ */
@@ -0,0 +1,98 @@
+/*! @file ParallelAcceptance.cpp ParallelAcceptance class implementation. */
+
+#include "ParallelAcceptance.h"
+#include "Utils/ThreadIndex.h"
+
+namespace Herd {
+
+RegisterAlgorithm(ParallelAcceptance);
+
+ParallelAcceptance::ParallelAcceptance(const std::string &name) :
+  Algorithm{name},
+  nthreads{1},
+  batchsize{4096},
+  _nbatch{0},
+  _nprocessed{0},
+  _naccepted{0},
+  perfcounters{false}
+   {
+    DeclareConsumedObject("mcTruth", ObjectCategory::EVENT, "evStore");
+
+    DefineParameter("kernels", kernels);
+    DefineParameter("nthreads", nthreads);
+    DefineParameter("batchsize", batchsize);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+ParallelAcceptance::~ParallelAcceptance() {}
+
+bool ParallelAcceptance::Initialize() {
+  const std::string routineName("ParallelAcceptance::Initialize");
+
+  _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+
+  if( batchsize<=0 ) { COUT(ERROR) << "The batch size must be positive." << ENDL; return false; }
+  if( nthreads<1 || nthreads>(int)MaxThreadShards ) { COUT(ERROR) << "The number of threads must be between 1 and " << MaxThreadShards << "." << ENDL; return false; }
+  if( kernels.empty() ) { COUT(ERROR) << "No kernels to run." << ENDL; return false; }
+
+  //The deferred algorithms register their kernel in their Initialize, so they must come before this one
+  std::vector<AcceptanceKernel *> chain;
+  for(auto const &kernelname : kernels){
+    AcceptanceKernel *kernel = KernelRegistry::Instance().Get(kernelname);
+    if( !kernel ) { COUT(ERROR) << "Kernel " << kernelname << " not found: is the algorithm running with deferred true?" << ENDL; return false; }
+    chain.push_back(kernel);
+  }
+
+  _driver.reset(new ParallelDriver(nthreads));
+  _driver->SetKernels(chain);
+  _batch.resize(batchsize);
+  _nbatch = 0;
+
+  //Deferred algorithms drain the pending events before publishing their outputs
+  KernelRegistry::Instance().SetDrain([this]() { Flush(); });
+
+  COUT(INFO) << "Running " << chain.size() << " kernels on " << _driver->NThreads() << " threads, batches of " << batchsize << " events" << ENDL;
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+  _timer.SetWarmup(batchsize); // The first batch creates the per-thread shards of the kernels
+
+  return true;
+}
+
+bool ParallelAcceptance::Process() {
+  static const std::string routineName("ParallelAcceptance::Process");
+  ProcessScope timing(_timer);
+
+  if( !LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), _batch[_nbatch]) ) {
+    COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
+    return false;
+  }
+  if( ++_nbatch == _batch.size() ) Flush();
+
+  return true;
+}
+
+void ParallelAcceptance::Flush() {
+  if( _nbatch==0 ) return;
+  _batch.resize(_nbatch);
+  KernelRegistry::Instance().SetBatchRunning(true);
+  _naccepted += _driver->Run(_batch);
+  KernelRegistry::Instance().SetBatchRunning(false);
+  _nprocessed += _nbatch;
+  _batch.resize(batchsize);
+  _nbatch = 0;
+}
+
+bool ParallelAcceptance::Finalize() {
+  const std::string routineName("ParallelAcceptance::Finalize");
+
+  Flush();
+  KernelRegistry::Instance().SetDrain(nullptr);
+
+  COUT(INFO) << "Processed " << _nprocessed << " events, " << _naccepted << " accepted by all the kernels" << ENDL;
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,71 @@
+/*! @file ParallelAcceptance.h ParallelAcceptance class declaration. */
+
+#ifndef HERD_PARALLELACCEPTANCE_H_
+#define HERD_PARALLELACCEPTANCE_H_
+
+#include "algorithm/Algorithm.h"
+
+#include "AcceptanceEvent.h"
+#include "ParallelDriver.h"
+#include "ProcessTimer.h"
+
+// C/C++ standard headers
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace EA;
+
+namespace Herd {
+
+/*! @brief Runs the deferred acceptance algorithms on batches of events over several threads.
+ * @class ParallelAcceptance ParallelAcceptance.h
+ *
+ * The algorithms listed in the kernels parameter must run with deferred set to true: in the EA sequence they then
+ * only accept the event, and their processing is done here. Every event reaching this algorithm is copied into an
+ * AcceptanceEvent; when batchsize events are collected they are processed by the kernels, in the given order, on
+ * nthreads threads. The outputs in the global store are identical to a serial run.
+ *
+ * Since the filter decisions of the deferred algorithms are only known when the batch is processed, they are not
+ * seen by the EA sequence: this algorithm and the deferred ones must come after everything which needs them.
+ *
+ * <B>Needed event objects:</B>
+ *
+ *   name               |     type          |  store      | optional       | description
+ * ---------------------|-------------------|-------------|----------------|-------------------------
+ * mcTruth              | MCTruth           | evStore     |    no          | Info about MC truth
+ * stkIntersectionsMC   | StkIntersections  | evStore     |    yes         | MC track intersections with the STK
+ * trackInfoForCaloMC   | TrackInfoForCalo  | evStore     |    yes         | MC track information for the calo
+ */
+class ParallelAcceptance : public Algorithm {
+public:
+  ParallelAcceptance(const std::string &name);
+  ~ParallelAcceptance();
+
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  void Flush();
+
+  // Algorithm parameters
+  std::vector<std::string> kernels; // Names of the deferred algorithms, in processing order
+  int nthreads;     // Threads processing the batches, 1 to MaxThreadShards
+  int batchsize;
+
+  std::unique_ptr<ParallelDriver> _driver;
+  std::vector<AcceptanceEvent> _batch;
+  size_t _nbatch;
+  unsigned long long _nprocessed;
+  unsigned long long _naccepted;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+} // namespace Herd
+
+#endif /* HERD_PARALLELACCEPTANCE_H_ */
@@ -0,0 +1,40 @@
+/*! @file ParallelDriver.cpp ParallelDriver class implementation. */
+
+#include "ParallelDriver.h"
+#include "Utils/WorkStealingPool.h"
+
+// C/C++ standard headers
+#include <numeric>
+
+namespace Herd {
+
+ParallelDriver::ParallelDriver(unsigned int nthreads) {
+  if (nthreads > 1) _pool.reset(new WorkStealingPool(nthreads));
+}
+
+ParallelDriver::~ParallelDriver() {}
+
+unsigned int ParallelDriver::NThreads() const { return _pool ? _pool->NThreads() : 1; }
+
+bool ParallelDriver::RunKernels(const AcceptanceEvent &event) const {
+  for (auto kernel : _kernels)
+    if (!kernel->ProcessEvent(event)) return false;
+  return true;
+}
+
+size_t ParallelDriver::Run(const std::vector<AcceptanceEvent> &events, std::vector<char> *accepted) {
+
+  //One slot per event, so the flags do not depend on which thread processed which event
+  std::vector<char> &flags = accepted ? *accepted : _accepted;
+  flags.assign(events.size(), 0);
+
+  if (_pool) {
+    _pool->ParallelFor(events.size(), [&](size_t ievent, unsigned int) { flags[ievent] = RunKernels(events[ievent]); });
+  } else {
+    for (size_t ievent = 0; ievent < events.size(); ievent++) flags[ievent] = RunKernels(events[ievent]);
+  }
+
+  return std::accumulate(flags.begin(), flags.end(), (size_t)0);
+}
+
+} // namespace Herd
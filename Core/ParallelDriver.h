@@ -0,0 +1,60 @@
+/*! @file ParallelDriver.h ParallelDriver class declaration. */
+
+#ifndef HERD_PARALLELDRIVER_H_
+#define HERD_PARALLELDRIVER_H_
+
+#include "AcceptanceKernel.h"
+
+// C/C++ standard headers
+#include <memory>
+#include <vector>
+
+namespace Herd {
+
+class WorkStealingPool;
+
+/*! @brief Runs a chain of acceptance kernels on batches of events over a thread pool.
+ * @class ParallelDriver ParallelDriver.h
+ *
+ * Every event goes through the kernels in order and stops at the first one rejecting it, as in an EA sequence with
+ * all filters enabled. Events are spread over the threads of a WorkStealingPool; the kernels reduce their outputs
+ * deterministically (integer per-thread shards, points sorted by event index), so the results do not depend on the
+ * number of threads.
+ */
+class ParallelDriver {
+public:
+  /*! @brief Constructor.
+   *
+   * @param nthreads Number of threads processing the events (<=1: serial, in the calling thread).
+   */
+  explicit ParallelDriver(unsigned int nthreads);
+  ~ParallelDriver();
+
+  ParallelDriver(const ParallelDriver &) = delete;
+  ParallelDriver &operator=(const ParallelDriver &) = delete;
+
+  void SetKernels(const std::vector<AcceptanceKernel *> &kernels) { _kernels = kernels; }
+  const std::vector<AcceptanceKernel *> &Kernels() const { return _kernels; }
+
+  /*! @brief Processes a batch of events.
+   *
+   * @param events The events.
+   * @param accepted If not null, resized to the number of events and set to 1 for the events accepted by all the
+   *                 kernels.
+   * @return The number of events accepted by all the kernels.
+   */
+  size_t Run(const std::vector<AcceptanceEvent> &events, std::vector<char> *accepted = nullptr);
+
+  unsigned int NThreads() const;
+
+private:
+  bool RunKernels(const AcceptanceEvent &event) const;
+
+  std::unique_ptr<WorkStealingPool> _pool;
+  std::vector<AcceptanceKernel *> _kernels;
+  std::vector<char> _accepted;
+};
+
+} // namespace Herd
+
+#endif /* HERD_PARALLELDRIVER_H_ */
@@ -0,0 +1,28 @@
+/*! @file PowerLaw.h Power-law generation spectrum functions. */
+
+#ifndef HERD_POWERLAW_H_
+#define HERD_POWERLAW_H_
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+
+namespace Herd {
+
+/*! @brief Fraction of the events of a spectrum dN/dE ~ E^index on [min, max] which are generated in [low, high].
+ *
+ * index = -1 is the log-uniform spectrum. The interval is clipped to [min, max], so bins partially or not at all
+ * covered by the generation get the covered fraction or 0.
+ */
+inline double PowerLawFraction(double low, double high, double min, double max, double index) {
+  low = std::max(low, min);
+  high = std::min(high, max);
+  if (!(high > low)) return 0.;
+  if (std::fabs(index + 1.) < 1e-9) return std::log(high / low) / std::log(max / min);
+  const double exponent = index + 1.;
+  return (std::pow(high, exponent) - std::pow(low, exponent)) / (std::pow(max, exponent) - std::pow(min, exponent));
+}
+
+} // namespace Herd
+
+#endif /* HERD_POWERLAW_H_ */
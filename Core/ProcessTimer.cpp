@@ -0,0 +1,121 @@
+/*! @file ProcessTimer.cpp ProcessTimer class implementation. */
+
+#include "ProcessTimer.h"
+
+// Root headers
+#include "TH1D.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Herd {
+
+ProcessTimer::ProcessTimer() : _warmup{100}, _slot{nullptr} { Init(false); }
+
+bool ProcessTimer::Init(bool perfcounters, const std::string &name) {
+  _latency = LatencyHisto(LogAxis(200, 1e+1, 1e+11)); // 10 ns to 100 s
+  _totns = _maxns = 0;
+  _ncounted = 0;
+  for (int icounter = 0; icounter < PerfCounters::NCOUNTERS; icounter++) _totcounters[icounter] = 0;
+  _perfcounters = perfcounters && PerfCounters::ThisThread().IsOpen();
+  _alloctracking = AllocTrackingActive();
+  _totallocs = _totbytes = _steadyallocs = _steadycalls = _allocatingcalls = 0;
+  if (!name.empty() && !_slot) _slot = ProgressBoard::Instance().Acquire(name);
+  if (_slot) {
+    _slot->calls.store(0, std::memory_order_relaxed);
+    _slot->ns.store(0, std::memory_order_relaxed);
+  }
+  return _perfcounters == perfcounters;
+}
+
+ProcessTimer::Mark ProcessTimer::Start() {
+  Mark mark;
+  mark.hascounters = _perfcounters && PerfCounters::ThisThread().Read(mark.counters);
+  mark.allocs = CurrentAllocCount();
+  mark.ns = MonotonicNs();
+  return mark;
+}
+
+void ProcessTimer::Stop(const Mark &start) {
+  const uint64_t ns = MonotonicNs() - start.ns;
+  if (_alloctracking) {
+    const AllocCount allocs = CurrentAllocCount();
+    const uint64_t nallocs = allocs.allocs - start.allocs.allocs;
+    _totallocs += nallocs;
+    _totbytes += allocs.bytes - start.allocs.bytes;
+    if (Calls() >= _warmup) {
+      _steadycalls++;
+      _steadyallocs += nallocs;
+      if (nallocs > 0) _allocatingcalls++;
+    }
+  }
+  uint64_t counters[PerfCounters::NCOUNTERS];
+  if (start.hascounters && PerfCounters::ThisThread().Read(counters)) {
+    for (int icounter = 0; icounter < PerfCounters::NCOUNTERS; icounter++)
+      _totcounters[icounter] += counters[icounter] - start.counters[icounter];
+    _ncounted++;
+  }
+  _latency.Fill((double)ns);
+  _totns += ns;
+  _maxns = std::max(_maxns, ns);
+  if (_slot) {
+    _slot->calls.store(Calls(), std::memory_order_relaxed);
+    _slot->ns.store(_totns, std::memory_order_relaxed);
+  }
+}
+
+double ProcessTimer::Quantile(double q) const {
+  const uint64_t ncalls = Calls();
+  if (ncalls == 0) return 0.;
+  const double target = q * ncalls;
+  const auto &edges = _latency.Axis<0>().Edges();
+  const int nbins = _latency.Axis<0>().NBins();
+  double cumulative = 0.;
+  for (int bin = -1; bin <= nbins; bin++) {
+    const double count = _latency.Contents().Count(_latency.Cell(bin));
+    if (count > 0 && cumulative + count >= target) {
+      if (bin < 0) return edges.front();
+      if (bin == nbins) return (double)_maxns;
+      //Geometric interpolation, the bins being uniform in log
+      const double fraction = (target - cumulative) / count;
+      return std::min((double)_maxns, edges[bin] * std::pow(edges[bin + 1] / edges[bin], fraction));
+    }
+    cumulative += count;
+  }
+  return (double)_maxns;
+}
+
+bool ProcessTimer::Publish(EA::GlobalDataStore &globStore, const std::string &algoname) {
+  auto latency = _latency.ToROOT<TH1D>("h_timing_" + algoname, algoname + "::Process() latency;Latency (ns);Calls");
+  globStore.AddObject(latency->GetName(), latency);
+
+  //Only sums go in the summary, so the summaries of several jobs can be added by the mergers
+  std::vector<std::pair<std::string, double>> values = {{"calls", (double)Calls()}, {"total (ns)", (double)_totns}};
+  if (_ncounted > 0) {
+    values.emplace_back("counted calls", (double)_ncounted);
+    for (int icounter = 0; icounter < PerfCounters::NCOUNTERS; icounter++)
+      values.emplace_back(std::string(PerfCounters::Name(icounter)) + " total", (double)_totcounters[icounter]);
+  }
+  if (_alloctracking) {
+    values.emplace_back("allocs", (double)_totallocs);
+    values.emplace_back("bytes", (double)_totbytes);
+    values.emplace_back("steady calls", (double)_steadycalls);
+    values.emplace_back("steady allocs", (double)_steadyallocs);
+    values.emplace_back("steady allocating calls", (double)_allocatingcalls);
+  }
+
+  const int nvalues = (int)values.size();
+  const std::string summaryname = "h_timingsummary_" + algoname;
+  auto summary = std::make_shared<TH1D>(summaryname.c_str(), (algoname + "::Process() timing summary").c_str(),
+                                        nvalues, 0., nvalues);
+  for (int ivalue = 0; ivalue < nvalues; ivalue++) {
+    summary->GetXaxis()->SetBinLabel(ivalue + 1, values[ivalue].first.c_str());
+    summary->SetBinContent(ivalue + 1, values[ivalue].second);
+  }
+  return globStore.AddObject(summary->GetName(), summary);
+}
+
+} // namespace Herd
@@ -0,0 +1,94 @@
+/*! @file ProcessTimer.h ProcessTimer class declaration. */
+
+#ifndef HERD_PROCESSTIMER_H_
+#define HERD_PROCESSTIMER_H_
+
+#include "algorithm/Algorithm.h"
+
+#include "ProgressBoard.h"
+#include "Histo/HistoEngine.h"
+#include "Utils/AllocTracker.h"
+#include "Utils/PerfCounters.h"
+#include "Utils/ScopedTimer.h"
+
+// C/C++ standard headers
+#include <cstdint>
+#include <string>
+
+namespace Herd {
+
+/*! @brief Latency distribution of the Process() calls of an algorithm.
+ * @class ProcessTimer ProcessTimer.h
+ *
+ * Used through a ScopedTimer<ProcessTimer> at the top of Process(). A call costs two clock_gettime and one histogram
+ * fill; with the hardware counters enabled, two more reads of the counters (one system call each). At Finalize,
+ * Publish adds to the global store the latency histogram (h_timing_<algo>, in ns, 20 bins per decade) and a summary
+ * (h_timingsummary_<algo>) with the number of calls and the total latency, plus the number of calls read by the
+ * counters and the counter totals. Both hold only sums, so the outputs of several jobs merged by OutputMerger (or hadd)
+ * are still right: the mean and the quantiles are computed when reading (see TimingSummary.h).
+ *
+ * When the allocation hooks are loaded (see AllocTracker.h) the allocations made during each call are counted too, and
+ * the summary gets the allocations and bytes, the calls and allocations in steady state (after the first warm-up
+ * calls, which fill caches and size the buffers) and the number of steady-state calls which allocated.
+ *
+ * A timer initialized with the algorithm name also publishes its calls and total time on the ProgressBoard after every
+ * call, for the live report of ProgressReporter.
+ */
+class ProcessTimer {
+public:
+  struct Mark {
+    uint64_t ns;
+    uint64_t counters[PerfCounters::NCOUNTERS];
+    bool hascounters;
+    AllocCount allocs;
+  };
+
+  ProcessTimer();
+
+  /*! @brief Clears the measurements.
+   *
+   * @param perfcounters If true, the hardware counters are read too (if the kernel allows it).
+   * @param name Name shown in the progress reports (empty: not on the ProgressBoard).
+   * @return false if the counters were requested but are not available.
+   */
+  bool Init(bool perfcounters, const std::string &name = "");
+
+  /*! @brief Sets the number of first calls excluded from the steady-state allocation count (default: 100). */
+  void SetWarmup(uint64_t calls) { _warmup = calls; }
+
+  Mark Start();
+  void Stop(const Mark &start);
+
+  uint64_t Calls() const { return _latency.Entries(); }
+  uint64_t Max() const { return _maxns; }
+  uint64_t SteadyAllocs() const { return _steadyallocs; }
+
+  /*! @brief Latency (ns) below which the fraction q of the calls are. */
+  double Quantile(double q) const;
+
+  bool Publish(EA::GlobalDataStore &globStore, const std::string &algoname);
+
+private:
+  typedef Histogram<Int64Storage, LogAxis> LatencyHisto;
+
+  LatencyHisto _latency;
+  uint64_t _totns;
+  uint64_t _maxns;
+  bool _perfcounters;
+  uint64_t _totcounters[PerfCounters::NCOUNTERS];
+  uint64_t _ncounted;
+  bool _alloctracking;
+  uint64_t _warmup;
+  uint64_t _totallocs;
+  uint64_t _totbytes;
+  uint64_t _steadyallocs;
+  uint64_t _steadycalls;
+  uint64_t _allocatingcalls;
+  ProgressBoard::Slot *_slot;
+};
+
+typedef ScopedTimer<ProcessTimer> ProcessScope;
+
+} // namespace Herd
+
+#endif /* HERD_PROCESSTIMER_H_ */
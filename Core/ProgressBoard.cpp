@@ -0,0 +1,43 @@
+/*! @file ProgressBoard.cpp ProgressBoard class implementation. */
+
+#include "ProgressBoard.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cstring>
+
+namespace Herd {
+
+ProgressBoard &ProgressBoard::Instance() {
+  static ProgressBoard board;
+  return board;
+}
+
+ProgressBoard::ProgressBoard() : _nslots{0} {
+  for (auto &slot : _slots) {
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.ns.store(0, std::memory_order_relaxed);
+    slot.ready.store(false, std::memory_order_relaxed);
+    slot.name[0] = '\0';
+  }
+}
+
+ProgressBoard::Slot *ProgressBoard::Acquire(const std::string &name) {
+  const unsigned int islot = _nslots.fetch_add(1, std::memory_order_acq_rel);
+  if (islot >= MaxSlots) {
+    _nslots.store(MaxSlots, std::memory_order_release);
+    return nullptr;
+  }
+  Slot &slot = _slots[islot];
+  const size_t length = std::min<size_t>(name.size(), MaxName - 1);
+  std::memcpy(slot.name, name.data(), length);
+  slot.name[length] = '\0';
+  slot.ready.store(true, std::memory_order_release);
+  return &slot;
+}
+
+unsigned int ProgressBoard::NSlots() const {
+  return std::min(_nslots.load(std::memory_order_acquire), MaxSlots);
+}
+
+} // namespace Herd
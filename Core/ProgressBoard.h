@@ -0,0 +1,54 @@
+/*! @file ProgressBoard.h ProgressBoard class declaration. */
+
+#ifndef HERD_PROGRESSBOARD_H_
+#define HERD_PROGRESSBOARD_H_
+
+// C/C++ standard headers
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Herd {
+
+/*! @brief Process-wide live counters of the timed algorithms, read by ProgressReporter during the run.
+ * @class ProgressBoard ProgressBoard.h
+ *
+ * Every ProcessTimer initialized with a name gets a slot, in initialization order (i.e. the order of the algorithms in
+ * the configuration). The timer is the only writer of its slot and publishes its totals with relaxed atomic stores
+ * after each call, which compile to plain stores: no lock and no read-modify-write on the timed path. Readers may see
+ * the calls and the time of slightly different calls, which is irrelevant for a progress report. Slots are never
+ * released, so a reader can walk them at any time; at most MaxSlots timers are tracked, the others are not shown.
+ * A slot is published by setting ready (release) once its name is written: readers must skip the slots which are not
+ * ready (acquire) yet. Each slot has its own cache line, so timers of different threads do not false-share.
+ */
+class ProgressBoard {
+public:
+  static const unsigned int MaxSlots = 128;
+  static const unsigned int MaxName = 64;
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> ns;
+    std::atomic<bool> ready; // name is written and the slot can be read
+    char name[MaxName];
+  };
+
+  static ProgressBoard &Instance();
+
+  /*! @brief A new slot for the named timer, with zero counters, or nullptr if all the slots are taken. */
+  Slot *Acquire(const std::string &name);
+
+  /*! @brief Number of slots handed out (the ones being acquired are not ready yet). */
+  unsigned int NSlots() const;
+  const Slot &GetSlot(unsigned int islot) const { return _slots[islot]; }
+
+private:
+  ProgressBoard();
+
+  Slot _slots[MaxSlots];
+  std::atomic<unsigned int> _nslots;
+};
+
+} // namespace Herd
+
+#endif /* HERD_PROGRESSBOARD_H_ */
@@ -0,0 +1,172 @@
+/*! @file ProgressReporter.cpp ProgressReporter class implementation. */
+
+#include "ProgressReporter.h"
+#include "ProgressBoard.h"
+
+// C/C++ standard headers
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace Herd {
+
+RegisterAlgorithm(ProgressReporter);
+
+namespace {
+
+//Resident set size in bytes, 0 if unknown
+uint64_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident)) return 0;
+  return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+std::string JsonString(const char *text) {
+  std::string quoted("\"");
+  for (const char *c = text; *c; c++) {
+    if (*c == '"' || *c == '\\') quoted += '\\';
+    if ((unsigned char)*c >= 0x20) quoted += *c;
+  }
+  return quoted + "\"";
+}
+
+} // namespace
+
+ProgressReporter::ProgressReporter(const std::string &name) :
+  Algorithm{name},
+  interval{10.},
+  output{""},
+  totalevents{0},
+  _startns{0},
+  _lastns{0},
+  _nextns{0},
+  _nevents{0},
+  _lastnevents{0},
+  perfcounters{false}
+   {
+    DefineParameter("interval", interval);
+    DefineParameter("output", output);
+    DefineParameter("totalevents", totalevents);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+bool ProgressReporter::Initialize() {
+  const std::string routineName("ProgressReporter::Initialize");
+
+  if( !(interval>0) ) { COUT(ERROR) << "interval must be positive" << ENDL; return false; }
+  if( totalevents<0 ) { COUT(ERROR) << "totalevents must not be negative" << ENDL; return false; }
+
+  _nevents = _lastnevents = 0;
+  _startns = _lastns = 0;
+  COUT(INFO) << "Reporting the progress every " << interval << " s to " << (output.empty() ? "stderr" : output) << ENDL;
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+  return true;
+}
+
+bool ProgressReporter::Process() {
+  ProcessScope timing(_timer);
+
+  const uint64_t now = MonotonicNs();
+  if( _nevents++ == 0 ){
+    _startns = _lastns = now;
+    _nextns = now + (uint64_t)(interval * 1e9);
+  }
+  else if( now >= _nextns ){
+    Report(false);
+  }
+
+  return true;
+}
+
+void ProgressReporter::Report(bool final) {
+  const uint64_t now = MonotonicNs();
+  const double elapsed = (now - _startns) * 1e-9, sincelast = (now - _lastns) * 1e-9;
+  const double rate = elapsed > 0 ? _nevents / elapsed : 0.;
+  const double lastrate = sincelast > 0 ? (_nevents - _lastnevents) / sincelast : 0.;
+  const bool knowntotal = totalevents > 0 && (unsigned long long)totalevents > _nevents;
+  const double eta = knowntotal && rate > 0 ? (totalevents - _nevents) / rate : 0.;
+  const uint64_t rss = ResidentBytes();
+
+  //Only the slots whose name is published; their names are not written any more
+  ProgressBoard &board = ProgressBoard::Instance();
+  std::vector<const ProgressBoard::Slot *> slots;
+  for (unsigned int islot = 0; islot < board.NSlots(); islot++)
+    if (board.GetSlot(islot).ready.load(std::memory_order_acquire)) slots.push_back(&board.GetSlot(islot));
+  const unsigned int nslots = slots.size();
+  std::vector<uint64_t> calls(nslots), ns(nslots);
+  uint64_t totns = 0;
+  for (unsigned int islot = 0; islot < nslots; islot++) {
+    calls[islot] = slots[islot]->calls.load(std::memory_order_relaxed);
+    ns[islot] = slots[islot]->ns.load(std::memory_order_relaxed);
+    totns += ns[islot];
+  }
+
+  std::ostringstream report;
+  if (output.empty()) {
+    report << std::fixed << std::setprecision(1) << "[" << GetName() << "] " << _nevents;
+    if (totalevents > 0) report << " / " << totalevents << " events (" << 100. * _nevents / totalevents << "%)";
+    else report << " events";
+    report << ", " << rate << " Hz (last " << sincelast << " s: " << lastrate << " Hz), elapsed " << elapsed << " s";
+    if (eta > 0) report << ", ETA " << eta << " s";
+    report << ", RSS " << rss / 1048576. << " MB" << (final ? " [final]" : "") << "\n";
+    report << "  " << std::left << std::setw(32) << "algorithm" << std::right << std::setw(14) << "calls" << std::setw(10)
+           << "reached" << std::setw(10) << "to next" << std::setw(10) << "time" << "\n";
+    for (unsigned int islot = 0; islot < nslots; islot++) {
+      report << "  " << std::left << std::setw(32) << slots[islot]->name << std::right << std::setw(14)
+             << calls[islot] << std::setw(9) << (_nevents ? 100. * calls[islot] / _nevents : 0.) << "%";
+      if (islot + 1 < nslots && calls[islot] > 0)
+        report << std::setw(9) << 100. * calls[islot + 1] / calls[islot] << "%";
+      else
+        report << std::setw(10) << "-";
+      report << std::setw(9) << (totns ? 100. * ns[islot] / totns : 0.) << "%\n";
+    }
+    std::cerr << report.str() << std::flush;
+  }
+  else {
+    report << std::setprecision(6) << "{\"name\": " << JsonString(GetName().c_str()) << ", \"final\": "
+           << (final ? "true" : "false") << ", \"events\": " << _nevents << ", \"totalevents\": " << totalevents
+           << ", \"elapsed_s\": " << elapsed << ", \"rate_hz\": " << rate << ", \"interval_rate_hz\": " << lastrate
+           << ", \"eta_s\": ";
+    if (eta > 0) report << eta; else report << "null";
+    report << ", \"rss_bytes\": " << rss << ",\n \"algorithms\": [";
+    for (unsigned int islot = 0; islot < nslots; islot++) {
+      report << (islot ? ",\n  " : "\n  ") << "{\"name\": " << JsonString(slots[islot]->name)
+             << ", \"calls\": " << calls[islot] << ", \"reached\": " << (_nevents ? (double)calls[islot] / _nevents : 0.)
+             << ", \"tonext\": ";
+      if (islot + 1 < nslots && calls[islot] > 0) report << (double)calls[islot + 1] / calls[islot]; else report << "null";
+      report << ", \"timeshare\": " << (totns ? (double)ns[islot] / totns : 0.) << "}";
+    }
+    report << "]}\n";
+
+    const std::string temporary = output + ".tmp";
+    std::ofstream out(temporary, std::ios::trunc);
+    if (out << report.str() && out.flush()) {
+      out.close();
+      std::rename(temporary.c_str(), output.c_str());
+    }
+  }
+
+  _lastns = now;
+  _lastnevents = _nevents;
+  _nextns = now + (uint64_t)(interval * 1e9);
+}
+
+bool ProgressReporter::Finalize() {
+  const std::string routineName("ProgressReporter::Finalize");
+
+  if (_nevents > 0) Report(true);
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+} // namespace Herd
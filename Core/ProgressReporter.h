@@ -0,0 +1,57 @@
+/*! @file ProgressReporter.h ProgressReporter class declaration. */
+
+#ifndef HERD_PROGRESSREPORTER_H_
+#define HERD_PROGRESSREPORTER_H_
+
+#include "algorithm/Algorithm.h"
+
+#include "ProcessTimer.h"
+
+// C/C++ standard headers
+#include <cstdint>
+#include <string>
+
+using namespace EA;
+
+namespace Herd {
+
+/*! @brief Periodic report of the progress of the run: rate, ETA, memory and the share of every algorithm.
+ * @class ProgressReporter ProgressReporter.h
+ *
+ * Put it first in the event loop. Every interval seconds it writes the events processed, the rate over the last
+ * interval and over the whole run, the ETA (with totalevents, the number of entries of the data list), the resident
+ * memory and, for every timed algorithm of the ProgressBoard (in configuration order): its calls, the fraction of the
+ * events reaching it, the fraction of them reaching the next algorithm (the accept fraction of a filter, when the next
+ * algorithm is in the same sequence) and its share of the time spent in the algorithms.
+ *
+ * The report goes to stderr if output is empty, otherwise to the JSON file output, rewritten at every report (through
+ * a temporary file and a rename, so a reader never sees a partial file). Between two reports Process only counts the
+ * event and reads the monotonic clock; the algorithm counters are read from the ProgressBoard without locks.
+ */
+class ProgressReporter : public Algorithm {
+public:
+  ProgressReporter(const std::string &name);
+
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  void Report(bool final);
+
+  // Algorithm parameters
+  float interval;         // Seconds between two reports
+  std::string output;     // JSON status file ("": text on stderr)
+  int totalevents;        // Events of the run, for the ETA (0: unknown)
+
+  uint64_t _startns, _lastns, _nextns;
+  unsigned long long _nevents, _lastnevents;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+};
+
+} // namespace Herd
+
+#endif /* HERD_PROGRESSREPORTER_H_ */
@@ -0,0 +1,72 @@
+/*! @file SphereGenerator.cpp SphereGenerator class implementation. */
+
+#include "SphereGenerator.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+
+namespace Herd {
+
+SphereGenerator::SphereGenerator()
+    : _radius{300.}, _index{-1.}, _mommin{1.}, _mommax{10.}, _lowpow{0.}, _rangepow{0.}, _logratio{std::log(10.)} {}
+
+bool SphereGenerator::Configure(double radius, double index, double mommin, double mommax, std::string &errmsg) {
+  if (!(radius > 0)) {
+    errmsg = "The generation radius must be positive";
+    return false;
+  }
+  if (!(mommin > 0) || !(mommax > mommin)) {
+    errmsg = "Invalid momentum range {" + std::to_string(mommin) + ", " + std::to_string(mommax) + "}";
+    return false;
+  }
+  _radius = radius;
+  _index = index;
+  _mommin = mommin;
+  _mommax = mommax;
+  _logratio = std::log(mommax / mommin);
+  if (std::fabs(index + 1.) >= 1e-9) {
+    _lowpow = std::pow(mommin, index + 1.);
+    _rangepow = std::pow(mommax, index + 1.) - _lowpow;
+  }
+  return true;
+}
+
+double SphereGenerator::Momentum(double u) const {
+  //Inverse of the cumulative distribution of the power law
+  if (std::fabs(_index + 1.) < 1e-9) return _mommin * std::exp(u * _logratio);
+  return std::pow(_lowpow + u * _rangepow, 1. / (_index + 1.));
+}
+
+void SphereGenerator::Generate(double position[3], double momentum[3]) {
+  double u[5];
+  for (auto &value : u) value = _random.Uniform();
+  Map(u, position, momentum);
+}
+
+void SphereGenerator::Map(const double u[5], double position[3], double momentum[3]) const {
+
+  //Uniform point on the sphere
+  const double costheta = 1. - 2. * u[0];
+  const double sintheta = std::sqrt(std::max(0., 1. - costheta * costheta));
+  const double phi = 2. * M_PI * u[1];
+  const double cosphi = std::cos(phi), sinphi = std::sin(phi);
+  const double radial[3] = {sintheta * cosphi, sintheta * sinphi, costheta};
+
+  //Inward direction, cosine law around the normal: cos(alpha) = sqrt(u)
+  const double cosalpha = std::sqrt(u[2]);
+  const double sinalpha = std::sqrt(1. - cosalpha * cosalpha);
+  const double beta = 2. * M_PI * u[3];
+  const double a = sinalpha * std::cos(beta), b = sinalpha * std::sin(beta);
+  //Unit vectors of the polar and azimuthal directions at the point, both orthogonal to the normal
+  const double polar[3] = {costheta * cosphi, costheta * sinphi, -sintheta};
+  const double azimuthal[3] = {-sinphi, cosphi, 0.};
+
+  const double p = Momentum(u[4]);
+  for (int i = 0; i < 3; i++) {
+    position[i] = _radius * radial[i];
+    momentum[i] = p * (-cosalpha * radial[i] + a * polar[i] + b * azimuthal[i]);
+  }
+}
+
+} // namespace Herd
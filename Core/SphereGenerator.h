@@ -0,0 +1,60 @@
+/*! @file SphereGenerator.h SphereGenerator class declaration. */
+
+#ifndef HERD_SPHEREGENERATOR_H_
+#define HERD_SPHEREGENERATOR_H_
+
+#include "Utils/FastRandom.h"
+
+// C/C++ standard headers
+#include <cstdint>
+#include <string>
+
+namespace Herd {
+
+/*! @brief Primaries of an isotropic flux through a generation sphere.
+ * @class SphereGenerator SphereGenerator.h
+ *
+ * The starting points are uniform on a sphere centred in the origin and the directions point inward with a cosine law
+ * around the normal, which is the flux crossing the sphere for an isotropic distribution outside it: the acceptance is
+ * then (selected / generated) * pi * 4 pi R^2, as in ROOT_Macro/buildAcceptance/plotAcceptance.cpp. The momentum
+ * follows dN/dp ~ p^index in [min, max], the spectrum assumed by mcGenSpectrum (index = -1 is log-uniform).
+ */
+class SphereGenerator {
+public:
+  SphereGenerator();
+
+  /*! @brief Sets the generation parameters.
+   *
+   * @param radius Radius of the generation sphere (cm).
+   * @return false if the radius is not positive or the momentum range is invalid.
+   */
+  bool Configure(double radius, double index, double mommin, double mommax, std::string &errmsg);
+
+  void Seed(uint64_t seed) { _random.Seed(seed); }
+
+  /*! @brief Generates a primary: starting position (cm) and momentum (GeV/c). */
+  void Generate(double position[3], double momentum[3]);
+
+  /*! @brief The primary given by five uniform numbers in [0, 1), for external (e.g. counter-based) generators.
+   *
+   * u[0] and u[1] set the point on the sphere, u[2] and u[3] the direction and u[4] the momentum.
+   */
+  void Map(const double u[5], double position[3], double momentum[3]) const;
+
+  /*! @brief Uniform in [0, 1) from the same stream, for the other random quantities of the event. */
+  double Uniform() { return _random.Uniform(); }
+
+private:
+  double Momentum(double u) const;
+
+  Xoshiro256 _random;
+  double _radius;
+  double _index;
+  double _mommin, _mommax;
+  double _lowpow, _rangepow; // min^(index+1) and max^(index+1) - min^(index+1)
+  double _logratio;          // log(max/min)
+};
+
+} // namespace Herd
+
+#endif /* HERD_SPHEREGENERATOR_H_ */
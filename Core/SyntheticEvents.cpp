@@ -0,0 +1,121 @@
+/*! @file SyntheticEvents.cpp SyntheticEvents class implementation. */
+
+#include "SyntheticEvents.h"
+
+// HerdSoftware headers
+#include "dataobjects/CaloGeoParams.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+
+namespace Herd {
+
+RegisterAlgorithm(SyntheticEvents);
+
+SyntheticEvents::SyntheticEvents(const std::string &name) :
+  Algorithm{name},
+  radius{300.},
+  index{-1.},
+  momrange{10., 10000.},
+  pdgcode{11},
+  seed{1},
+  calohits{0},
+  _nevents{0},
+  perfcounters{false}
+   {
+    DeclareProducedObject("mcTruth", ObjectCategory::EVENT, "evStore");
+    DeclareProducedObject("caloHitsMC", ObjectCategory::EVENT, "evStore");
+
+    DefineParameter("radius", radius);
+    DefineParameter("index", index);
+    DefineParameter("momrange", momrange);
+    DefineParameter("pdgcode", pdgcode);
+    DefineParameter("seed", seed);
+    DefineParameter("calohits", calohits);
+    DefineParameter("perfcounters", perfcounters);
+  }
+
+bool SyntheticEvents::Initialize() {
+  const std::string routineName("SyntheticEvents::Initialize");
+
+  _evStore = GetDataStoreManager()->GetEventDataStore("evStore"); if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
+
+  std::string errmsg;
+  if( momrange.size()!=2 ) { COUT(ERROR) << "momrange must be {min, max}" << ENDL; return false; }
+  if( !_generator.Configure(radius, index, momrange[0], momrange[1], errmsg) ) { COUT(ERROR) << errmsg << ENDL; return false; }
+  _generator.Seed(seed);
+
+  _mctruth.Init([]() { auto mctruth = std::make_shared<MCTruth>(); mctruth->primaries.resize(1); return mctruth; },
+                [](MCTruth &mctruth) { mctruth.nDiscarded = 0; });
+
+  if( calohits>0 ){
+    auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+    if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+    auto caloGeoParams = globStore->GetObject<CaloGeoParams>("caloGeoParams"); if (!caloGeoParams) { COUT(ERROR) << "caloGeoParams not found." << ENDL; return false; }
+    if( !_lattice.Build(*caloGeoParams) ) { COUT(ERROR) << "Calo cubes cannot be mapped on a regular lattice." << ENDL; return false; }
+    const int nhits = calohits;
+    _calohits.Init([nhits]() { auto hits = std::make_shared<CaloHits>(); hits->reserve(nhits); return hits; },
+                   [](CaloHits &hits) { hits.clear(); });
+  }
+
+  _nevents = 0;
+  COUT(INFO) << "Generating on a sphere of radius " << radius << " cm, p^" << index << " in {" << momrange[0] << ", " << momrange[1] << "} GeV/c" << ENDL;
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+  return true;
+}
+
+bool SyntheticEvents::Process() {
+  static const std::string routineName("SyntheticEvents::Process");
+  ProcessScope timing(_timer);
+
+  //Replace the objects of the data provider, if any
+  static const std::string mctruthname("mcTruth"), calohitsname("caloHitsMC");
+  observer_ptr<MCTruth> provided = _evStore->GetObject<MCTruth>(mctruthname);
+  std::shared_ptr<MCTruth> added;
+  if( !provided ){ added = _mctruth.Acquire(); _evStore->AddObject(mctruthname, added); }
+  MCTruth &mctruth = provided ? *provided : *added;
+
+  double position[3], momentum[3];
+  _generator.Generate(position, momentum);
+  mctruth.primaries.resize(1);
+  MCParticle &primary = mctruth.primaries[0];
+  primary.initialPosition = Point(position[0], position[1], position[2]);
+  primary.initialMomentum = Momentum(momentum[0], momentum[1], momentum[2]);
+  primary.PDGCode = pdgcode;
+  mctruth.nDiscarded = 0;
+  _nevents++;
+
+  if( calohits>0 ){
+    observer_ptr<CaloHits> providedhits = _evStore->GetObject<CaloHits>(calohitsname);
+    std::shared_ptr<CaloHits> addedhits;
+    if( !providedhits ){ addedhits = _calohits.Acquire(); _evStore->AddObject(calohitsname, addedhits); }
+    CaloHits &hits = providedhits ? *providedhits : *addedhits;
+
+    //Random walk through touching cubes, the energy shared evenly on average
+    const float pmag = std::sqrt(momentum[0]*momentum[0] + momentum[1]*momentum[1] + momentum[2]*momentum[2]);
+    const float edep = 0.9f * pmag / calohits;
+    unsigned int cube = std::min(_lattice.NCubes()-1, (unsigned int)(_generator.Uniform() * _lattice.NCubes()));
+    hits.clear();
+    for(int ihit=0; ihit<calohits; ihit++){
+      hits.emplace_back(cube, (float)(edep * 2. * _generator.Uniform()));
+      const int nneighbours = _lattice.NNeighbours(cube);
+      if( nneighbours>0 ) cube = _lattice.Neighbours(cube)[std::min(nneighbours-1, (int)(_generator.Uniform() * nneighbours))];
+    }
+  }
+
+  return true;
+}
+
+bool SyntheticEvents::Finalize() {
+  const std::string routineName("SyntheticEvents::Finalize");
+
+  COUT(INFO) << "Generated " << _nevents << " events" << ENDL;
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,87 @@
+/*! @file SyntheticEvents.h SyntheticEvents class declaration. */
+
+#ifndef HERD_SYNTHETICEVENTS_H_
+#define HERD_SYNTHETICEVENTS_H_
+
+#include "algorithm/Algorithm.h"
+
+// HerdSoftware headers
+#include "dataobjects/CaloHits.h"
+#include "dataobjects/MCTruth.h"
+
+#include "Calo/CaloLattice.h"
+#include "ProcessTimer.h"
+#include "SphereGenerator.h"
+#include "Utils/StorePool.h"
+
+// C/C++ standard headers
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace EA;
+
+namespace Herd {
+
+/*! @brief Fills the event with a synthetic primary, to measure the throughput of the algorithms without a production.
+ * @class SyntheticEvents SyntheticEvents.h
+ *
+ * Each event gets one primary from a SphereGenerator: isotropic flux through the generation sphere of the given
+ * radius, momentum spectrum p^index in momrange (the same parameters as mcGenSpectrum, so the acceptance of a
+ * synthetic run is normalized as for a production). With calohits > 0 a shower-like set of Calo hits is added too: a
+ * random walk of calohits steps through touching cubes from a random cube, sharing 90% of the primary momentum.
+ *
+ * Put first in the event loop: if the data provider already filled mcTruth (or caloHitsMC) the content is replaced,
+ * otherwise the objects are added, so the data list only sets the number of events. The added objects come from a
+ * StorePool, so every event gets objects of its own and the generation does not allocate; it runs at several million
+ * events per second.
+ *
+ * The event loop is still driven by the data provider of the configuration: it reads its input files for every event
+ * as in a production, and that I/O is part of the wall-clock time of the job. The Process() timings of the algorithms
+ * (see ProcessTimer) do not include it, so compare those, not the job time, when measuring the algorithms.
+ *
+ * <B>Produced event objects:</B>
+ *
+ *   name               |     type          |  store      | description
+ * ---------------------|-------------------|-------------|-------------------------
+ * mcTruth              | MCTruth           | evStore     | The synthetic primary
+ * caloHitsMC           | CaloHits          | evStore     | Synthetic Calo hits (only with calohits > 0)
+ *
+ * <B>Needed global objects (only with calohits > 0):</B>
+ *
+ *   name               |     type          |  store      | description
+ * ---------------------|-------------------|-------------|-------------------------
+ * caloGeoParams        | CaloGeoParams     | globStore   | Calo geometry
+ */
+class SyntheticEvents : public Algorithm {
+public:
+  SyntheticEvents(const std::string &name);
+
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  // Algorithm parameters
+  float radius;                 // Radius of the generation sphere (cm)
+  double index;                 // Generation spectrum dN/dp ~ p^index (-1: log-uniform)
+  std::vector<double> momrange; // Generation momentum range (GeV/c)
+  int pdgcode;                  // PDG code of the primaries
+  int seed;
+  int calohits;                 // Calo hits per event (0: no caloHitsMC)
+
+  SphereGenerator _generator;
+  CaloLattice _lattice;
+  StorePool<MCTruth> _mctruth;   // An mcTruth of its own for every event, without allocating
+  StorePool<CaloHits> _calohits; // A caloHitsMC of its own for every event, without allocating
+  unsigned long long _nevents;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+} // namespace Herd
+
+#endif /* HERD_SYNTHETICEVENTS_H_ */
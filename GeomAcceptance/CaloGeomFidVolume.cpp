@@ -12,6 +12,7 @@
 #include "dataobjects/Point.h"
 #include "math.h"
 #include "CaloGeomFidVolume.h"
+#include "Core/AcceptanceEvent.h"
 
 // C/C++ standard headers
 #include <numeric>
@@ -27,7 +28,7 @@ RegisterAlgorithm(CaloGeomFidVolumeStore);
 
 CaloGeomFidVolumeAlgo::CaloGeomFidVolumeAlgo(const std::string &name)
     : Algorithm{name}, _XSideBig(79), _XSideSmall(33.4), _YSideBig(73.2), _YSideSmall(32.4), _ZCaloCenter(-36.6),
-      _ZCaloHeight(73.2), _phiXY(atan2(-(-_XSideBig + _XSideSmall), (-_YSideSmall + _YSideBig))),alpha(1.),checkext{true},checkint{false},filterenable{true}
+      _ZCaloHeight(73.2), _phiXY(atan2(-(-_XSideBig + _XSideSmall), (-_YSideSmall + _YSideBig))),alpha(1.),checkext{true},checkint{false},filterenable{true},deferred{false},perfcounters{false}
       //_meanActiveFractionZview(0.8606557), _meanActiveFractionXview(0.7974684), _meanActiveFractionYview(0.8606557),
       //_meanVolumeActiveFraction(0.569861492), _LYSO_X0(1.1) 
       {
@@ -39,6 +40,10 @@ CaloGeomFidVolumeAlgo::CaloGeomFidVolumeAlgo(const std::string &name)
   DefineParameter("filterenable", filterenable);
   DefineParameter("checkext", checkext);
   DefineParameter("checkint", checkint);
+  DefineParameter("deferred", deferred);
+  DefineParameter("perfcounters", perfcounters);
+
+  _processname = GetName() + "::Process";
 
 
 
@@ -53,8 +58,6 @@ bool CaloGeomFidVolumeAlgo::Initialize() {
   _evStore = GetDataStoreManager()->GetEventDataStore("evStore");
   if (!_evStore) { COUT(ERROR) << "Event data store not found." << ENDL; return false; }
 
-  _processstore = std::make_shared<CaloGeomFidVolumeStore>("caloGeomFidVolumeStore");
-  COUT(INFO) << "InitializedProcessStore::" <<_processstore << ENDL;
 
 auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
   if (!globStore) {COUT(ERROR) << "Global data store not found." << ENDL;}
@@ -174,33 +177,56 @@ auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
    COUT(INFO)<<"qXposYpos::"<<qXPOSYPOS<<ENDL;
 */
 
+  if(deferred) KernelRegistry::Instance().Register(GetName(), this);
+
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+  _processstores.Init("caloGeomFidVolumeStore");
+
   return true;
 }
 
 bool CaloGeomFidVolumeAlgo::Process() {
 
-    if(checkext) return CheckExt();
-    if(checkint) return CheckInt();
-    return true;
-}
-
-bool CaloGeomFidVolumeAlgo::CheckExt() {
+  const std::string &routineName = _processname;
+  ProcessScope timing(_timer);
 
-  const std::string routineName = GetName() + "::Process";
+  //Set Filter Status
+  SetFilterResult(FilterResult::ACCEPT);
+  if(deferred || !(checkext || checkint)) return true;
 
   //Add the ProcessStore object for this event to the event data store
-  //_processstore->Reset();
-  _evStore->AddObject("caloGeomFidVolumeStore",_processstore);
+  static const std::string processstorename("caloGeomFidVolumeStore");
+  auto processstore = _processstores.Acquire();
+  _evStore->AddObject(processstorename,processstore);
 
-  //Set Filter Status
-  SetFilterResult(FilterResult::ACCEPT);
+  AcceptanceEvent event;
+  if (!LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), event)) {COUT(ERROR) << "mcTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;return false;}
+
+  if( !Evaluate(event, *processstore) ) SetFilterResult(FilterResult::REJECT);
+  return true;
+}
 
-  auto mcTruth = _evStore->GetObject<MCTruth>("mcTruth");
-  if (!mcTruth) {COUT(ERROR) << "mcTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;return false;}
-  const Momentum &Mom = mcTruth->primaries[0].initialMomentum;
-  const Point &Pos    = mcTruth->primaries[0].initialPosition;
+bool CaloGeomFidVolumeAlgo::ProcessEvent(const AcceptanceEvent &event) {
+  if( !(checkext || checkint) ) return true;
+  //Scratch store of the calling thread, its content is not used
+  thread_local CaloGeomFidVolumeStore processstore("caloGeomFidVolumeStore");
+  processstore.Reset();
+  return Evaluate(event, processstore) || !filterenable;
+}
+
+bool CaloGeomFidVolumeAlgo::Evaluate(const AcceptanceEvent &event, CaloGeomFidVolumeStore &store) {
+  const Momentum Mom(event.momentum[0], event.momentum[1], event.momentum[2]);
+  const Point Pos(event.position[0], event.position[1], event.position[2]);
   Line track(Pos, Mom);
 
+  if(checkext) return CheckExt(track, store, event.index);
+  return CheckInt(track, store, event.index);
+}
+
+bool CaloGeomFidVolumeAlgo::CheckExt(const Line &track, CaloGeomFidVolumeStore &store, unsigned long long eventindex) {
+
+  const std::string &routineName = _processname;
+
   //Build additional planes
   Plane PlaneX6 (Point( -_XSideSmall/2., 0., _ZCaloCenter), M_PI / 2., M_PI);          //verify these angles...
   Plane PlaneX14(Point( +_XSideSmall/2., 0., _ZCaloCenter), M_PI / 2., 0);             //verify these angles...
@@ -223,63 +249,62 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
   Point intZneg = plane[RefFrame::Direction::Zneg].Intersection(track);
   Point intZpos = plane[RefFrame::Direction::Zpos].Intersection(track);
   
-  _processstore->calofidvolpass=true;
-  _processstore->calofidvolalpha=alpha;
+  store.calofidvolpass=true;
+  store.calofidvolalpha=alpha;
 
 //LATERAL CAP CHECK: XPOS
   int nintXpos=0;
   if( intXpos[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&   
       intXpos[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
       intXpos[RefFrame::Coo::Z] > -_ZCaloHeight                    &&   
-      intXpos[RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intXpos,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intXpos[RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intXpos,store.calofidvolxposEntry,nintXpos-1); }
   if( intZpos[RefFrame::Coo::X] < +_XSideBig/2.                    &&   
       intZpos[RefFrame::Coo::X] > +_XSideBig/2.  - alpha*cubeside  &&   
       intZpos[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
-      intZpos[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXpos++; FillCoo(intZpos,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intZpos[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXpos++; FillCoo(intZpos,store.calofidvolxposEntry,nintXpos-1); }
   if( intZneg[RefFrame::Coo::X] < +_XSideBig/2.                    &&
       intZneg[RefFrame::Coo::X] > +_XSideBig/2.  - alpha*cubeside  &&   
       intZneg[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
-      intZneg[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXpos++; FillCoo(intZneg,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intZneg[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXpos++; FillCoo(intZneg,store.calofidvolxposEntry,nintXpos-1); }
   if( intY6  [RefFrame::Coo::X] < +_XSideBig/2.                    &&   
       intY6  [RefFrame::Coo::X] > +_XSideBig/2.  - alpha*cubeside  &&
       intY6  [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intY6  [RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intY6,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intY6  [RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intY6,store.calofidvolxposEntry,nintXpos-1); }
   if( intY14 [RefFrame::Coo::X] < +_XSideBig/2.                    &&   
       intY14 [RefFrame::Coo::X] > +_XSideBig/2.  - alpha*cubeside  &&
       intY14 [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intY14 [RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intY14,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intY14 [RefFrame::Coo::Z] < 0.                              ) { nintXpos++; FillCoo(intY14,store.calofidvolxposEntry,nintXpos-1); }
   if( nintXpos >  2) {COUT(ERROR)<<"intXpos>2"<<ENDL;} //}return false;}    
   if( nintXpos == 2) {    
-    _processstore->calofidvolxpos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxpos=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxpos=0;} 
+    {store.calofidvolxpos=0;} 
 
   //LATERAL CAP CHECK: XNEG
   int nintXneg=0;
   if( intXneg[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&   
       intXneg[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
       intXneg[RefFrame::Coo::Z] > -_ZCaloHeight                    &&   
-      intXneg[RefFrame::Coo::Z] < 0.                              ) { nintXneg++; FillCoo(intXneg,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intXneg[RefFrame::Coo::Z] < 0.                              ) { nintXneg++; FillCoo(intXneg,store.calofidvolxnegEntry,nintXneg-1); }
   if( intZpos[RefFrame::Coo::X] < -_XSideBig/2. +  alpha*cubeside  &&   
       intZpos[RefFrame::Coo::X] > -_XSideBig/2.                    &&   
       intZpos[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
-      intZpos[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXneg++; FillCoo(intZpos,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intZpos[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXneg++; FillCoo(intZpos,store.calofidvolxnegEntry,nintXneg-1); }
   if( intZneg[RefFrame::Coo::X] < -_XSideBig/2. +  alpha*cubeside  &&   
       intZneg[RefFrame::Coo::X] > -_XSideBig/2.                    &&   
       intZneg[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&   
-      intZneg[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXneg++; FillCoo(intZneg,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intZneg[RefFrame::Coo::Y] < +_YSideSmall/2.                    ) { nintXneg++; FillCoo(intZneg,store.calofidvolxnegEntry,nintXneg-1); }
   if( intY6  [RefFrame::Coo::X] < -_XSideBig/2. +  alpha*cubeside  &&   
       intY6  [RefFrame::Coo::X] > -_XSideBig/2.                    &&   
       intY6  [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intY6  [RefFrame::Coo::Z] < 0.                              ) {  nintXneg++; FillCoo(intY6,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intY6  [RefFrame::Coo::Z] < 0.                              ) {  nintXneg++; FillCoo(intY6,store.calofidvolxnegEntry,nintXneg-1); }
   if( intY14 [RefFrame::Coo::X] < -_XSideBig/2. +  alpha*cubeside  &&   
       intY14 [RefFrame::Coo::X] > -_XSideBig/2.                    &&   
       intY14 [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intY14 [RefFrame::Coo::Z] < 0.                              ) { nintXneg++; FillCoo(intY14,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intY14 [RefFrame::Coo::Z] < 0.                              ) { nintXneg++; FillCoo(intY14,store.calofidvolxnegEntry,nintXneg-1); }
   if( nintXneg >  2) {COUT(ERROR)<<"intXneg>2"<<ENDL; 
-    COUT(ERROR)<<GetEventLoopProxy()->GetCurrentEvent()<<ENDL;
+    COUT(ERROR)<<eventindex<<ENDL;
     COUT(ERROR)<<nintXneg<<ENDL;
     COUT(ERROR)<<intXneg[RefFrame::Coo::X]<<" "<<intXneg[RefFrame::Coo::Y]<<" "<<intXneg[RefFrame::Coo::Z]<<ENDL;
     COUT(ERROR)<<intZpos[RefFrame::Coo::X]<<" "<<intZpos[RefFrame::Coo::Y]<<" "<<intZpos[RefFrame::Coo::Z]<<ENDL;
@@ -289,41 +314,39 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
   }
   //return false;}    
   if( nintXneg == 2) {
-    _processstore->calofidvolxneg=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxneg=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxneg=0;}
+    {store.calofidvolxneg=0;}
     
 //LATERAL CAP CHECK: YPOS
   int nintYpos=0;
   if( intYpos[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intYpos[RefFrame::Coo::X] > -_XSideSmall/2.                  &&   
       intYpos[RefFrame::Coo::Z] > -_ZCaloHeight                    &&   
-      intYpos[RefFrame::Coo::Z] < 0.                              )  { nintYpos++; FillCoo(intYpos,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intYpos[RefFrame::Coo::Z] < 0.                              )  { nintYpos++; FillCoo(intYpos,store.calofidvolyposEntry,nintYpos-1); }
   if( intZpos[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intZpos[RefFrame::Coo::X] > -_XSideSmall/2.                  &&     
       intZpos[RefFrame::Coo::Y] < +_YSideBig/2.                    &&   
-      intZpos[RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside    ) { nintYpos++; FillCoo(intZpos,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intZpos[RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside    ) { nintYpos++; FillCoo(intZpos,store.calofidvolyposEntry,nintYpos-1); }
   if( intZneg[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intZneg[RefFrame::Coo::X] > -_XSideSmall/2.                  &&     
       intZneg[RefFrame::Coo::Y] < +_YSideBig/2.                    &&   
-      intZneg[RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside    ) { nintYpos++; FillCoo(intZneg,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intZneg[RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside    ) { nintYpos++; FillCoo(intZneg,store.calofidvolyposEntry,nintYpos-1); }
   if( intX6  [RefFrame::Coo::Y] < +_YSideBig/2.                    &&   
       intX6  [RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside  &&
       intX6  [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intX6  [RefFrame::Coo::Z] < 0.                              ) { nintYpos++; FillCoo(intX6,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intX6  [RefFrame::Coo::Z] < 0.                              ) { nintYpos++; FillCoo(intX6,store.calofidvolyposEntry,nintYpos-1); }
   if( intX14 [RefFrame::Coo::Y] < +_YSideBig/2.                    &&  
       intX14 [RefFrame::Coo::Y] > +_YSideBig/2. -  alpha*cubeside  &&
       intX14 [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intX14 [RefFrame::Coo::Z] < 0.                              ) { nintYpos++; FillCoo(intX14,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intX14 [RefFrame::Coo::Z] < 0.                              ) { nintYpos++; FillCoo(intX14,store.calofidvolyposEntry,nintYpos-1); }
   if( nintYpos >  2) {COUT(ERROR)<<"intYpos>2"<<ENDL;}// return false;}    
   if( nintYpos == 2) {
-    _processstore->calofidvolypos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolypos=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolypos=0;}
+    {store.calofidvolypos=0;}
 
 
   
@@ -332,30 +355,29 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
   if( intYneg[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intYneg[RefFrame::Coo::X] > -_XSideSmall/2.                  &&   
       intYneg[RefFrame::Coo::Z] > -_ZCaloHeight                    &&   
-      intYneg[RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intYneg,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intYneg[RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intYneg,store.calofidvolynegEntry,nintYneg-1); }
   if( intZpos[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intZpos[RefFrame::Coo::X] > -_XSideSmall/2.                  &&     
       intZpos[RefFrame::Coo::Y] > -_YSideBig/2.                    &&   
-      intZpos[RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside    ) { nintYneg++; FillCoo(intZpos,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intZpos[RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside    ) { nintYneg++; FillCoo(intZpos,store.calofidvolynegEntry,nintYneg-1); }
   if( intZneg[RefFrame::Coo::X] < +_XSideSmall/2.                  &&   
       intZneg[RefFrame::Coo::X] > -_XSideSmall/2.                  &&     
       intZneg[RefFrame::Coo::Y] > -_YSideBig/2.                    &&   
-      intZneg[RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside    ) { nintYneg++; FillCoo(intZneg,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intZneg[RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside    ) { nintYneg++; FillCoo(intZneg,store.calofidvolynegEntry,nintYneg-1); }
   if( intX6  [RefFrame::Coo::Y] > -_YSideBig/2.                    &&   
       intX6  [RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside  &&   
       intX6  [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intX6  [RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intX6,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intX6  [RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intX6,store.calofidvolynegEntry,nintYneg-1); }
   if( intX14 [RefFrame::Coo::Y] > -_YSideBig/2.                    &&   
       intX14 [RefFrame::Coo::Y] < -_YSideBig/2. +  alpha*cubeside  &&    
       intX14 [RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intX14 [RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intX14,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intX14 [RefFrame::Coo::Z] < 0.                              ) { nintYneg++; FillCoo(intX14,store.calofidvolynegEntry,nintYneg-1); }
   if( nintYneg >  2) {COUT(ERROR)<<"intYneg>2"<<ENDL;}// return false;}    
   if( nintYneg == 2) {    
-    _processstore->calofidvolyneg=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolyneg=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolyneg=0;} 
+    {store.calofidvolyneg=0;} 
 
 //TOP CAP CHECK: ZPOS
   // Assume an octagon
@@ -367,54 +389,53 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
       intZpos[RefFrame::Coo::Y] < mXNEGYPOS * intZpos[RefFrame::Coo::X] + qXNEGYPOS  &&
       intZpos[RefFrame::Coo::Y] < mXPOSYPOS * intZpos[RefFrame::Coo::X] + qXPOSYPOS  &&
       intZpos[RefFrame::Coo::Y] > mXPOSYNEG * intZpos[RefFrame::Coo::X] + qXPOSYNEG  &&
-      intZpos[RefFrame::Coo::Y] > mXNEGYNEG * intZpos[RefFrame::Coo::X] + qXNEGYNEG     ) { nintZpos++; FillCoo(intZpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intZpos[RefFrame::Coo::Y] > mXNEGYNEG * intZpos[RefFrame::Coo::X] + qXNEGYNEG     ) { nintZpos++; FillCoo(intZpos,store.calofidvolzposEntry,nintZpos-1); }    
   if( intYneg[RefFrame::Coo::X] > -_XSideSmall/2.                  &&
       intYneg[RefFrame::Coo::X] < +_XSideSmall/2.                  &&
       intYneg[RefFrame::Coo::Z] < 0                                &&
-      intYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intYneg,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intYneg,store.calofidvolzposEntry,nintZpos-1); }    
   if( intYpos[RefFrame::Coo::X] > -_XSideSmall/2.                  &&
       intYpos[RefFrame::Coo::X] < +_XSideSmall/2.                  &&
       intYpos[RefFrame::Coo::Z] < 0                                &&
-      intYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intYpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intYpos,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXneg[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&
       intXneg[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&
       intXneg[RefFrame::Coo::Z] < 0                                &&
-      intXneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intXneg,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intXneg,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXpos[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&
       intXpos[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&
       intXpos[RefFrame::Coo::Z] < 0                                &&
-      intXpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intXpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                    ) { nintZpos++; FillCoo(intXpos,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXposYneg[RefFrame::Coo::X] > +_XSideSmall/2.              &&
       intXposYneg[RefFrame::Coo::X] < +_XSideBig/2.                &&
       intXposYneg[RefFrame::Coo::Y] > -_YSideBig/2.                &&
       intXposYneg[RefFrame::Coo::Y] < -_YSideSmall/2.              &&
       intXposYneg[RefFrame::Coo::Z] < 0                            &&
-      intXposYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXposYneg,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXposYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXposYneg,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXnegYneg[RefFrame::Coo::X] > -_XSideBig/2.                &&
       intXnegYneg[RefFrame::Coo::X] < -_XSideSmall/2.              &&
       intXnegYneg[RefFrame::Coo::Y] > -_YSideBig/2.                &&
       intXnegYneg[RefFrame::Coo::Y] < -_YSideSmall/2.              &&
       intXnegYneg[RefFrame::Coo::Z] < 0                            &&
-      intXnegYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXnegYneg,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXnegYneg[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXnegYneg,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXnegYpos[RefFrame::Coo::X] > -_XSideBig/2.                &&
       intXnegYpos[RefFrame::Coo::X] < -_XSideSmall/2.              &&
       intXnegYpos[RefFrame::Coo::Y] > +_YSideSmall/2.              &&
       intXnegYpos[RefFrame::Coo::Y] < +_YSideBig/2.                &&
       intXnegYpos[RefFrame::Coo::Z] < 0                            &&
-      intXnegYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXnegYpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXnegYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXnegYpos,store.calofidvolzposEntry,nintZpos-1); }    
   if( intXposYpos[RefFrame::Coo::X] > +_XSideSmall/2.                &&
       intXposYpos[RefFrame::Coo::X] < +_XSideBig/2.              &&
       intXposYpos[RefFrame::Coo::Y] > +_YSideSmall/2.              &&
       intXposYpos[RefFrame::Coo::Y] < +_YSideBig/2.                &&
       intXposYpos[RefFrame::Coo::Z] < 0                            &&
-      intXposYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXposYpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intXposYpos[RefFrame::Coo::Z] > 0 - alpha*cubeside                                ) { nintZpos++; FillCoo(intXposYpos,store.calofidvolzposEntry,nintZpos-1); }    
   if( nintZpos >  2) {COUT(ERROR)<<"intZpos>2"<<ENDL;}// return false;}     
   if( nintZpos == 2) {
-    _processstore->calofidvolzpos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolzpos=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolzpos=0;} 
+    {store.calofidvolzpos=0;} 
   
 //BOTTOM CAP CHECK: ZNEG
   // Assume an octagon
@@ -426,114 +447,111 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
       intZneg[RefFrame::Coo::Y] < mXNEGYPOS * intZneg[RefFrame::Coo::X] + qXNEGYPOS  &&
       intZneg[RefFrame::Coo::Y] < mXPOSYPOS * intZneg[RefFrame::Coo::X] + qXPOSYPOS  &&
       intZneg[RefFrame::Coo::Y] > mXPOSYNEG * intZneg[RefFrame::Coo::X] + qXPOSYNEG  &&
-      intZneg[RefFrame::Coo::Y] > mXNEGYNEG * intZneg[RefFrame::Coo::X] + qXNEGYNEG     ) { nintZneg++; FillCoo(intZneg,_processstore->calofidvolznegEntry,nintZneg-1); }      
+      intZneg[RefFrame::Coo::Y] > mXNEGYNEG * intZneg[RefFrame::Coo::X] + qXNEGYNEG     ) { nintZneg++; FillCoo(intZneg,store.calofidvolznegEntry,nintZneg-1); }      
   if( intYneg[RefFrame::Coo::X] > -_XSideSmall/2.                  &&
       intYneg[RefFrame::Coo::X] < +_XSideSmall/2.                  &&
       intYneg[RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                        ) { nintZneg++; FillCoo(intYneg,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                        ) { nintZneg++; FillCoo(intYneg,store.calofidvolznegEntry,nintZneg-1); }   
   if( intYpos[RefFrame::Coo::X] > -_XSideSmall/2.                  &&
       intYpos[RefFrame::Coo::X] < +_XSideSmall/2.                  &&
       intYpos[RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intYpos,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intYpos,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXneg[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&
       intXneg[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&
       intXneg[RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intXneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intXneg,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intXneg,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXpos[RefFrame::Coo::Y] > -_YSideSmall/2.                  &&
       intXpos[RefFrame::Coo::Y] < +_YSideSmall/2.                  &&
       intXpos[RefFrame::Coo::Z] > -_ZCaloHeight                    &&
-      intXpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intXpos,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                      ) { nintZneg++; FillCoo(intXpos,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXposYneg[RefFrame::Coo::X] > +_XSideSmall/2.              &&
       intXposYneg[RefFrame::Coo::X] < +_XSideBig/2.                &&
       intXposYneg[RefFrame::Coo::Y] > -_YSideBig/2.                &&
       intXposYneg[RefFrame::Coo::Y] < -_YSideSmall/2.              &&
       intXposYneg[RefFrame::Coo::Z] > -_ZCaloHeight                &&
-      intXposYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXposYneg,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXposYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXposYneg,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXnegYneg[RefFrame::Coo::X] > -_XSideBig/2.                &&
       intXnegYneg[RefFrame::Coo::X] < -_XSideSmall/2.              &&
       intXnegYneg[RefFrame::Coo::Y] > -_YSideBig/2.                &&
       intXnegYneg[RefFrame::Coo::Y] < -_YSideSmall/2.              &&
       intXnegYneg[RefFrame::Coo::Z] > -_ZCaloHeight                &&
-      intXnegYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXnegYneg,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXnegYneg[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXnegYneg,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXnegYpos[RefFrame::Coo::X] > -_XSideBig/2.                &&
       intXnegYpos[RefFrame::Coo::X] < -_XSideSmall/2.              &&
       intXnegYpos[RefFrame::Coo::Y] > +_YSideSmall/2.              &&
       intXnegYpos[RefFrame::Coo::Y] < +_YSideBig/2.                &&
       intXnegYpos[RefFrame::Coo::Z] > -_ZCaloHeight                &&
-      intXnegYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXnegYpos,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXnegYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXnegYpos,store.calofidvolznegEntry,nintZneg-1); }   
   if( intXposYpos[RefFrame::Coo::X] > +_XSideSmall/2.                &&
       intXposYpos[RefFrame::Coo::X] < +_XSideBig/2.              &&
       intXposYpos[RefFrame::Coo::Y] > +_YSideSmall/2.              &&
       intXposYpos[RefFrame::Coo::Y] < +_YSideBig/2.                &&
       intXposYpos[RefFrame::Coo::Z] > -_ZCaloHeight                &&
-      intXposYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXposYpos,_processstore->calofidvolznegEntry,nintZneg-1); }   
+      intXposYpos[RefFrame::Coo::Z] < -_ZCaloHeight + alpha*cubeside                    ) { nintZneg++; FillCoo(intXposYpos,store.calofidvolznegEntry,nintZneg-1); }   
   if( nintZneg >  2) {COUT(ERROR)<<"intZneg>2"<<ENDL;}// return false;}     
   if( nintZneg == 2) {
-    _processstore->calofidvolzneg=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolzneg=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolzneg=0;}
+    {store.calofidvolzneg=0;}
     
 //CORNER CAP CHECK: XNEGYNEG
   int nintXnegYneg=0; 
   if( intXnegYneg[RefFrame::Coo::X] > -_XSideBig/2.                 &&   
       intXnegYneg[RefFrame::Coo::X] < -_XSideSmall/2.               &&   
       intXnegYneg[RefFrame::Coo::Z] > -_ZCaloHeight                 &&   
-      intXnegYneg[RefFrame::Coo::Z] < 0.                              ) { nintXnegYneg++; FillCoo(intXnegYneg,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intXnegYneg[RefFrame::Coo::Z] < 0.                              ) { nintXnegYneg++; FillCoo(intXnegYneg,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
   if( intXneg[RefFrame::Coo::Y] > -_YSideSmall/2.                   &&   
       intXneg[RefFrame::Coo::Y] < -_YSideSmall/2. + alpha*cubeside  &&     
       intXneg[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intXneg[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYneg++; FillCoo(intXneg,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intXneg[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYneg++; FillCoo(intXneg,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
   if( intYneg[RefFrame::Coo::X] > -_XSideSmall/2.                     &&   
       intYneg[RefFrame::Coo::X] < -_XSideSmall/2. +  alpha*cubeside   &&   
       intYneg[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intYneg[RefFrame::Coo::Z] < 0.                                 )  { nintXnegYneg++; FillCoo(intYneg,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intYneg[RefFrame::Coo::Z] < 0.                                 )  { nintXnegYneg++; FillCoo(intYneg,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
   if( intZpos[RefFrame::Coo::X] > -_XSideBig/2.                     &&   
       intZpos[RefFrame::Coo::Y] > -_YSideBig/2.                     &&
       intZpos[RefFrame::Coo::Y] > mXNEGYNEG * intZpos[RefFrame::Coo::X] + qXNEGYNEG  &&
-      intZpos[RefFrame::Coo::Y] < mXNEGYNEG * intZpos[RefFrame::Coo::X] + qXNEGYNEG  + alpha*cubeside) { nintXnegYneg++; FillCoo(intZpos,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intZpos[RefFrame::Coo::Y] < mXNEGYNEG * intZpos[RefFrame::Coo::X] + qXNEGYNEG  + alpha*cubeside) { nintXnegYneg++; FillCoo(intZpos,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
   if( intZneg[RefFrame::Coo::X] > -_XSideBig/2.                     &&   
       intZneg[RefFrame::Coo::Y] > -_YSideBig/2.                     &&
       intZneg[RefFrame::Coo::Y] > mXNEGYNEG * intZneg[RefFrame::Coo::X] + qXNEGYNEG  &&
-      intZneg[RefFrame::Coo::Y] < mXNEGYNEG * intZneg[RefFrame::Coo::X] + qXNEGYNEG  + alpha*cubeside) { nintXnegYneg++; FillCoo(intZneg,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intZneg[RefFrame::Coo::Y] < mXNEGYNEG * intZneg[RefFrame::Coo::X] + qXNEGYNEG  + alpha*cubeside) { nintXnegYneg++; FillCoo(intZneg,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
   if( nintXnegYneg >  2) {COUT(ERROR)<<"nintXegYneg>2"<<ENDL;}// return false;}    
   if( nintXnegYneg == 2) {
-    _processstore->calofidvolxnegyneg=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxnegyneg=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxnegyneg=0;}
+    {store.calofidvolxnegyneg=0;}
 
 //CORNER CAP CHECK: XPOSYNEG
   int nintXposYneg=0; 
   if( intXposYneg[RefFrame::Coo::X] > +_XSideSmall/2.               &&   
       intXposYneg[RefFrame::Coo::X] < +_XSideBig/2.                 &&   
       intXposYneg[RefFrame::Coo::Z] > -_ZCaloHeight                 &&   
-      intXposYneg[RefFrame::Coo::Z] < 0.                              ) { nintXposYneg++; FillCoo(intXposYneg,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intXposYneg[RefFrame::Coo::Z] < 0.                              ) { nintXposYneg++; FillCoo(intXposYneg,store.calofidvolxposynegEntry,nintXposYneg-1); } 
   if( intXpos[RefFrame::Coo::Y] > -_YSideSmall/2.                   &&   
       intXpos[RefFrame::Coo::Y] < -_YSideSmall/2. + alpha*cubeside  &&     
       intXpos[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intXpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYneg++; FillCoo(intXpos,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intXpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYneg++; FillCoo(intXpos,store.calofidvolxposynegEntry,nintXposYneg-1); } 
   if( intYneg[RefFrame::Coo::X] < +_XSideSmall/2.                   &&   
       intYneg[RefFrame::Coo::X] > +_XSideSmall/2  - alpha*cubeside  &&     
       intYneg[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intYneg[RefFrame::Coo::Z] < 0.                                  ) { nintXposYneg++; FillCoo(intYneg,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intYneg[RefFrame::Coo::Z] < 0.                                  ) { nintXposYneg++; FillCoo(intYneg,store.calofidvolxposynegEntry,nintXposYneg-1); } 
   if( intZpos[RefFrame::Coo::X] < +_XSideBig/2.                     &&   
       intZpos[RefFrame::Coo::Y] > -_YSideBig/2.                     &&
       intZpos[RefFrame::Coo::Y] > mXPOSYNEG * intZpos[RefFrame::Coo::X] + qXPOSYNEG  &&
-      intZpos[RefFrame::Coo::Y] < mXPOSYNEG * intZpos[RefFrame::Coo::X] + qXPOSYNEG  + alpha*cubeside) { nintXposYneg++; FillCoo(intZpos,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intZpos[RefFrame::Coo::Y] < mXPOSYNEG * intZpos[RefFrame::Coo::X] + qXPOSYNEG  + alpha*cubeside) { nintXposYneg++; FillCoo(intZpos,store.calofidvolxposynegEntry,nintXposYneg-1); } 
   if( intZneg[RefFrame::Coo::X] < +_XSideBig/2.                     &&   
       intZneg[RefFrame::Coo::Y] > -_YSideBig/2.                     &&
       intZneg[RefFrame::Coo::Y] > mXPOSYNEG * intZneg[RefFrame::Coo::X] + qXPOSYNEG  &&
-      intZneg[RefFrame::Coo::Y] < mXPOSYNEG * intZneg[RefFrame::Coo::X] + qXPOSYNEG + alpha*cubeside) { nintXposYneg++; FillCoo(intZneg,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intZneg[RefFrame::Coo::Y] < mXPOSYNEG * intZneg[RefFrame::Coo::X] + qXPOSYNEG + alpha*cubeside) { nintXposYneg++; FillCoo(intZneg,store.calofidvolxposynegEntry,nintXposYneg-1); } 
   if( nintXposYneg >  2) {COUT(ERROR)<<"nintXposYneg>2"<<ENDL; }//return false;}    
   if( nintXposYneg == 2) {
-    _processstore->calofidvolxposyneg=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxposyneg=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxposyneg=0;}  
+    {store.calofidvolxposyneg=0;}  
 
   
 
@@ -542,80 +560,65 @@ bool CaloGeomFidVolumeAlgo::CheckExt() {
   if( intXnegYpos[RefFrame::Coo::X] > -_XSideBig/2.                 &&   
       intXnegYpos[RefFrame::Coo::X] < -_XSideSmall/2.               &&   
       intXnegYpos[RefFrame::Coo::Z] > -_ZCaloHeight                 &&   
-      intXnegYpos[RefFrame::Coo::Z] < 0.                              ) { nintXnegYpos++; FillCoo(intXnegYpos,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); } 
+      intXnegYpos[RefFrame::Coo::Z] < 0.                              ) { nintXnegYpos++; FillCoo(intXnegYpos,store.calofidvolxnegyposEntry,nintXnegYpos-1); } 
   if( intXneg[RefFrame::Coo::Y] < +_YSideSmall/2.                   &&   
       intXneg[RefFrame::Coo::Y] > +_YSideSmall/2. - alpha*cubeside  &&
       intXneg[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intXneg[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYpos++; FillCoo(intXneg,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); }  
+      intXneg[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYpos++; FillCoo(intXneg,store.calofidvolxnegyposEntry,nintXnegYpos-1); }  
   if( intYpos[RefFrame::Coo::X] > -_XSideSmall/2.                   &&   
       intYpos[RefFrame::Coo::X] < -_XSideSmall/2  + alpha*cubeside  &&     
       intYpos[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intYpos[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYpos++; FillCoo(intYpos,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); } 
+      intYpos[RefFrame::Coo::Z] < 0.                                  ) { nintXnegYpos++; FillCoo(intYpos,store.calofidvolxnegyposEntry,nintXnegYpos-1); } 
   if( intZpos[RefFrame::Coo::X] > -_XSideBig/2.                     &&   
       intZpos[RefFrame::Coo::Y] < +_YSideBig/2.                     &&
       intZpos[RefFrame::Coo::Y] < mXNEGYPOS * intZpos[RefFrame::Coo::X] + qXNEGYPOS  &&
-      intZpos[RefFrame::Coo::Y] > mXNEGYPOS * intZpos[RefFrame::Coo::X] + qXNEGYPOS  - alpha*cubeside) { nintXnegYpos++; FillCoo(intZpos,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); } 
+      intZpos[RefFrame::Coo::Y] > mXNEGYPOS * intZpos[RefFrame::Coo::X] + qXNEGYPOS  - alpha*cubeside) { nintXnegYpos++; FillCoo(intZpos,store.calofidvolxnegyposEntry,nintXnegYpos-1); } 
   if( intZneg[RefFrame::Coo::X] > -_XSideBig/2.                     &&   
       intZneg[RefFrame::Coo::Y] < +_YSideBig/2.                     &&
       intZneg[RefFrame::Coo::Y] < mXNEGYPOS * intZneg[RefFrame::Coo::X] + qXNEGYPOS  &&
-      intZneg[RefFrame::Coo::Y] > mXNEGYPOS * intZneg[RefFrame::Coo::X] + qXNEGYPOS - alpha*cubeside) { nintXnegYpos++; FillCoo(intZneg,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); }  
+      intZneg[RefFrame::Coo::Y] > mXNEGYPOS * intZneg[RefFrame::Coo::X] + qXNEGYPOS - alpha*cubeside) { nintXnegYpos++; FillCoo(intZneg,store.calofidvolxnegyposEntry,nintXnegYpos-1); }  
   if( nintXnegYpos >  2) {COUT(ERROR)<<"nintXnegYpos>2"<<ENDL; }//return false;}    
   if( nintXnegYpos == 2) {
-    _processstore->calofidvolxnegypos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxnegypos=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxnegypos=0;}
+    {store.calofidvolxnegypos=0;}
 
 //CORNER CAP CHECK: XPOSYPOS
   int nintXposYpos=0; 
   if( intXposYpos[RefFrame::Coo::X] > +_XSideSmall/2.               &&   
       intXposYpos[RefFrame::Coo::X] < +_XSideBig/2.                 &&   
       intXposYpos[RefFrame::Coo::Z] > -_ZCaloHeight                 &&   
-      intXposYpos[RefFrame::Coo::Z] < 0.                              ) { nintXposYpos++; FillCoo(intXposYpos,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intXposYpos[RefFrame::Coo::Z] < 0.                              ) { nintXposYpos++; FillCoo(intXposYpos,store.calofidvolxposyposEntry,nintXposYpos-1); } 
   if( intXpos[RefFrame::Coo::Y] < +_YSideSmall/2.                   &&   
       intXpos[RefFrame::Coo::Y] > +_YSideSmall/2. - alpha*cubeside  &&     
       intXpos[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intXpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYpos++; FillCoo(intXpos,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intXpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYpos++; FillCoo(intXpos,store.calofidvolxposyposEntry,nintXposYpos-1); } 
   if( intYpos[RefFrame::Coo::X] < +_XSideSmall/2.                   &&   
       intYpos[RefFrame::Coo::X] > +_XSideSmall/2  - alpha*cubeside  &&     
       intYpos[RefFrame::Coo::Z] > -_ZCaloHeight                     &&   
-      intYpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYpos++; FillCoo(intYpos,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intYpos[RefFrame::Coo::Z] < 0.                                  ) { nintXposYpos++; FillCoo(intYpos,store.calofidvolxposyposEntry,nintXposYpos-1); } 
   if( intZpos[RefFrame::Coo::X] < +_XSideBig/2.                     &&   
       intZpos[RefFrame::Coo::Y] < +_YSideBig/2.                     &&
       intZpos[RefFrame::Coo::Y] < mXPOSYPOS * intZpos[RefFrame::Coo::X] + qXPOSYPOS  &&
-      intZpos[RefFrame::Coo::Y] > mXPOSYPOS * intZpos[RefFrame::Coo::X] + qXPOSYPOS  - alpha*cubeside) { nintXposYpos++; FillCoo(intZpos,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intZpos[RefFrame::Coo::Y] > mXPOSYPOS * intZpos[RefFrame::Coo::X] + qXPOSYPOS  - alpha*cubeside) { nintXposYpos++; FillCoo(intZpos,store.calofidvolxposyposEntry,nintXposYpos-1); } 
   if( intZneg[RefFrame::Coo::X] < +_XSideBig/2.                     &&   
       intZneg[RefFrame::Coo::Y] < +_YSideBig/2.                     &&
       intZneg[RefFrame::Coo::Y] < mXPOSYPOS * intZneg[RefFrame::Coo::X] + qXPOSYPOS  &&
-      intZneg[RefFrame::Coo::Y] > mXPOSYPOS * intZneg[RefFrame::Coo::X] + qXPOSYPOS - alpha*cubeside) { nintXposYpos++; FillCoo(intZneg,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intZneg[RefFrame::Coo::Y] > mXPOSYPOS * intZneg[RefFrame::Coo::X] + qXPOSYPOS - alpha*cubeside) { nintXposYpos++; FillCoo(intZneg,store.calofidvolxposyposEntry,nintXposYpos-1); } 
   if( nintXposYpos >  2) {COUT(ERROR)<<"nintXposYpos>2"<<ENDL;}// return false;}    
   if( nintXposYpos == 2) {
-    _processstore->calofidvolxposypos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::REJECT);
+    store.calofidvolxposypos=1; store.calofidvolpass=false;
     }
   else
-    {_processstore->calofidvolxposypos=0;} 
+    {store.calofidvolxposypos=0;} 
 
-  return true;
+  return store.calofidvolpass;
 }
 
-bool CaloGeomFidVolumeAlgo::CheckInt() {
+bool CaloGeomFidVolumeAlgo::CheckInt(const Line &track, CaloGeomFidVolumeStore &store, unsigned long long eventindex) {
     
-  const std::string routineName = GetName() + "::Process";
-
-  //Add the ProcessStore object for this event to the event data store
-  //_processstore->Reset();
-  _evStore->AddObject("caloGeomFidVolumeStore",_processstore);
-
-  //Set Filter Status
-  SetFilterResult(FilterResult::ACCEPT);
-
-  auto mcTruth = _evStore->GetObject<MCTruth>("mcTruth");
-  if (!mcTruth) {COUT(ERROR) << "mcTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;return false;}
-  const Momentum &Mom = mcTruth->primaries[0].initialMomentum;
-  const Point &Pos    = mcTruth->primaries[0].initialPosition;
-  Line track(Pos, Mom);
+  const std::string &routineName = _processname;
 
   
   //Get Intersection with planes
@@ -630,50 +633,50 @@ bool CaloGeomFidVolumeAlgo::CheckInt() {
   Point intZneg = plane[RefFrame::Direction::Zneg].Intersection(track);
   Point intZpos = plane[RefFrame::Direction::Zpos].Intersection(track);
   
-  _processstore->calofidvolpass=true;
-  _processstore->calofidvolalpha=alpha;
+  store.calofidvolpass=true;
+  store.calofidvolalpha=alpha;
 
   int nint=0;
   //LATERAL CAP CHECK: XPOS
   //COUT(INFO)<<intXpos[RefFrame::Coo::X]<<" "<<intXpos[RefFrame::Coo::Y]<<" "<<intXpos[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intXpos,_processstore->calofidvolxposEntry,0);
+  FillCoo(intXpos,store.calofidvolxposEntry,0);
   if( intXpos[RefFrame::Coo::Y] < pxy[1][RefFrame::Coo::Y]        &&   
       intXpos[RefFrame::Coo::Y] > pxy[2][RefFrame::Coo::Y]        &&   
       intXpos[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]          &&   
-      intXpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxpos=1;      //COUT(INFO)<<"XPOS"<<ENDL;
-}//FillCoo(intXpos,_processstore->calofidvolxposEntry,nintXpos-1); }
+      intXpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxpos=1;      //COUT(INFO)<<"XPOS"<<ENDL;
+}//FillCoo(intXpos,store.calofidvolxposEntry,nintXpos-1); }
 
   //LATERAL CAP CHECK: XNEG
 //COUT(INFO)<<intXneg[RefFrame::Coo::X]<<" "<<intXneg[RefFrame::Coo::Y]<<" "<<intXneg[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intXneg,_processstore->calofidvolxnegEntry,0);
+  FillCoo(intXneg,store.calofidvolxnegEntry,0);
   if( intXneg[RefFrame::Coo::Y] < pxy[6][RefFrame::Coo::Y]        &&   
       intXneg[RefFrame::Coo::Y] > pxy[5][RefFrame::Coo::Y]        &&   
       intXneg[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]          &&   
-      intXneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxneg=1;      //COUT(INFO)<<"XNEG"<<ENDL;
-}//FillCoo(intXneg,_processstore->calofidvolxnegEntry,nintXneg-1); }
+      intXneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxneg=1;      //COUT(INFO)<<"XNEG"<<ENDL;
+}//FillCoo(intXneg,store.calofidvolxnegEntry,nintXneg-1); }
 
 //LATERAL CAP CHECK: YPOS
 //COUT(INFO)<<intYpos[RefFrame::Coo::X]<<" "<<intYpos[RefFrame::Coo::Y]<<" "<<intYpos[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intYpos,_processstore->calofidvolyposEntry,0);
+  FillCoo(intYpos,store.calofidvolyposEntry,0);
   if( intYpos[RefFrame::Coo::X] < pxy[0][RefFrame::Coo::X]        &&   
       intYpos[RefFrame::Coo::X] > pxy[7][RefFrame::Coo::X]        &&   
       intYpos[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]          &&   
-      intYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            )  { nint++; _processstore->calofidvolypos=1;      //COUT(INFO)<<"YPOS"<<ENDL;
-}//FillCoo(intYpos,_processstore->calofidvolyposEntry,nintYpos-1); }
+      intYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            )  { nint++; store.calofidvolypos=1;      //COUT(INFO)<<"YPOS"<<ENDL;
+}//FillCoo(intYpos,store.calofidvolyposEntry,nintYpos-1); }
   
 //LATERAL CAP CHECK: YNEG
 //COUT(INFO)<<intYneg[RefFrame::Coo::X]<<" "<<intYneg[RefFrame::Coo::Y]<<" "<<intYneg[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intYneg,_processstore->calofidvolynegEntry,0);
+  FillCoo(intYneg,store.calofidvolynegEntry,0);
   if( intYneg[RefFrame::Coo::X] < pxy[3][RefFrame::Coo::X]        &&   
       intYneg[RefFrame::Coo::X] > pxy[4][RefFrame::Coo::X]        &&   
       intYneg[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]          &&   
-      intYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolyneg=1;      //COUT(INFO)<<"YNEG"<<ENDL;
-}//FillCoo(intYneg,_processstore->calofidvolynegEntry,nintYneg-1); }
+      intYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolyneg=1;      //COUT(INFO)<<"YNEG"<<ENDL;
+}//FillCoo(intYneg,store.calofidvolynegEntry,nintYneg-1); }
 
 //TOP CAP CHECK: ZPOS
   // Assume an octagon
   //COUT(INFO)<<intZpos[RefFrame::Coo::X]<<" "<<intZpos[RefFrame::Coo::Y]<<" "<<intZpos[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intZpos,_processstore->calofidvolzposEntry,0);
+  FillCoo(intZpos,store.calofidvolzposEntry,0);
   if( intZpos[RefFrame::Coo::X] < pxy[1][RefFrame::Coo::X]         && 
       intZpos[RefFrame::Coo::X] > pxy[6][RefFrame::Coo::X]         &&  
       intZpos[RefFrame::Coo::Y] > pxy[4][RefFrame::Coo::Y]         && 
@@ -685,12 +688,12 @@ bool CaloGeomFidVolumeAlgo::CheckInt() {
       intZpos[RefFrame::Coo::Y] < m[RefFrame::Direction::XnegYpos] * intZpos[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYpos]  &&
       intZpos[RefFrame::Coo::Y] < m[RefFrame::Direction::XposYpos] * intZpos[RefFrame::Coo::X] + q[RefFrame::Direction::XposYpos]  &&
       intZpos[RefFrame::Coo::Y] > m[RefFrame::Direction::XposYneg] * intZpos[RefFrame::Coo::X] + q[RefFrame::Direction::XposYneg]  &&
-      intZpos[RefFrame::Coo::Y] > m[RefFrame::Direction::XnegYneg] * intZpos[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYneg]     ) { nint++; _processstore->calofidvolzpos=1;     // COUT(INFO)<<"ZPOS"<<ENDL;
-}// FillCoo(intZpos,_processstore->calofidvolzposEntry,nintZpos-1); }    
+      intZpos[RefFrame::Coo::Y] > m[RefFrame::Direction::XnegYneg] * intZpos[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYneg]     ) { nint++; store.calofidvolzpos=1;     // COUT(INFO)<<"ZPOS"<<ENDL;
+}// FillCoo(intZpos,store.calofidvolzposEntry,nintZpos-1); }    
   //BOTTOM CAP CHECK: ZNEG
   // Assume an octagon
   //COUT(INFO)<<intZneg[RefFrame::Coo::X]<<" "<<intZneg[RefFrame::Coo::Y]<<" "<<intZneg[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intZneg,_processstore->calofidvolznegEntry,0);
+  FillCoo(intZneg,store.calofidvolznegEntry,0);
   if( intZneg[RefFrame::Coo::X] < pxy[1][RefFrame::Coo::X]         &&   
       intZneg[RefFrame::Coo::X] > pxy[6][RefFrame::Coo::X]         && 
       intZneg[RefFrame::Coo::Y] > pxy[4][RefFrame::Coo::Y]         && 
@@ -702,68 +705,74 @@ bool CaloGeomFidVolumeAlgo::CheckInt() {
       intZneg[RefFrame::Coo::Y] < m[RefFrame::Direction::XnegYpos] * intZneg[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYpos]  &&
       intZneg[RefFrame::Coo::Y] < m[RefFrame::Direction::XposYpos] * intZneg[RefFrame::Coo::X] + q[RefFrame::Direction::XposYpos]  &&
       intZneg[RefFrame::Coo::Y] > m[RefFrame::Direction::XposYneg] * intZneg[RefFrame::Coo::X] + q[RefFrame::Direction::XposYneg]  &&
-      intZneg[RefFrame::Coo::Y] > m[RefFrame::Direction::XnegYneg] * intZneg[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYneg]     ) { nint++;  _processstore->calofidvolzneg=1;     //COUT(INFO)<<"ZNEG"<<ENDL;
-}// FillCoo(intZneg,_processstore->calofidvolznegEntry,nintZneg-1); }      
+      intZneg[RefFrame::Coo::Y] > m[RefFrame::Direction::XnegYneg] * intZneg[RefFrame::Coo::X] + q[RefFrame::Direction::XnegYneg]     ) { nint++;  store.calofidvolzneg=1;     //COUT(INFO)<<"ZNEG"<<ENDL;
+}// FillCoo(intZneg,store.calofidvolznegEntry,nintZneg-1); }      
     
 //CORNER CAP CHECK: XNEGYNEG
 //  COUT(INFO)<<intXnegYneg[RefFrame::Coo::X]<<" "<<intXnegYneg[RefFrame::Coo::Y]<<" "<<intXnegYneg[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intXnegYneg,_processstore->calofidvolxnegynegEntry,0);
+  FillCoo(intXnegYneg,store.calofidvolxnegynegEntry,0);
   if( intXnegYneg[RefFrame::Coo::X] > pxy[5][RefFrame::Coo::X]         &&   
       intXnegYneg[RefFrame::Coo::X] < pxy[4][RefFrame::Coo::X]         &&   
       intXnegYneg[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]           &&   
-      intXnegYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxnegyneg=1;    //COUT(INFO)<<"XNEG-YNEG"<<ENDL;
-}// FillCoo(intXnegYneg,_processstore->calofidvolxnegynegEntry,nintXnegYneg-1); }   
+      intXnegYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxnegyneg=1;    //COUT(INFO)<<"XNEG-YNEG"<<ENDL;
+}// FillCoo(intXnegYneg,store.calofidvolxnegynegEntry,nintXnegYneg-1); }   
  
 //CORNER CAP CHECK: XPOSYNEG
-  FillCoo(intXposYneg,_processstore->calofidvolxposynegEntry,0);
+  FillCoo(intXposYneg,store.calofidvolxposynegEntry,0);
   if( intXposYneg[RefFrame::Coo::X] > pxy[3][RefFrame::Coo::X]         &&   
       intXposYneg[RefFrame::Coo::X] < pxy[2][RefFrame::Coo::X]         &&   
       intXposYneg[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]           &&   
-      intXposYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxposyneg=1;     //COUT(INFO)<<"XPOS-YNEG"<<ENDL;
-}// FillCoo(intXposYneg,_processstore->calofidvolxposynegEntry,nintXposYneg-1); } 
+      intXposYneg[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxposyneg=1;     //COUT(INFO)<<"XPOS-YNEG"<<ENDL;
+}// FillCoo(intXposYneg,store.calofidvolxposynegEntry,nintXposYneg-1); } 
  
 //CORNER CAP CHECK: XNEGYPOS
-  FillCoo(intXnegYpos,_processstore->calofidvolxnegyposEntry,0);
+  FillCoo(intXnegYpos,store.calofidvolxnegyposEntry,0);
   if( intXnegYpos[RefFrame::Coo::X] > pxy[6][RefFrame::Coo::X]         &&   
       intXnegYpos[RefFrame::Coo::X] < pxy[7][RefFrame::Coo::X]         &&   
       intXnegYpos[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]           &&   
-      intXnegYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxnegypos=1;     //COUT(INFO)<<"XNEG-YPOS"<<ENDL;
-}// FillCoo(intXnegYpos,_processstore->calofidvolxnegyposEntry,nintXnegYpos-1); } 
+      intXnegYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxnegypos=1;     //COUT(INFO)<<"XNEG-YPOS"<<ENDL;
+}// FillCoo(intXnegYpos,store.calofidvolxnegyposEntry,nintXnegYpos-1); } 
 
 //CORNER CAP CHECK: XPOSYPOS
 //COUT(INFO)<<intXposYpos[RefFrame::Coo::X]<<" "<<intXposYpos[RefFrame::Coo::Y]<<" "<<intXposYpos[RefFrame::Coo::Z]<<ENDL;
-  FillCoo(intXposYpos,_processstore->calofidvolxposyposEntry,0);
+  FillCoo(intXposYpos,store.calofidvolxposyposEntry,0);
   if( intXposYpos[RefFrame::Coo::X] > pxy[0][RefFrame::Coo::X]         &&   
       intXposYpos[RefFrame::Coo::X] < pxy[1][RefFrame::Coo::X]         &&   
       intXposYpos[RefFrame::Coo::Z] > pz[1][RefFrame::Coo::Z]           &&   
-      intXposYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; _processstore->calofidvolxposypos=1;      //COUT(INFO)<<"XPOS-YPOS"<<ENDL;
-}// FillCoo(intXposYpos,_processstore->calofidvolxposyposEntry,nintXposYpos-1); } 
+      intXposYpos[RefFrame::Coo::Z] < pz[0][RefFrame::Coo::Z]            ) { nint++; store.calofidvolxposypos=1;      //COUT(INFO)<<"XPOS-YPOS"<<ENDL;
+}// FillCoo(intXposYpos,store.calofidvolxposyposEntry,nintXposYpos-1); } 
  
      
  if( nint > 2) {
-   COUT(INFO)<<GetEventLoopProxy()->GetCurrentEvent()<<"::Intersections_Found::"<<nint<<"  --- Maybe_A_Corner?"<<ENDL;
+   COUT(INFO)<<eventindex<<"::Intersections_Found::"<<nint<<"  --- Maybe_A_Corner?"<<ENDL;
   }
 
   if(nint ==1) { COUT(INFO)<<"nint 1"<<ENDL;}
   if( nint > 1) {
-    //_processstore->calofidvolxposypos=1; _processstore->calofidvolpass=false;
-    SetFilterResult(FilterResult::ACCEPT);
-    _processstore->calofidvolpass=true;
+    //store.calofidvolxposypos=1; store.calofidvolpass=false;
+    store.calofidvolpass=true;
     }
   else
     {
-    SetFilterResult(FilterResult::REJECT);
-    _processstore->calofidvolpass=false;
+    store.calofidvolpass=false;
 }
 
-  return true;
+  return store.calofidvolpass;
 }
 
 
-bool CaloGeomFidVolumeAlgo::Finalize() { return true; }
+bool CaloGeomFidVolumeAlgo::Finalize() {
+  const std::string routineName = GetName() + "::Finalize";
+  KernelRegistry::Instance().Drain();
+  KernelRegistry::Instance().Unregister(GetName());
+  auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+  if (!globStore) { COUT(ERROR) << "Global data store not found." << ENDL; return false; }
+  _timer.Publish(*globStore, GetName());
+  return true;
+}
 
 
-void CaloGeomFidVolumeAlgo::FillCoo(const Herd::Point p, float coo[2][3], int index) {
+void CaloGeomFidVolumeAlgo::FillCoo(const Herd::Point &p, float coo[2][3], int index) {
 coo[index][0] = p[RefFrame::Coo::X];
 coo[index][1] = p[RefFrame::Coo::Y];
 coo[index][2] = p[RefFrame::Coo::Z];
@@ -786,7 +795,7 @@ CaloGeomFidVolumeStore::CaloGeomFidVolumeStore(const std::string &name) :
 }
 
   bool CaloGeomFidVolumeStore::Process() {
-  const std::string routineName("CaloGeomFidVolumeStore::Process");
+  static const std::string routineName("CaloGeomFidVolumeStore::Process");
   return true;
 }
   bool CaloGeomFidVolumeStore::Finalize() {
@@ -794,8 +803,6 @@ CaloGeomFidVolumeStore::CaloGeomFidVolumeStore(const std::string &name) :
   return true;
 }
 bool CaloGeomFidVolumeStore::Reset() {
-  const std::string routineName("CaloGeomFidVolumeStore::Finalize");
-
   calofidvolalpha = 0;
   calofidvolpass = true;
   calofidvolxpos = 0;
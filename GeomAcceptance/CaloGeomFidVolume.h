@@ -11,9 +11,13 @@
 #include "algorithm/Algorithm.h"
 #include "common/DirectionsArray.h"
 #include "dataobjects/Plane.h"
+#include "dataobjects/Line.h"
 #include "dataobjects/CaloGeoParams.h"
-#include "CaloGeomFidVolume.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/ProcessTimer.h"
+#include "Utils/StorePool.h"
 #include <array>
+#include <memory>
 
 using namespace EA;
 
@@ -38,7 +42,7 @@ namespace Herd {
  * trackInfoForCaloMC           | TrackInfoForCalo | evStore   | Container of information about the track for the Calo.
  *
  */
-class CaloGeomFidVolumeAlgo : public Algorithm {
+class CaloGeomFidVolumeAlgo : public Algorithm, public AcceptanceKernel {
 public:
   /*! @brief Constructor.
    *
@@ -64,10 +68,13 @@ public:
    */
   bool Finalize();
 
+  /*! @brief Checks the event against the fiducial volume, can be called concurrently.
+   *
+   * @return false if the event is rejected.
+   */
+  bool ProcessEvent(const AcceptanceEvent &event);
+
 private:
-  
-  //Store pointer
-  std::shared_ptr<CaloGeomFidVolumeStore> _processstore;
 
   observer_ptr<EventDataStore> _evStore; ///< Pointer to the event data store.
   //TrackInfoForCalo *_trackInfoCalo; ///< The TrackInfoForCalo object to fill with the computed information.
@@ -89,6 +96,7 @@ private:
   bool filterenable;
   bool checkext;
   bool checkint;
+  bool deferred; ///< Processing done by ParallelAcceptance.
 
   const float _XSideBig;    // cm
   const float _XSideSmall;  // cm
@@ -104,9 +112,16 @@ private:
   std::array<Point,8> pxy;
   std::array<Point,2> pz;
 
-  bool CheckExt();
-  bool CheckInt();
-  void FillCoo(const Herd::Point p, float coo[2][3], int index);
+  bool perfcounters; ///< Also read the hardware counters when timing Process().
+  ProcessTimer _timer; ///< Latency of the Process() calls, published at Finalize.
+  std::string _processname; ///< Routine name of the log messages of the per-event methods.
+  StorePool<CaloGeomFidVolumeStore> _processstores; ///< A store of its own for every event, without allocating.
+
+  // The checks only read the geometry and fill the given event store, returning the filter decision
+  bool Evaluate(const AcceptanceEvent &event, CaloGeomFidVolumeStore &store);
+  bool CheckExt(const Line &track, CaloGeomFidVolumeStore &store, unsigned long long eventindex);
+  bool CheckInt(const Line &track, CaloGeomFidVolumeStore &store, unsigned long long eventindex);
+  static void FillCoo(const Herd::Point &p, float coo[2][3], int index);
 
  
 };                                    
@@ -10,6 +10,7 @@
 #include "TGraph2D.h"
 
 // C/C++ standard headers
+#include <cmath>
 #include <numeric>
 
 RegisterAlgorithm(MCtruthProcess);
@@ -22,13 +23,19 @@ MCtruthProcess::MCtruthProcess(const std::string &name) :
   filterenable{true},
   minstkintersections{-1},
   mincalotrackx0{-999},
-  notfrombottom{true}
+  notfrombottom{true},
+  deferred{false},
+  folding("none"),
+  perfcounters{false}
    {
      DefineParameter("minstkintersections", minstkintersections);
      DefineParameter("printcalocubemap",    printcalocubemap);
      DefineParameter("filterenable",        filterenable);
      DefineParameter("mincalotrackx0",      mincalotrackx0);
      DefineParameter("notfrombottom",       notfrombottom);
+     DefineParameter("deferred",            deferred);
+     DefineParameter("folding",             folding);
+     DefineParameter("perfcounters",        perfcounters);
 
   }
 
@@ -46,146 +53,216 @@ bool MCtruthProcess::Initialize() {
 
   if(printcalocubemap) PrintCaloCubeMap();
 
-  _processstore = std::make_shared<MCtruthProcessStore>("MCtruthProcessStore");
-  COUT(INFO) << "InitializedProcessStore::" <<_processstore << ENDL;
-
   // Create the histogram
-  _gdiscarded       = std::make_shared<TGraph>();
-  _gdiscarded->SetNameTitle("gdiscarded","Discarded Events before simulated");
-  _hgencthetaphi = std::make_shared<TH2F>("hgencthetaphi","MCtruth Generation;cos(#theta);Phi (rad)",1000,-1,1,100,-TMath::Pi(),+TMath::Pi());
-  _hgencoo       = std::make_shared<TH3F>("hgencoo",      "MCtruth Generation;X(cm);Y(cm);Z(cm)",    100,-500,500,100,-500,500,100,-500,500);
-  _hstkintersections = std::make_shared<TH1F>("hstkintersections", "Inyersection of track with STK;Occurrence", 101,-1.5,99.5);
-  _ggencoo       = std::make_shared<TGraph2D>();
-  _ggencoo->SetNameTitle("ggencoo","Generation Coordinates;X(cm);Y(cm);Z(cm)");
-  _gcaloentry       = std::make_shared<TGraph2D>();
-  _gcaloentry->SetNameTitle("gcaloentry","CALO Entry point;X(cm);Y(cm);Z(cm)");
-  _gcaloexit       = std::make_shared<TGraph2D>();
-  _gcaloexit->SetNameTitle("gcaloexit","CALO Exit point;X(cm);Y(cm);Z(cm)");
-
-  _hcaloentryexitdir = std::make_shared<TH2F>("hcaloentryexitdir","CALO Entry (X) - Exit (Y)",Herd::RefFrame::NDirections+1, -0.5, Herd::RefFrame::NDirections+0.5, Herd::RefFrame::NDirections+1, -0.5, Herd::RefFrame::NDirections+0.5);
-  _hcaloentryexitdir->GetXaxis()->SetBinLabel(_hcaloentryexitdir->GetNbinsX(),"NONE");
-  for(int ibin=1; ibin<_hcaloentryexitdir->GetNbinsX(); ibin++) _hcaloentryexitdir->GetXaxis()->SetBinLabel(ibin, Herd::RefFrame::DirectionName[ibin-1].c_str());
-  _hcaloentryexitdir->GetYaxis()->SetBinLabel(_hcaloentryexitdir->GetNbinsY(),"NONE");
-  for(int ibin=1; ibin<_hcaloentryexitdir->GetNbinsY(); ibin++) _hcaloentryexitdir->GetYaxis()->SetBinLabel(ibin, Herd::RefFrame::DirectionName[ibin-1].c_str());
+  _gdiscarded.Reset();
+  //Generation directions in the fundamental domain of the Calo symmetries, if folded
+  std::string errmsg;
+  std::vector<double> polaraxis{1000,-1,1}, azimuthaxis{100,-TMath::Pi(),+TMath::Pi()};
+  if (!_folding.Set(folding, errmsg) || !_folding.FoldAxes(polaraxis, azimuthaxis, errmsg)) { COUT(ERROR) << errmsg << ENDL; return false; }
+  _folding.SetUpperEdges(polaraxis[2], azimuthaxis[2]);
+  _hgencthetaphi.Reset(Histo2D(Herd::RegularAxis((int)polaraxis[0],polaraxis[1],polaraxis[2]), Herd::RegularAxis((int)azimuthaxis[0],azimuthaxis[1],azimuthaxis[2])));
+  //10^6 cells: a single copy of the bins, filled through bounded per-thread buffers
+  _hgencoo.Reset(Histo3D(Herd::RegularAxis(100,-500,500), Herd::RegularAxis(100,-500,500), Herd::RegularAxis(100,-500,500)), Herd::ShardedHistogram<Histo3D>::Policy::Buffered);
+  _hstkintersections.Reset(Histo1D(Herd::RegularAxis(101,-1.5,99.5)));
+  _ggencoo.Reset();
+  _gcaloentry.Reset();
+  _gcaloexit.Reset();
+
+  //One category per direction, the last one for NONE
+  std::vector<std::string> dirlabels(Herd::RefFrame::DirectionName, Herd::RefFrame::DirectionName+Herd::RefFrame::NDirections);
+  dirlabels.push_back("NONE");
+  _hcaloentryexitdir.Reset(DirHisto2D(Herd::CategoryAxis(Herd::RefFrame::NDirections+1, dirlabels), Herd::CategoryAxis(Herd::RefFrame::NDirections+1, dirlabels)));
   
-  _hshowerlengthall  = std::make_shared<TH1F>(Form("hshowerlengthall"), Form("Shower Lenght (X0) All"),200,0,100);
+  _hshowerlengthall.Reset(Histo1D(Herd::RegularAxis(200,0,100)));
   for(int indir=0; indir < Herd::RefFrame::NDirections; indir++){
     for(int outdir=0; outdir < Herd::RefFrame::NDirections; outdir++){
-      _hshowerlength[indir][outdir]  = std::make_shared<TH1F>(Form("hshowerlength_%d_%d",indir,outdir), Form("Shower Lenght (X0) [%s-%s]",Herd::RefFrame::DirectionName[indir].c_str(),Herd::RefFrame::DirectionName[outdir].c_str()),200,0,100);
-      //COUT(DEBUG)<<Form("%s %s",_hshowerlength[indir][outdir]->GetName(),_hshowerlength[indir][outdir]->GetTitle())<<ENDL;
+      _hshowerlength[indir][outdir].Reset(Histo1D(Herd::RegularAxis(200,0,100)));
     }
   }
+
+  if(deferred) Herd::KernelRegistry::Instance().Register(GetName(), this);
+
+  if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+  _processstores.Init("MCtruthProcessStore");
+
   return true;
 }
 
 bool MCtruthProcess::Process() {
-  const std::string routineName("MCtruthProcess::Process");
-
-  //Add the ProcessStore object for this event to the event data store
-  //_processstore->Reset();
-  _evStore->AddObject("MCtruthProcessStore",_processstore);
+  static const std::string routineName("MCtruthProcess::Process");
+  Herd::ProcessScope timing(_timer);
 
   //Set Filter Status
   SetFilterResult(FilterResult::ACCEPT);
+  if(deferred) return true;
+
+  //Add the ProcessStore object for this event to the event data store
+  static const std::string processstorename("MCtruthProcessStore");
+  auto processstore = _processstores.Acquire();
+  _evStore->AddObject(processstorename,processstore);
+
+  Herd::AcceptanceEvent event;
+  if (!Herd::LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), event)) { COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+  if (!event.hascalotrack) { COUT(DEBUG) << "TrackInfoForCalo  not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+  if (!event.hasstkintersections) { COUT(DEBUG) << "StkIntersections not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+
+  if( !Evaluate(event, processstore.get()) ) SetFilterResult(FilterResult::REJECT);
+
+  return true;
+}
+
+bool MCtruthProcess::ProcessEvent(const Herd::AcceptanceEvent &event) {
+  if( !event.hascalotrack || !event.hasstkintersections ) return false;
+  return Evaluate(event, nullptr) || !filterenable;
+}
 
-  auto mctruth = _evStore->GetObject<Herd::MCTruth>("mcTruth");
-  if (!mctruth) { COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
-  auto calotrack = _evStore->GetObject<Herd::TrackInfoForCalo>("trackInfoForCaloMC");
-  if (!calotrack) { COUT(DEBUG) << "TrackInfoForCalo  not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
-  auto stkintersections = _evStore->GetObject<Herd::StkIntersections>("stkIntersectionsMC");
-  if (!stkintersections) { COUT(DEBUG) << "StkIntersections not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL; return false; }
+bool MCtruthProcess::Evaluate(const Herd::AcceptanceEvent &event, MCtruthProcessStore *processstore) {
 
-  _gdiscarded->SetPoint(_gdiscarded->GetN(), _gdiscarded->GetN(), mctruth->nDiscarded);
+  //Only local variables and per-thread shards are modified: this is called concurrently by the kernel
+  bool pass = true;
 
-  const auto &primary = mctruth->primaries.at(0);
-  Herd::Point gencoo = primary.initialPosition;
-	TVector3 genmom (primary.initialMomentum[Herd::RefFrame::Coo::X],primary.initialMomentum[Herd::RefFrame::Coo::Y],primary.initialMomentum[Herd::RefFrame::Coo::Z]);
+  _gdiscarded.Add(event.index, {{(double)event.ndiscarded}});
+
+	TVector3 genmom (event.momentum[0],event.momentum[1],event.momentum[2]);
   Double_t genctheta = genmom.CosTheta();
   Double_t genphi = genmom.Phi();
-  Double_t mom = genmom.Mag();
-  _hgencoo->Fill(gencoo[Herd::RefFrame::Coo::X],gencoo[Herd::RefFrame::Coo::Y],gencoo[Herd::RefFrame::Coo::Z]);
-  _ggencoo->SetPoint(_ggencoo->GetN(),gencoo[Herd::RefFrame::Coo::X],gencoo[Herd::RefFrame::Coo::Y],gencoo[Herd::RefFrame::Coo::Z]);
-  _hgencthetaphi->Fill(genctheta,genphi);
-
-  int nstkintersections = static_cast<int>(stkintersections->intersections.size());
-  _hstkintersections->Fill(nstkintersections);
-  
-  _processstore->mcDir[0] = primary.initialMomentum[Herd::RefFrame::Coo::X] / genmom.Mag();
-  _processstore->mcDir[1] = primary.initialMomentum[Herd::RefFrame::Coo::Y] / genmom.Mag();
-  _processstore->mcDir[2] = primary.initialMomentum[Herd::RefFrame::Coo::Z] / genmom.Mag();
-  _processstore->mcNdiscarded = mctruth->nDiscarded;
-  _processstore->mcCoo[0] = primary.initialPosition[Herd::RefFrame::Coo::X];
-  _processstore->mcCoo[1] = primary.initialPosition[Herd::RefFrame::Coo::Y];
-  _processstore->mcCoo[2] = primary.initialPosition[Herd::RefFrame::Coo::Z];
-  _processstore->mcMom = genmom.Mag();
-  _processstore->mcPhi = genmom.Phi();
-  _processstore->mcCtheta = genmom.CosTheta();
-  _processstore->mcStkintersections = nstkintersections;
+  _hgencoo.Fill(event.position[0],event.position[1],event.position[2]);
+  _ggencoo.Add(event.index, {{event.position[0],event.position[1],event.position[2]}});
+  double foldctheta = genctheta, foldphi = genphi;
+  _folding.Fold(foldctheta, foldphi);
+  _hgencthetaphi.Fill(foldctheta,foldphi);
+
+  int nstkintersections = event.nstkintersections;
+  _hstkintersections.Fill(nstkintersections);
+
+  if( processstore ){
+    processstore->mcDir[0] = event.momentum[0] / genmom.Mag();
+    processstore->mcDir[1] = event.momentum[1] / genmom.Mag();
+    processstore->mcDir[2] = event.momentum[2] / genmom.Mag();
+    processstore->mcNdiscarded = event.ndiscarded;
+    processstore->mcCoo[0] = event.position[0];
+    processstore->mcCoo[1] = event.position[1];
+    processstore->mcCoo[2] = event.position[2];
+    processstore->mcMom = genmom.Mag();
+    processstore->mcPhi = genmom.Phi();
+    processstore->mcCtheta = genmom.CosTheta();
+    processstore->mcStkintersections = nstkintersections;
+  }
 
   //Check number of intersections with STK
-  if( nstkintersections < minstkintersections)  { SetFilterResult(FilterResult::REJECT); }
+  if( nstkintersections < minstkintersections)  { pass = false; }
     
-	Herd::RefFrame::Direction entrydir = calotrack->entrancePlane;
-	Herd::RefFrame::Direction exitdir = calotrack->exitPlane;
-  _hcaloentryexitdir->Fill( entrydir==Herd::RefFrame::Direction::NONE ? _hcaloentryexitdir->GetNbinsX()-0.5 : static_cast<int>(entrydir), exitdir==Herd::RefFrame::Direction::NONE ? _hcaloentryexitdir->GetNbinsY()-0.5 : static_cast<int>(exitdir));
+	Herd::RefFrame::Direction entrydir = event.caloentryplane;
+	Herd::RefFrame::Direction exitdir = event.caloexitplane;
+  _hcaloentryexitdir.Fill( entrydir==Herd::RefFrame::Direction::NONE ? Herd::RefFrame::NDirections : static_cast<int>(entrydir), exitdir==Herd::RefFrame::Direction::NONE ? Herd::RefFrame::NDirections : static_cast<int>(exitdir));
 	
   //Check MC track entrance plane
   if( notfrombottom) {
-    if(calotrack->entrancePlane == Herd::RefFrame::Direction::Zneg) SetFilterResult(FilterResult::REJECT);
+    if(entrydir == Herd::RefFrame::Direction::Zneg) pass = false;
     } 
 
-  float calotracklengthx0=-1;
   if( !(entrydir==Herd::RefFrame::Direction::NONE && exitdir==Herd::RefFrame::Direction::NONE) ){
-	  _gcaloentry->SetPoint(_gcaloentry->GetN(), calotrack->entrance[Herd::RefFrame::Coo::X],calotrack->entrance[Herd::RefFrame::Coo::Y],calotrack->entrance[Herd::RefFrame::Coo::Z]);
-	  _gcaloexit->SetPoint(_gcaloexit->GetN(), calotrack->exit[Herd::RefFrame::Coo::X],calotrack->exit[Herd::RefFrame::Coo::Y],calotrack->exit[Herd::RefFrame::Coo::Z]);
-	  _hshowerlength[static_cast<int>(entrydir)][static_cast<int>(exitdir)]->Fill(calotrack->trackLengthCaloX0);
-    _hshowerlengthall->Fill(calotrack->trackLengthCaloX0);
-    calotracklengthx0 = calotrack->trackLengthCaloX0;
-
-    _processstore->mcTracklengthcalox0 = calotrack->trackLengthCaloX0;
-    _processstore->mcTracklengthlysox0 = calotrack->trackLengthLYSOX0;
-
-    _processstore->mcTrackcaloentry[0] = calotrack->entrance[Herd::RefFrame::Coo::X];
-    _processstore->mcTrackcaloentry[1] = calotrack->entrance[Herd::RefFrame::Coo::Y];
-    _processstore->mcTrackcaloentry[2] = calotrack->entrance[Herd::RefFrame::Coo::Z];
-    _processstore->mcTrackcaloexit[0] = calotrack->exit[Herd::RefFrame::Coo::X];
-    _processstore->mcTrackcaloexit[1] = calotrack->exit[Herd::RefFrame::Coo::Y];
-    _processstore->mcTrackcaloexit[2] = calotrack->exit[Herd::RefFrame::Coo::Z];
-    _processstore->mcTrackcaloentryplane = static_cast<int>(entrydir);
-    _processstore->mcTrackcaloexitplane = static_cast<int>(exitdir);
+	  _gcaloentry.Add(event.index, {{event.caloentry[0],event.caloentry[1],event.caloentry[2]}});
+	  _gcaloexit.Add(event.index, {{event.caloexit[0],event.caloexit[1],event.caloexit[2]}});
+	  _hshowerlength[static_cast<int>(entrydir)][static_cast<int>(exitdir)].Fill(event.tracklengthcalox0);
+    _hshowerlengthall.Fill(event.tracklengthcalox0);
+
+    if( processstore ){
+      processstore->mcTracklengthcalox0 = event.tracklengthcalox0;
+      processstore->mcTracklengthlysox0 = event.tracklengthlysox0;
+
+      processstore->mcTrackcaloentry[0] = event.caloentry[0];
+      processstore->mcTrackcaloentry[1] = event.caloentry[1];
+      processstore->mcTrackcaloentry[2] = event.caloentry[2];
+      processstore->mcTrackcaloexit[0] = event.caloexit[0];
+      processstore->mcTrackcaloexit[1] = event.caloexit[1];
+      processstore->mcTrackcaloexit[2] = event.caloexit[2];
+      processstore->mcTrackcaloentryplane = static_cast<int>(entrydir);
+      processstore->mcTrackcaloexitplane = static_cast<int>(exitdir);
+    }
 	  }
 
   //Check MC track length
-  if(calotrack->trackLengthCaloX0<mincalotrackx0) SetFilterResult(FilterResult::REJECT);
+  if(event.tracklengthcalox0<mincalotrackx0) pass = false;
 
-  return true;
+  return pass;
 }
 
 bool MCtruthProcess::Finalize() {
   const std::string routineName("MCtruthProcess::Finalize");
+  Herd::KernelRegistry::Instance().Drain();
+  Herd::KernelRegistry::Instance().Unregister(GetName());
 
   auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
   if (!globStore) {COUT(ERROR) << "Global data store not found." << ENDL;return false;}
 
-  globStore->AddObject(_hgencoo->GetName(), _hgencoo);
-  globStore->AddObject(_hgencthetaphi->GetName(),_hgencthetaphi);
-  globStore->AddObject(_ggencoo->GetName(),_ggencoo);
-  globStore->AddObject(_gcaloentry->GetName(),_gcaloentry);
-  globStore->AddObject(_gcaloexit->GetName(),_gcaloexit);
-  globStore->AddObject(_gdiscarded->GetName(),_gdiscarded);
-  globStore->AddObject(_hstkintersections->GetName(),_hstkintersections);
-  globStore->AddObject(_hshowerlengthall->GetName(), _hshowerlengthall);
-  globStore->AddObject(_hcaloentryexitdir->GetName(),_hcaloentryexitdir);
+  auto hgencoo = _hgencoo.ToROOT<TH3F>("hgencoo", "MCtruth Generation;X(cm);Y(cm);Z(cm)");
+  auto hgencthetaphi = UnfoldedThetaPhi();
+  auto hstkintersections = _hstkintersections.ToROOT<TH1F>("hstkintersections", "Inyersection of track with STK;Occurrence");
+  auto hshowerlengthall = _hshowerlengthall.ToROOT<TH1F>("hshowerlengthall", "Shower Lenght (X0) All");
+  auto hcaloentryexitdir = _hcaloentryexitdir.ToROOT<TH2F>("hcaloentryexitdir", "CALO Entry (X) - Exit (Y)");
+
+  //Graph points in event order, whatever the thread which filled them
+  auto gdiscarded = std::make_shared<TGraph>();
+  gdiscarded->SetNameTitle("gdiscarded","Discarded Events before simulated");
+  const auto &discarded = _gdiscarded.Sorted();
+  for(size_t ipoint=0; ipoint<discarded.size(); ipoint++) gdiscarded->SetPoint(ipoint, ipoint, discarded[ipoint][0]);
+  auto ggencoo = MakeGraph2D(_ggencoo, "ggencoo", "Generation Coordinates;X(cm);Y(cm);Z(cm)");
+  auto gcaloentry = MakeGraph2D(_gcaloentry, "gcaloentry", "CALO Entry point;X(cm);Y(cm);Z(cm)");
+  auto gcaloexit = MakeGraph2D(_gcaloexit, "gcaloexit", "CALO Exit point;X(cm);Y(cm);Z(cm)");
+
+  globStore->AddObject(hgencoo->GetName(), hgencoo);
+  globStore->AddObject(hgencthetaphi->GetName(),hgencthetaphi);
+  globStore->AddObject(ggencoo->GetName(),ggencoo);
+  globStore->AddObject(gcaloentry->GetName(),gcaloentry);
+  globStore->AddObject(gcaloexit->GetName(),gcaloexit);
+  globStore->AddObject(gdiscarded->GetName(),gdiscarded);
+  globStore->AddObject(hstkintersections->GetName(),hstkintersections);
+  globStore->AddObject(hshowerlengthall->GetName(), hshowerlengthall);
+  globStore->AddObject(hcaloentryexitdir->GetName(),hcaloentryexitdir);
   for(int indir=0; indir < Herd::RefFrame::NDirections; indir++){
     for(int outdir=0; outdir < Herd::RefFrame::NDirections; outdir++){
-      globStore->AddObject(_hshowerlength[indir][outdir]->GetName(), _hshowerlength[indir][outdir]);
+      auto hshowerlength = _hshowerlength[indir][outdir].ToROOT<TH1F>(Form("hshowerlength_%d_%d",indir,outdir), Form("Shower Lenght (X0) [%s-%s]",Herd::RefFrame::DirectionName[indir].c_str(),Herd::RefFrame::DirectionName[outdir].c_str()));
+      globStore->AddObject(hshowerlength->GetName(), hshowerlength);
     }
   } 
 
 
+  _timer.Publish(*globStore, GetName());
   return true;
 }
 
+std::shared_ptr<TGraph2D> MCtruthProcess::MakeGraph2D(Herd::ShardedPoints<3> &points, const char *name, const char *title){
+  auto graph = std::make_shared<TGraph2D>();
+  graph->SetNameTitle(name, title);
+  const auto &sorted = points.Sorted();
+  for(size_t ipoint=0; ipoint<sorted.size(); ipoint++) graph->SetPoint(ipoint, sorted[ipoint][0], sorted[ipoint][1], sorted[ipoint][2]);
+  return graph;
+}
+
+std::shared_ptr<TH2F> MCtruthProcess::UnfoldedThetaPhi() {
+  static const char *title = "MCtruth Generation;cos(#theta);Phi (rad)";
+  if( !_folding.Enabled() ) return _hgencthetaphi.ToROOT<TH2F>("hgencthetaphi", title);
+
+  //Every full-domain cell gets the counts of its folded cell shared among the images
+  auto &folded = _hgencthetaphi.Merged();
+  const int nctheta = _folding.FullPolarBins(folded.Axis<0>().NBins()), nphi = _folding.FullAzimuthBins(folded.Axis<1>().NBins());
+  const double order = _folding.Order();
+  auto hgencthetaphi = std::make_shared<TH2F>("hgencthetaphi", title, nctheta, -1, 1, nphi, -TMath::Pi(), +TMath::Pi());
+  for(int iphi=-1; iphi<=nphi; iphi++){
+    for(int ictheta=-1; ictheta<=nctheta; ictheta++){
+      const double count = folded.Contents().Count(folded.Cell(_folding.PolarBin(ictheta,nctheta), _folding.AzimuthBin(iphi,nphi)));
+      if( count==0 ) continue;
+      const double value = count/order;
+      const int bin = hgencthetaphi->GetBin(ictheta+1, iphi+1);
+      hgencthetaphi->SetBinContent(bin, value);
+      hgencthetaphi->SetBinError(bin, std::sqrt(value/order));
+    }
+  }
+  hgencthetaphi->SetEntries(folded.Entries());
+  return hgencthetaphi;
+}
+
 void MCtruthProcess::PrintCaloCubeMap(){
   const std::string routineName("MCtruthProcess::PrintCaloCubeMap");
   auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
@@ -216,7 +293,7 @@ MCtruthProcessStore::MCtruthProcessStore(const std::string &name) :
 }
 
   bool MCtruthProcessStore::Process() {
-  const std::string routineName("MCtruthProcessStore::Process");
+  static const std::string routineName("MCtruthProcessStore::Process");
   return true;
 }
   bool MCtruthProcessStore::Finalize() {
@@ -224,8 +301,6 @@ MCtruthProcessStore::MCtruthProcessStore(const std::string &name) :
   return true;
 }
 bool MCtruthProcessStore::Reset() {
-  const std::string routineName("MCtruthProcessStore::Finalize");
-
   mcNdiscarded = -1;
   for(int idir=0; idir<3; idir++) mcDir[idir] = -999.;
   for(int idir=0; idir<3; idir++) mcCoo[idir] = -999.;
@@ -10,6 +10,13 @@
 #include "dataobjects/StkIntersections.h"
 #include "dataobjects/CaloGeoParams.h"
 
+#include "Histo/AngleFolding.h"
+#include "Histo/ShardedHisto.h"
+#include "Histo/ShardedPoints.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/ProcessTimer.h"
+#include "Utils/StorePool.h"
+
 using namespace EA;
 
 class TH1F;
@@ -21,7 +28,7 @@ class TVector3;
 class MCtruthProcessStore;
 
 
-class MCtruthProcess : public Algorithm {
+class MCtruthProcess : public Algorithm, public Herd::AcceptanceKernel {
 public:
 
   MCtruthProcess(const std::string &name);
@@ -29,36 +36,51 @@ public:
   bool Process();
   bool Finalize();
 
+  bool ProcessEvent(const Herd::AcceptanceEvent &event);
+
 private:
 
-  //Store pointer
-  std::shared_ptr<MCtruthProcessStore> _processstore;
-  
+  //Fills the histograms, the graph points and (if not null) the event store, returns the filter decision
+  bool Evaluate(const Herd::AcceptanceEvent &event, MCtruthProcessStore *processstore);
+
   // Algorithm parameters
   bool filterenable;
   int minstkintersections;
   bool printcalocubemap;
   float mincalotrackx0;
   bool notfrombottom;
-
-  // Created global objects
-  // std::shared_ptr<TH1F> _histo; // Objects to be pushed on global store must be held by a shared_ptr
-  std::shared_ptr<TGraph> _gdiscarded;
-  std::shared_ptr<TH1F> _hstkintersections;
-  std::shared_ptr<TH2F> _hgencthetaphi;
-  std::shared_ptr<TH3F> _hgencoo;
-  std::shared_ptr<TGraph2D> _ggencoo;
-  std::shared_ptr<TGraph2D> _gcaloentry;
-  std::shared_ptr<TGraph2D> _gcaloexit;
-  std::shared_ptr<TH2F>_hcaloentryexitdir;
-  std::shared_ptr<TH1F>_hshowerlength[Herd::RefFrame::NDirections][Herd::RefFrame::NDirections];
-  std::shared_ptr<TH1F>_hshowerlengthall;
+  bool deferred; // Processing done by ParallelAcceptance
+  std::string folding; // Symmetry folding of hgencthetaphi: none, xy or xyz (see Herd::AngleFolding)
+  Herd::AngleFolding _folding;
+
+  // Histograms, sharded per thread and converted to ROOT objects in Finalize
+  typedef Herd::Histogram<Herd::Int64Storage, Herd::RegularAxis> Histo1D;
+  typedef Herd::Histogram<Herd::Int64Storage, Herd::RegularAxis, Herd::RegularAxis> Histo2D;
+  typedef Herd::Histogram<Herd::Int64Storage, Herd::RegularAxis, Herd::RegularAxis, Herd::RegularAxis> Histo3D;
+  typedef Herd::Histogram<Herd::Int64Storage, Herd::CategoryAxis, Herd::CategoryAxis> DirHisto2D;
+  Herd::ShardedHistogram<Histo1D> _hstkintersections;
+  Herd::ShardedHistogram<Histo2D> _hgencthetaphi;
+  Herd::ShardedHistogram<Histo3D> _hgencoo;
+  Herd::ShardedHistogram<DirHisto2D> _hcaloentryexitdir;
+  Herd::ShardedHistogram<Histo1D> _hshowerlength[Herd::RefFrame::NDirections][Herd::RefFrame::NDirections];
+  Herd::ShardedHistogram<Histo1D> _hshowerlengthall;
+
+  // Graph points, tagged with the event index and converted to ROOT graphs in Finalize
+  Herd::ShardedPoints<1> _gdiscarded;
+  Herd::ShardedPoints<3> _ggencoo;
+  Herd::ShardedPoints<3> _gcaloentry;
+  Herd::ShardedPoints<3> _gcaloexit;
 
   //std::shared_ptr<TH2F> _hgencoo;
 
   // Utility variables
     void PrintCaloCubeMap();
+  std::shared_ptr<TGraph2D> MakeGraph2D(Herd::ShardedPoints<3> &points, const char *name, const char *title);
+  std::shared_ptr<TH2F> UnfoldedThetaPhi(); // hgencthetaphi on the full direction sphere
 
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  Herd::StorePool<MCtruthProcessStore> _processstores; // A store of its own for every event, without allocating
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
 
   TVector3 InterceptX(double, const TVector3 &, const TVector3 &) const;
@@ -0,0 +1,248 @@
+// Example headers
+#include "AcceptanceMonitor.h"
+#include "mcEnergyHisto.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/PowerLaw.h"
+
+// Root headers
+#include "TH1D.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+RegisterAlgorithm(AcceptanceMonitor);
+
+AcceptanceMonitor::AcceptanceMonitor(const std::string &name) : Algorithm{name},
+																axispar{100., 1., 100000.},
+																logaxis{true},
+																momrange{-1., -1.},
+																index{-1},
+																selected("calo_filtered_fidvolume"),
+																precision{0.01},
+																minselected{100},
+																checkinterval{100000},
+																mode("report"),
+																_mode{Mode::Report},
+																_selected{nullptr},
+																_ngen{0},
+																_ngenstop{0},
+																_nevents{0},
+																_nrejected{0},
+																_nmonitored{0},
+																_nconverged{0},
+																perfcounters{false}
+{
+	DefineParameter("axispar", axispar);
+	DefineParameter("logaxis", logaxis);
+	DefineParameter("momrange", momrange);
+	DefineParameter("index", index);
+	DefineParameter("selected", selected);
+	DefineParameter("precision", precision);
+	DefineParameter("minselected", minselected);
+	DefineParameter("checkinterval", checkinterval);
+	DefineParameter("mode", mode);
+	DefineParameter("perfcounters", perfcounters);
+}
+
+bool AcceptanceMonitor::Initialize()
+{
+	const std::string routineName("AcceptanceMonitor::Initialize");
+
+	_evStore = GetDataStoreManager()->GetEventDataStore("evStore");
+	if (!_evStore)
+	{
+		COUT(ERROR) << "Event data store not found." << ENDL;
+		return false;
+	}
+
+	std::string errmsg;
+	if (!binning.Set(axispar, logaxis, "", errmsg))
+	{
+		COUT(ERROR) << errmsg << ENDL;
+		return false;
+	}
+	if (momrange.size() != 2 || momrange[0] <= 0 || momrange[1] <= 0)
+		momrange = {binning.Low(), binning.High()};
+	if (momrange[0] >= momrange[1])
+	{
+		COUT(ERROR) << "Invalid momentum range {" << momrange[0] << ", " << momrange[1] << "}" << ENDL;
+		return false;
+	}
+	if (mode == "report")
+		_mode = Mode::Report;
+	else if (mode == "stop")
+		_mode = Mode::Stop;
+	else if (mode == "skip")
+		_mode = Mode::Skip;
+	else
+	{
+		COUT(ERROR) << "Unknown mode " << mode << " (report, stop or skip)" << ENDL;
+		return false;
+	}
+	if (!(precision > 0) || minselected < 0 || checkinterval <= 0)
+	{
+		COUT(ERROR) << "precision and checkinterval must be positive, minselected not negative" << ENDL;
+		return false;
+	}
+	SetFilterStatus(_mode == Mode::Report ? FilterStatus::DISABLED : FilterStatus::ENABLED);
+
+	// Cells 0 and NBins() + 1 are the under/overflow, never monitored
+	const std::vector<double> &edges = binning.Edges();
+	_fraction.assign(binning.NBins() + 2, 0.);
+	_nmonitored = 0;
+	for (int bin = 0; bin < binning.NBins(); ++bin)
+	{
+		_fraction[bin + 1] = Herd::PowerLawFraction(edges[bin], edges[bin + 1], momrange[0], momrange[1], index);
+		if (_fraction[bin + 1] > 0)
+			++_nmonitored;
+	}
+	_frozen.assign(binning.NBins() + 2, 0);
+	_relerror.assign(binning.NBins() + 2, 1.);
+	_selected = nullptr;
+	_ngen = _ngenstop = _nevents = _nrejected = 0;
+	_nconverged = 0;
+
+	COUT(INFO) << "Target precision " << precision << " on the acceptance of " << selected << " in " << _nmonitored
+			   << " bins, mode " << mode << ENDL;
+	if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+	return true;
+}
+
+bool AcceptanceMonitor::Process()
+{
+	static const std::string routineName("AcceptanceMonitor::Process");
+	Herd::ProcessScope timing(_timer);
+	SetFilterResult(FilterResult::ACCEPT);
+
+	// The first check only looks up the selected histogram, whose algorithm is initialized after this one
+	if (_nevents % checkinterval == 0 && _nconverged < _nmonitored)
+		Check();
+	++_nevents;
+
+	static const std::string mctruthname("mcTruth");
+	auto mctruth = _evStore->GetObject<Herd::MCTruth>(mctruthname);
+	if (!mctruth || mctruth->primaries.empty())
+	{
+		COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
+		return false;
+	}
+	_ngen += mctruth->nDiscarded + 1;
+
+	bool reject = false;
+	if (_mode == Mode::Stop)
+		reject = _ngenstop > 0;
+	else if (_mode == Mode::Skip)
+		reject = _frozen[binning.FindBin(mctruth->primaries[0].initialMomentum.Mag()) + 1] > 0;
+	if (reject)
+	{
+		SetFilterResult(FilterResult::REJECT);
+		++_nrejected;
+	}
+
+	return true;
+}
+
+void AcceptanceMonitor::Check()
+{
+	static const std::string routineName("AcceptanceMonitor::Check");
+
+	if (!_selected)
+	{
+		_selected = mcEnergyHisto::Find(selected);
+		if (!_selected || _selected->GetBinning().Edges() != binning.Edges())
+		{
+			COUT(ERROR) << (_selected ? "The binning differs from the one of " : "No mcEnergyHisto named ") << selected
+						<< ": monitoring disabled" << ENDL;
+			_selected = nullptr;
+			_nmonitored = 0;
+			return;
+		}
+	}
+	if (_ngen == 0)
+		return;
+
+	// Counts drains the events still held by a deferred driver, so the selected counts and _ngen cover the same
+	// events and a bin frozen now gets the right denominator. After a stop the selection sees no more events
+	const unsigned long long ngen = (_mode == Mode::Stop && _ngenstop > 0) ? _ngenstop : _ngen;
+	if (!_selected->Counts(_counts))
+	{
+		COUT(ERROR) << "Selected counts not available inside a deferred batch, check skipped" << ENDL;
+		return;
+	}
+	const std::vector<double> &edges = binning.Edges();
+	for (int bin = 0; bin < binning.NBins(); ++bin)
+	{
+		const size_t cell = bin + 1;
+		if (_fraction[cell] == 0 || (_mode == Mode::Skip && _frozen[cell] > 0))
+			continue;
+		const double expected = ngen * _fraction[cell];
+		const double nsel = _counts[cell];
+		const double eps = std::min(1., nsel / expected);
+		_relerror[cell] = nsel > 0 ? std::sqrt((1. - eps) / nsel) : 1.;
+		if (_frozen[cell] == 0 && nsel >= minselected && _relerror[cell] <= precision)
+		{
+			_frozen[cell] = _ngen;
+			++_nconverged;
+			COUT(INFO) << "Bin [" << edges[bin] << ", " << edges[bin + 1] << ") converged after " << _ngen
+					   << " generated events: " << (unsigned long long)nsel << " selected, relative uncertainty "
+					   << _relerror[cell] << ENDL;
+		}
+	}
+	if (_nconverged == _nmonitored && _nmonitored > 0 && _ngenstop == 0)
+	{
+		_ngenstop = _ngen;
+		COUT(INFO) << "All the bins converged after " << _nevents << " events"
+				   << (_mode == Mode::Stop ? ", the following ones are rejected" : "") << ENDL;
+	}
+}
+
+bool AcceptanceMonitor::Finalize()
+{
+	const std::string routineName("AcceptanceMonitor::Finalize");
+
+	// Events still held by a deferred driver count for the final uncertainties
+	Herd::KernelRegistry::Instance().Drain();
+	if (_selected)
+		Check();
+
+	auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
+	if (!globStore)
+	{
+		COUT(ERROR) << "Global data store not found." << ENDL;
+		return false;
+	}
+
+	// Generated events seen by the selection in each bin
+	const std::vector<double> &edges = binning.Edges();
+	const std::string name = "h_" + GetName();
+	auto generated = std::make_shared<TH1D>(name.c_str(), name.c_str(), binning.NBins(), edges.data());
+	generated->GetXaxis()->SetTitle("MC Momentum (GV()");
+	unsigned long long ngen = _ngen;
+	if (_mode == Mode::Stop && _ngenstop > 0)
+		ngen = _ngenstop;
+	for (int bin = 0; bin < binning.NBins(); ++bin)
+	{
+		const size_t cell = bin + 1;
+		const unsigned long long nbin = (_mode == Mode::Skip && _frozen[cell] > 0) ? _frozen[cell] : ngen;
+		generated->SetBinContent(bin + 1, nbin * _fraction[cell]);
+	}
+	generated->SetEntries(ngen);
+	globStore->AddObject(generated->GetName(), generated);
+
+	// The relative uncertainties are not additive over jobs: they are only logged
+	int worst = -1;
+	for (int bin = 0; bin < binning.NBins(); ++bin)
+		if (_fraction[bin + 1] > 0 && (worst < 0 || _relerror[bin + 1] > _relerror[worst + 1]))
+			worst = bin;
+	COUT(INFO) << _nconverged << " of " << _nmonitored << " bins converged, " << _nrejected << " of " << _nevents
+			   << " events rejected" << ENDL;
+	if (worst >= 0)
+		COUT(INFO) << "Largest relative uncertainty " << _relerror[worst + 1] << " in bin [" << edges[worst] << ", "
+				   << edges[worst + 1] << ")" << ENDL;
+
+	_timer.Publish(*globStore, GetName());
+	return true;
+}
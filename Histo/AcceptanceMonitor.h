@@ -0,0 +1,83 @@
+#ifndef ACCEPTANCEMONITOR_H_
+#define ACCEPTANCEMONITOR_H_
+
+#include "algorithm/Algorithm.h"
+
+// HerdSoftware headers
+#include "dataobjects/MCTruth.h"
+
+#include "Binning.h"
+#include "Core/ProcessTimer.h"
+
+// C/C++ standard headers
+#include <string>
+#include <vector>
+
+using namespace EA;
+
+class mcEnergyHisto;
+
+/*! @brief Statistical precision of the acceptance per momentum bin during the run, and early termination.
+ *
+ * Put it first in the acceptance sequence, in place of mcGenSpectrum (same axispar, logaxis, momrange and index),
+ * with selected set to the name of the mcEnergyHisto of the final selection. Every checkinterval events the binomial
+ * relative uncertainty of the acceptance of each bin, sqrt((1 - eps) / nsel) with eps = nsel / ngen, is compared with
+ * precision; a bin converges when it is below precision with at least minselected selected events. Depending on mode:
+ * - "report": nothing changes, the convergence is only logged;
+ * - "stop": once all the bins converged every following event is rejected (the event loop cannot be ended from an
+ *   algorithm, but the rest of the sequence is skipped);
+ * - "skip": the events of converged bins are rejected, so the CPU goes to the bins still limited by statistics.
+ * Bins which the generation does not cover are not monitored.
+ *
+ * Since the rejected events are not seen by the selection, the generated spectrum of a bin is the expected count
+ * ngen * fraction with ngen the events generated up to its convergence: it is published as h_<name>, in the format
+ * of mcGenSpectrum, and is the generated histogram of the run (acceptanceBuilder -g h_<name>). In "report" mode it is
+ * the same as the one of mcGenSpectrum. Only counts are published, so the outputs of several jobs can be merged: the
+ * final uncertainty of each bin is the one of the acceptance computed by acceptanceBuilder from the merged h_<name> and
+ * selected histograms, and the largest one of a job is logged at Finalize.
+ *
+ * When the selection runs deferred, every check first has the ParallelAcceptance driver process the events it holds
+ * (a batch shorter than batchsize), so the selected counts include every event counted in ngen.
+ */
+class AcceptanceMonitor : public Algorithm {
+public:
+  AcceptanceMonitor(const std::string &name);
+  bool Initialize();
+  bool Process();
+  bool Finalize();
+
+private:
+  enum class Mode { Report, Stop, Skip };
+
+  // Updates the convergence of the bins from the selected counts
+  void Check();
+
+  std::vector<double> axispar;
+  Herd::Binning binning;
+  bool logaxis;
+  std::vector<double> momrange;  // Generation momentum range (default: the axis range)
+  double index;                  // Generation spectrum dN/dE ~ E^index (-1: log-uniform)
+  std::string selected;          // Name of the mcEnergyHisto of the selected events
+  double precision;              // Target relative uncertainty of the acceptance in every bin
+  int minselected;               // Selected events needed before a bin can converge
+  int checkinterval;             // Events between two checks
+  std::string mode;              // report, stop or skip
+
+  Mode _mode;
+  mcEnergyHisto *_selected;
+  std::vector<double> _fraction;                // Fraction of the generation in each bin (cells with under/overflow)
+  std::vector<unsigned long long> _frozen;      // Generated events when the bin converged (0: not converged)
+  std::vector<unsigned long long> _counts;      // Scratch for the selected counts
+  std::vector<double> _relerror;                // Last relative uncertainty of each bin
+  unsigned long long _ngen;
+  unsigned long long _ngenstop;                 // Generated events when all the bins converged (0: not yet)
+  unsigned long long _nevents, _nrejected;
+  size_t _nmonitored, _nconverged;
+
+  // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
+  observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
+};
+
+#endif /* ACCEPTANCEMONITOR_H_ */
@@ -0,0 +1,158 @@
+/*! @file AngleFolding.h AngleFolding class declaration and implementation. */
+
+#ifndef HERD_ANGLEFOLDING_H_
+#define HERD_ANGLEFOLDING_H_
+
+// C/C++ standard headers
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace Herd
+{
+
+	/*! @brief Folding of arrival directions into the fundamental domain of the Calo symmetries.
+	 * @class AngleFolding AngleFolding.h
+	 *
+	 * The octagonal prism of CaloGeomFidVolumeAlgo is symmetric under x -> -x and y -> -y, and the prism itself under
+	 * the reflection through its mid plane. Direction histograms (cos(theta), phi) of a study which only depends on
+	 * that geometry can then be filled in the fundamental domain and unfolded at export, so every filled cell
+	 * collects the entries of all its images:
+	 * - "xy": phi folded into [0, pi/2], order 4;
+	 * - "xyz": also cos(theta) folded into [-1, 0] (downgoing), order 8.
+	 * The up/down folding ignores everything which tells the top from the bottom (e.g. notfrombottom, the STK), and
+	 * both ignore any asymmetric detector effect.
+	 *
+	 * The full axes must cover [-1, 1] and [-pi, pi] with a number of bins such that the domain boundaries are bin
+	 * edges; each full bin is then the image of exactly one folded bin, whose counts are shared evenly among its
+	 * Order() images by the unfolding.
+	 */
+	class AngleFolding
+	{
+	public:
+		enum class Mode
+		{
+			None,
+			XY,
+			XYZ
+		};
+
+		AngleFolding() : _mode{Mode::None}, _maxcostheta{1.}, _maxphi{M_PI} {}
+
+		/*! @brief Sets the mode from its name: "none", "xy" or "xyz". */
+		bool Set(const std::string &mode, std::string &errmsg)
+		{
+			if (mode == "none" || mode.empty())
+				_mode = Mode::None;
+			else if (mode == "xy")
+				_mode = Mode::XY;
+			else if (mode == "xyz")
+				_mode = Mode::XYZ;
+			else
+			{
+				errmsg = "Unknown folding mode " + mode + " (none, xy or xyz)";
+				return false;
+			}
+			return true;
+		}
+
+		Mode GetMode() const { return _mode; }
+		bool Enabled() const { return _mode != Mode::None; }
+
+		/*! @brief Number of full-domain images of the fundamental domain. */
+		int Order() const { return _mode == Mode::None ? 1 : (_mode == Mode::XY ? 4 : 8); }
+
+		/*! @brief Replaces the full (nbins, low, high) axes of cos(theta) and phi with the folded ones.
+		 *
+		 * @return false if the full axes do not cover the whole direction sphere with symmetric bin edges.
+		 */
+		bool FoldAxes(std::vector<double> &polar_axispar, std::vector<double> &azimuth_axispar, std::string &errmsg) const
+		{
+			if (_mode == Mode::None)
+				return true;
+			if (azimuth_axispar.size() != 3 || std::fabs(azimuth_axispar[1] + M_PI) > 1e-6 ||
+				std::fabs(azimuth_axispar[2] - M_PI) > 1e-6 || (int)azimuth_axispar[0] % 4 != 0)
+			{
+				errmsg = "Folding needs an azimuth axis on [-pi, pi] with a multiple of 4 bins";
+				return false;
+			}
+			azimuth_axispar = {azimuth_axispar[0] / 4, 0., M_PI / 2};
+			if (_mode == Mode::XYZ)
+			{
+				if (polar_axispar.size() != 3 || std::fabs(polar_axispar[1] + 1.) > 1e-9 ||
+					std::fabs(polar_axispar[2] - 1.) > 1e-9 || (int)polar_axispar[0] % 2 != 0)
+				{
+					errmsg = "Up/down folding needs a polar axis on [-1, 1] with an even number of bins";
+					return false;
+				}
+				polar_axispar = {polar_axispar[0] / 2, -1., 0.};
+			}
+			return true;
+		}
+
+		/*! @brief Number of bins of the full cos(theta) axis whose folded axis has foldedbins bins. */
+		int FullPolarBins(int foldedbins) const { return _mode == Mode::XYZ ? 2 * foldedbins : foldedbins; }
+
+		/*! @brief Number of bins of the full phi axis whose folded axis has foldedbins bins. */
+		int FullAzimuthBins(int foldedbins) const { return _mode == Mode::None ? foldedbins : 4 * foldedbins; }
+
+		/*! @brief Upper edges of the folded axes as used by their bin lookup, so folded values never overflow. */
+		void SetUpperEdges(double polarhigh, double azimuthhigh)
+		{
+			_maxcostheta = polarhigh;
+			_maxphi = azimuthhigh;
+		}
+
+		/*! @brief Maps a direction into the fundamental domain. */
+		void Fold(double &costheta, double &phi) const
+		{
+			if (_mode == Mode::None)
+				return;
+			phi = std::fabs(phi);
+			if (phi > M_PI / 2)
+				phi = M_PI - phi;
+			if (phi >= _maxphi)
+				phi = std::nextafter(_maxphi, 0.);
+			if (_mode == Mode::XYZ)
+			{
+				if (costheta > 0)
+					costheta = -costheta;
+				if (costheta >= _maxcostheta)
+					costheta = std::nextafter(_maxcostheta, -1.);
+			}
+		}
+
+		/*! @brief Folded bin of the bin of a full cos(theta) axis with nbins bins (under/overflow included). */
+		int PolarBin(int bin, int nbins) const
+		{
+			if (_mode != Mode::XYZ)
+				return bin;
+			if (bin < 0)
+				return -1;
+			if (bin >= nbins)
+				return nbins / 2;
+			return bin < nbins / 2 ? bin : nbins - 1 - bin;
+		}
+
+		/*! @brief Folded bin of the bin of a full phi axis with nbins bins (under/overflow included). */
+		int AzimuthBin(int bin, int nbins) const
+		{
+			if (_mode == Mode::None)
+				return bin;
+			const int quarter = nbins / 4;
+			if (bin < 0)
+				return -1;
+			if (bin >= nbins)
+				return quarter;
+			// Quarters [-pi, -pi/2) and [0, pi/2) are translated, the other two reflected
+			return (bin / quarter) % 2 == 0 ? bin % quarter : quarter - 1 - bin % quarter;
+		}
+
+	private:
+		Mode _mode;
+		double _maxcostheta, _maxphi;
+	};
+
+} // namespace Herd
+
+#endif /* HERD_ANGLEFOLDING_H_ */
@@ -0,0 +1,63 @@
+/*! @file Binning.cpp Binning class implementation. */
+
+#include "Binning.h"
+
+namespace Herd
+{
+
+	Binning::Binning() : _nbins{1}, _logaxis{false}, _origin{0}, _invwidth{1}, _edges{0., 1.} {}
+
+	bool Binning::Set(const std::vector<double> &axispar, bool logaxis, const std::string &axisname, std::string &errmsg)
+	{
+		const std::string axis = axisname.empty() ? std::string("") : axisname + " ";
+
+		if (axispar.size() != 3)
+		{
+			errmsg = "The " + axis + "axis must be specified by exactly 3 parameters";
+			return false;
+		}
+		if ((float)((int)(axispar[0])) != axispar[0])
+		{
+			errmsg = "The number of " + axis + "bins is not an integer.";
+			return false;
+		}
+		if (axispar[0] <= 0)
+		{
+			errmsg = "The number of " + axis + "bins is not a positive value.";
+			return false;
+		}
+		if (axispar[1] >= axispar[2])
+		{
+			errmsg = "The lower " + axis + "axis limit is greater or equal to the upper limit.";
+			return false;
+		}
+		if (logaxis && axispar[1] <= 0)
+		{
+			errmsg = "The lower " + axis + "axis limit must be positive for a logarithmic axis.";
+			return false;
+		}
+
+		_nbins = (int)axispar[0];
+		_logaxis = logaxis;
+		_edges.resize(_nbins + 1);
+		if (_logaxis)
+		{
+			double log_interval = (log10(axispar[2]) - log10(axispar[1])) / _nbins;
+			for (auto bIdx = 0; bIdx <= _nbins; ++bIdx)
+				_edges[bIdx] = pow(10, log10(axispar[1]) + bIdx * log_interval);
+			_origin = std::log2(axispar[1]);
+			_invwidth = _nbins / (std::log2(axispar[2]) - _origin);
+		}
+		else
+		{
+			double interval = (axispar[2] - axispar[1]) / _nbins;
+			for (auto bIdx = 0; bIdx <= _nbins; ++bIdx)
+				_edges[bIdx] = axispar[1] + bIdx * interval;
+			_origin = axispar[1];
+			_invwidth = _nbins / (axispar[2] - axispar[1]);
+		}
+
+		return true;
+	}
+
+} // namespace Herd
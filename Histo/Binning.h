@@ -0,0 +1,94 @@
+/*! @file Binning.h Binning class declaration. */
+
+#ifndef HERD_BINNING_H_
+#define HERD_BINNING_H_
+
+// C/C++ standard headers
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Herd
+{
+
+	/*! @brief Uniform binning on a linear or logarithmic axis with constant-time bin lookup.
+	 * @class Binning Binning.h
+	 *
+	 * The axis is defined by the usual axispar triple (nbins, low, high) and a log flag. FindBin computes the bin
+	 * index in closed form (for log axes from the exponent bits of the value and a short polynomial for the mantissa)
+	 * and then corrects it against the stored edges, so the result always agrees with a binary search on Edges(),
+	 * i.e. with the bin a TH1 built from Edges() would assign. Values below the lower edge give -1 (underflow),
+	 * values at or above the upper edge and NaN give NBins() (overflow).
+	 */
+	class Binning
+	{
+	public:
+		Binning();
+
+		/*! @brief Validates the axis parameters and builds the binning.
+		 *
+		 * @param axispar The (nbins, low, high) triple.
+		 * @param logaxis If true the bins are uniform in log10.
+		 * @param axisname Name of the axis used in the error message (e.g. "energy").
+		 * @param errmsg Filled with the reason of the failure.
+		 * @return false if the parameters do not define a valid axis.
+		 */
+		bool Set(const std::vector<double> &axispar, bool logaxis, const std::string &axisname, std::string &errmsg);
+
+		/*! @brief Index of the bin containing x, in [-1, NBins()]. */
+		int FindBin(double x) const
+		{
+			if (!(x < _edges.back()))
+				return _nbins; // Overflow and NaN
+			if (x < _edges.front())
+				return -1;
+			int bin = EstimateBin(x);
+			while (x < _edges[bin])
+				--bin;
+			while (x >= _edges[bin + 1])
+				++bin;
+			return bin;
+		}
+
+		/*! @brief Closed-form estimate of the bin of an x inside the axis, within one bin of FindBin(x). */
+		int EstimateBin(double x) const
+		{
+			const int bin = (int)((Coordinate(x) - _origin) * _invwidth);
+			return bin < 0 ? 0 : (bin < _nbins ? bin : _nbins - 1);
+		}
+
+		int NBins() const { return _nbins; }
+		double Low() const { return _edges.front(); }
+		double High() const { return _edges.back(); }
+		bool IsLog() const { return _logaxis; }
+		const std::vector<double> &Edges() const { return _edges; }
+
+	private:
+		/*! @brief Axis coordinate of x: x itself, or an approximation of log2(x) accurate to a few 1e-3. */
+		double Coordinate(double x) const
+		{
+			if (!_logaxis)
+				return x;
+			uint64_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			const int exponent = (int)((bits >> 52) & 0x7ff);
+			if (exponent == 0)
+				return std::log2(x); // Subnormal
+			bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+			double mantissa;
+			std::memcpy(&mantissa, &bits, sizeof(mantissa));
+			return (exponent - 1023) + (-0.34484843 * mantissa + 2.02466578) * mantissa - 1.67487759;
+		}
+
+		int _nbins;
+		bool _logaxis;
+		double _origin;
+		double _invwidth;
+		std::vector<double> _edges;
+	};
+
+} // namespace Herd
+
+#endif /* HERD_BINNING_H_ */
@@ -0,0 +1,501 @@
+/*! @file HistoEngine.h Compile-time-typed histograms converted to ROOT only at the end of the job. */
+
+#ifndef HERD_HISTOENGINE_H_
+#define HERD_HISTOENGINE_H_
+
+#include "Binning.h"
+
+// Root headers
+#include "TH1.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Herd
+{
+
+	/* ---------------------------------------------------------------------------------------------------------------
+	 * Axes
+	 *
+	 * An axis maps a value to a bin index in [-1, NBins()], -1 being the underflow and NBins() the overflow (NaN
+	 * included), and describes itself for the conversion to a ROOT TAxis.
+	 * -------------------------------------------------------------------------------------------------------------*/
+
+	/*! @brief Uniform bins on a linear axis, closed-form lookup. */
+	class RegularAxis
+	{
+	public:
+		RegularAxis() : RegularAxis(1, 0., 1.) {}
+		RegularAxis(int nbins, double low, double high) : _nbins{nbins}, _low{low}, _high{high}, _invwidth{nbins / (high - low)} {}
+
+		int FindBin(double x) const
+		{
+			if (!(x < _high))
+				return _nbins;
+			if (x < _low)
+				return -1;
+			int bin = (int)((x - _low) * _invwidth);
+			return bin < _nbins ? bin : _nbins - 1;
+		}
+
+		int NBins() const { return _nbins; }
+		bool IsUniform() const { return true; }
+		double Low() const { return _low; }
+		double High() const { return _high; }
+		std::vector<double> Edges() const
+		{
+			std::vector<double> edges(_nbins + 1);
+			for (int bIdx = 0; bIdx <= _nbins; ++bIdx)
+				edges[bIdx] = _low + bIdx * (_high - _low) / _nbins;
+			return edges;
+		}
+		void Decorate(TAxis *) const {}
+
+	private:
+		int _nbins;
+		double _low;
+		double _high;
+		double _invwidth;
+	};
+
+	/*! @brief Axis backed by a Binning, linear or logarithmic as chosen at run time. */
+	class BinningAxis
+	{
+	public:
+		BinningAxis() {}
+		explicit BinningAxis(const Binning &binning) : _binning(binning) {}
+
+		int FindBin(double x) const { return _binning.FindBin(x); }
+
+		int NBins() const { return _binning.NBins(); }
+		bool IsUniform() const { return !_binning.IsLog(); }
+		double Low() const { return _binning.Low(); }
+		double High() const { return _binning.High(); }
+		const std::vector<double> &Edges() const { return _binning.Edges(); }
+		void Decorate(TAxis *) const {}
+
+	private:
+		Binning _binning;
+	};
+
+	/*! @brief Uniform bins in log10, lookup from the exponent bits (see Binning). */
+	class LogAxis : public BinningAxis
+	{
+	public:
+		LogAxis() {}
+		LogAxis(int nbins, double low, double high) : BinningAxis(MakeBinning(nbins, low, high)) {}
+
+	private:
+		static Binning MakeBinning(int nbins, double low, double high)
+		{
+			Binning binning;
+			std::string errmsg;
+			binning.Set({(double)nbins, low, high}, true, "", errmsg);
+			return binning;
+		}
+	};
+
+	/*! @brief LogAxis whose ROOT counterpart is a regular axis in log10(x); the filled value is still x. */
+	class Log10Axis : public LogAxis
+	{
+	public:
+		Log10Axis() {}
+		Log10Axis(int nbins, double low, double high) : LogAxis(nbins, low, high) {}
+
+		bool IsUniform() const { return true; }
+		double Low() const { return std::log10(LogAxis::Low()); }
+		double High() const { return std::log10(LogAxis::High()); }
+		std::vector<double> Edges() const
+		{
+			std::vector<double> edges(LogAxis::Edges());
+			for (auto &edge : edges)
+				edge = std::log10(edge);
+			return edges;
+		}
+	};
+
+	/*! @brief Arbitrary increasing edges, binary-search lookup. */
+	class VariableAxis
+	{
+	public:
+		VariableAxis() : _edges{0., 1.} {}
+		explicit VariableAxis(std::vector<double> edges) : _edges(std::move(edges)) {}
+
+		int FindBin(double x) const
+		{
+			if (!(x < _edges.back()))
+				return NBins();
+			return (int)(std::upper_bound(_edges.begin(), _edges.end(), x) - _edges.begin()) - 1;
+		}
+
+		int NBins() const { return (int)_edges.size() - 1; }
+		bool IsUniform() const { return false; }
+		double Low() const { return _edges.front(); }
+		double High() const { return _edges.back(); }
+		const std::vector<double> &Edges() const { return _edges; }
+		void Decorate(TAxis *) const {}
+
+	private:
+		std::vector<double> _edges;
+	};
+
+	/*! @brief Integer categories 0..N-1 with optional labels; bin i is centred on i. */
+	class CategoryAxis
+	{
+	public:
+		CategoryAxis() : _ncategories{1} {}
+		explicit CategoryAxis(int ncategories, std::vector<std::string> labels = std::vector<std::string>())
+			: _ncategories{ncategories}, _labels(std::move(labels)) {}
+
+		int FindBin(int category) const
+		{
+			if (category < 0)
+				return -1;
+			return category < _ncategories ? category : _ncategories;
+		}
+
+		int NBins() const { return _ncategories; }
+		bool IsUniform() const { return true; }
+		double Low() const { return -0.5; }
+		double High() const { return _ncategories - 0.5; }
+		std::vector<double> Edges() const
+		{
+			std::vector<double> edges(_ncategories + 1);
+			for (int bIdx = 0; bIdx <= _ncategories; ++bIdx)
+				edges[bIdx] = bIdx - 0.5;
+			return edges;
+		}
+		void Decorate(TAxis *axis) const
+		{
+			for (size_t bIdx = 0; bIdx < _labels.size() && bIdx < (size_t)_ncategories; ++bIdx)
+				axis->SetBinLabel(bIdx + 1, _labels[bIdx].c_str());
+		}
+
+	private:
+		int _ncategories;
+		std::vector<std::string> _labels;
+	};
+
+	/* ---------------------------------------------------------------------------------------------------------------
+	 * Storages
+	 *
+	 * Fill(i) adds one unit entry, Fill(i, w) a weighted one, AddRun(i, n, sumw, sumw2) the coalesced contribution of
+	 * n buffered entries.
+	 * -------------------------------------------------------------------------------------------------------------*/
+
+	/*! @brief Exact event counts. Weighted fills are not available. */
+	class Int64Storage
+	{
+	public:
+		static const bool weighted = false;
+
+		void Resize(size_t ncells) { _counts.assign(ncells, 0); }
+		size_t Size() const { return _counts.size(); }
+		void Fill(size_t cell) { ++_counts[cell]; }
+		void AddRun(size_t cell, uint64_t n, double, double) { _counts[cell] += n; }
+		void Merge(const Int64Storage &other)
+		{
+			for (size_t cell = 0; cell < _counts.size(); ++cell)
+				_counts[cell] += other._counts[cell];
+		}
+		int64_t Count(size_t cell) const { return _counts[cell]; }
+		double Value(size_t cell) const { return (double)_counts[cell]; }
+		double Variance(size_t cell) const { return (double)_counts[cell]; }
+
+	private:
+		std::vector<int64_t> _counts;
+	};
+
+	/*! @brief Sum of weights, variance taken as the content (as a TH1 without Sumw2). */
+	class DoubleStorage
+	{
+	public:
+		static const bool weighted = false;
+
+		void Resize(size_t ncells) { _sumw.assign(ncells, 0.); }
+		size_t Size() const { return _sumw.size(); }
+		void Fill(size_t cell) { _sumw[cell] += 1.; }
+		void Fill(size_t cell, double w) { _sumw[cell] += w; }
+		void AddRun(size_t cell, uint64_t, double sumw, double) { _sumw[cell] += sumw; }
+		void Merge(const DoubleStorage &other)
+		{
+			for (size_t cell = 0; cell < _sumw.size(); ++cell)
+				_sumw[cell] += other._sumw[cell];
+		}
+		double Value(size_t cell) const { return _sumw[cell]; }
+		double Variance(size_t cell) const { return _sumw[cell]; }
+
+	private:
+		std::vector<double> _sumw;
+	};
+
+	/*! @brief Sum of weights and of squared weights (as a TH1 with Sumw2). */
+	class WeightedStorage
+	{
+	public:
+		static const bool weighted = true;
+
+		void Resize(size_t ncells)
+		{
+			_sumw.assign(ncells, 0.);
+			_sumw2.assign(ncells, 0.);
+		}
+		size_t Size() const { return _sumw.size(); }
+		void Fill(size_t cell) { Fill(cell, 1.); }
+		void Fill(size_t cell, double w)
+		{
+			_sumw[cell] += w;
+			_sumw2[cell] += w * w;
+		}
+		void AddRun(size_t cell, uint64_t, double sumw, double sumw2)
+		{
+			_sumw[cell] += sumw;
+			_sumw2[cell] += sumw2;
+		}
+		void Merge(const WeightedStorage &other)
+		{
+			for (size_t cell = 0; cell < _sumw.size(); ++cell)
+			{
+				_sumw[cell] += other._sumw[cell];
+				_sumw2[cell] += other._sumw2[cell];
+			}
+		}
+		double Value(size_t cell) const { return _sumw[cell]; }
+		double Variance(size_t cell) const { return _sumw2[cell]; }
+
+	private:
+		std::vector<double> _sumw;
+		std::vector<double> _sumw2;
+	};
+
+	/* ---------------------------------------------------------------------------------------------------------------
+	 * Histogram
+	 * -------------------------------------------------------------------------------------------------------------*/
+
+	/*! @brief N-dimensional histogram with compile-time axes and storage.
+	 * @class Histogram HistoEngine.h
+	 *
+	 * Cells include under/overflow on every axis and are laid out as the global bins of the equivalent TH1/TH2/TH3
+	 * (first axis running fastest), so the conversion in ToROOT is a straight copy. Fill is an inlined index
+	 * computation plus one increment, without virtual calls or statistics bookkeeping.
+	 *
+	 * BufferFill/BufferFillWeighted only record the cell index; when the buffer is full (or at Flush) the indices are
+	 * sorted and each run of equal indices is added at once. This keeps the writes to large, sparsely hit histograms
+	 * sequential. Buffered and direct fills can be mixed; the buffer must be flushed before reading the contents
+	 * (ToROOT and Merge do it).
+	 */
+	template <class Storage, class... Axes>
+	class Histogram
+	{
+	public:
+		typedef Storage storage_type;
+		static const size_t Rank = sizeof...(Axes);
+		static_assert(Rank >= 1 && Rank <= 3, "Histograms must have between 1 and 3 axes");
+
+		Histogram() : Histogram(Axes()...) {}
+		explicit Histogram(Axes... axes) : _axes(axes...), _entries{0}, _buffersize{4096} { Init(std::index_sequence_for<Axes...>()); }
+
+		/*! @brief Sets the number of buffered entries triggering a flush. */
+		void SetBufferSize(size_t buffersize) { _buffersize = buffersize > 0 ? buffersize : 1; }
+
+		template <class... X>
+		void Fill(X... x)
+		{
+			_storage.Fill(CellOf(x...));
+			++_entries;
+		}
+
+		template <class... X>
+		void FillWeighted(double w, X... x)
+		{
+			_storage.Fill(CellOf(x...), w);
+			++_entries;
+		}
+
+		template <class... X>
+		void BufferFill(X... x)
+		{
+			_buffer.push_back(CellOf(x...));
+			if (_buffer.size() >= _buffersize)
+				Flush();
+		}
+
+		template <class... X>
+		void BufferFillWeighted(double w, X... x)
+		{
+			_wbuffer.emplace_back(CellOf(x...), w);
+			if (_wbuffer.size() >= _buffersize)
+				Flush();
+		}
+
+		/*! @brief Cell index of the given values, to be used with FillCells. */
+		template <class... X>
+		size_t Locate(X... x) const { return CellOf(x...); }
+
+		/*! @brief Adds one unit entry per element of cells (sorted in place, then cleared). */
+		void FillCells(std::vector<size_t> &cells)
+		{
+			std::sort(cells.begin(), cells.end());
+			for (size_t begin = 0, end = 0; begin < cells.size(); begin = end)
+			{
+				while (end < cells.size() && cells[end] == cells[begin])
+					++end;
+				_storage.AddRun(cells[begin], end - begin, (double)(end - begin), (double)(end - begin));
+			}
+			_entries += cells.size();
+			cells.clear();
+		}
+
+		/*! @brief Adds the buffered entries to the storage. */
+		void Flush()
+		{
+			FillCells(_buffer);
+			if (!_wbuffer.empty())
+			{
+				std::sort(_wbuffer.begin(), _wbuffer.end());
+				for (size_t begin = 0, end = 0; begin < _wbuffer.size(); begin = end)
+				{
+					double sumw = 0., sumw2 = 0.;
+					for (; end < _wbuffer.size() && _wbuffer[end].first == _wbuffer[begin].first; ++end)
+					{
+						sumw += _wbuffer[end].second;
+						sumw2 += _wbuffer[end].second * _wbuffer[end].second;
+					}
+					_storage.AddRun(_wbuffer[begin].first, end - begin, sumw, sumw2);
+				}
+				_entries += _wbuffer.size();
+				_wbuffer.clear();
+			}
+		}
+
+		/*! @brief Adds the contents of another histogram with the same axes. */
+		void Merge(Histogram &other)
+		{
+			Flush();
+			other.Flush();
+			_storage.Merge(other._storage);
+			_entries += other._entries;
+		}
+
+		/*! @brief Linear cell index of the given per-axis bins (each in [-1, NBins()]). */
+		template <class... B>
+		size_t Cell(B... bins) const
+		{
+			static_assert(sizeof...(B) == Rank, "One bin per axis is needed");
+			const int bin[] = {bins...};
+			size_t cell = 0;
+			for (size_t iaxis = Rank; iaxis-- > 0;)
+				cell = cell * _extent[iaxis] + (size_t)(bin[iaxis] + 1);
+			return cell;
+		}
+
+		template <size_t I>
+		const typename std::tuple_element<I, std::tuple<Axes...>>::type &Axis() const { return std::get<I>(_axes); }
+		const Storage &Contents() const { return _storage; }
+		size_t NCells() const { return _storage.Size(); }
+		uint64_t Entries() const { return _entries + _buffer.size() + _wbuffer.size(); }
+
+		/*! @brief Creates the equivalent ROOT histogram (TH1F/TH1D for one axis, TH2F/TH2D for two, TH3F/TH3D for three). */
+		template <class TH>
+		std::shared_ptr<TH> ToROOT(const std::string &name, const std::string &title)
+		{
+			Flush();
+			std::shared_ptr<TH> histo(BookAxes<TH>(name.c_str(), title.c_str(), std::index_sequence_for<Axes...>()));
+			TAxis *rootaxes[3] = {histo->GetXaxis(), histo->GetYaxis(), histo->GetZaxis()};
+			Decorate(rootaxes, std::index_sequence_for<Axes...>());
+			if (Storage::weighted)
+				histo->Sumw2();
+			for (size_t cell = 0; cell < _storage.Size(); ++cell)
+			{
+				if (_storage.Value(cell) != 0.)
+					histo->SetBinContent((int)cell, _storage.Value(cell));
+				if (Storage::weighted && _storage.Variance(cell) != 0.)
+					histo->SetBinError((int)cell, std::sqrt(_storage.Variance(cell)));
+			}
+			histo->SetEntries(_entries);
+			return histo;
+		}
+
+	private:
+		template <size_t... I>
+		void Init(std::index_sequence<I...>)
+		{
+			const size_t extent[] = {(size_t)(std::get<I>(_axes).NBins() + 2)...};
+			size_t ncells = 1;
+			for (size_t iaxis = 0; iaxis < Rank; ++iaxis)
+			{
+				_extent[iaxis] = extent[iaxis];
+				ncells *= extent[iaxis];
+			}
+			_storage.Resize(ncells);
+		}
+
+		template <class... X>
+		size_t CellOf(X... x) const
+		{
+			static_assert(sizeof...(X) == Rank, "One value per axis is needed");
+			return CellOf(std::index_sequence_for<Axes...>(), x...);
+		}
+
+		template <size_t... I, class... X>
+		size_t CellOf(std::index_sequence<I...>, X... x) const
+		{
+			return Cell(std::get<I>(_axes).FindBin(x)...);
+		}
+
+		template <size_t... I>
+		void Decorate(TAxis **rootaxes, std::index_sequence<I...>) const
+		{
+			const int dummy[] = {(std::get<I>(_axes).Decorate(rootaxes[I]), 0)...};
+			(void)dummy;
+		}
+
+		template <class TH, class A>
+		static TH *Book(const char *name, const char *title, const A &a)
+		{
+			if (a.IsUniform())
+				return new TH(name, title, a.NBins(), a.Low(), a.High());
+			std::vector<double> ea(a.Edges());
+			return new TH(name, title, a.NBins(), &ea[0]);
+		}
+		template <class TH, class A, class B>
+		static TH *Book(const char *name, const char *title, const A &a, const B &b)
+		{
+			if (a.IsUniform() && b.IsUniform())
+				return new TH(name, title, a.NBins(), a.Low(), a.High(), b.NBins(), b.Low(), b.High());
+			std::vector<double> ea(a.Edges()), eb(b.Edges());
+			return new TH(name, title, a.NBins(), &ea[0], b.NBins(), &eb[0]);
+		}
+		template <class TH, class A, class B, class C>
+		static TH *Book(const char *name, const char *title, const A &a, const B &b, const C &c)
+		{
+			if (a.IsUniform() && b.IsUniform() && c.IsUniform())
+				return new TH(name, title, a.NBins(), a.Low(), a.High(), b.NBins(), b.Low(), b.High(), c.NBins(), c.Low(), c.High());
+			std::vector<double> ea(a.Edges()), eb(b.Edges()), ec(c.Edges());
+			return new TH(name, title, a.NBins(), &ea[0], b.NBins(), &eb[0], c.NBins(), &ec[0]);
+		}
+		template <class TH, size_t... I>
+		TH *BookAxes(const char *name, const char *title, std::index_sequence<I...>) const
+		{
+			return Book<TH>(name, title, std::get<I>(_axes)...);
+		}
+
+		std::tuple<Axes...> _axes;
+		size_t _extent[Rank];
+		Storage _storage;
+		uint64_t _entries;
+		size_t _buffersize;
+		std::vector<size_t> _buffer;
+		std::vector<std::pair<size_t, double>> _wbuffer;
+	};
+
+} // namespace Herd
+
+#endif /* HERD_HISTOENGINE_H_ */
@@ -0,0 +1,181 @@
+/*! @file ShardedHisto.h Per-thread histogram shards merged deterministically. */
+
+#ifndef HERD_SHARDEDHISTO_H_
+#define HERD_SHARDEDHISTO_H_
+
+#include "HistoEngine.h"
+#include "Utils/ThreadIndex.h"
+
+// C/C++ standard headers
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Herd
+{
+
+	/*! @brief Histogram filled concurrently through one shard per thread.
+	 * @class ShardedHistogram ShardedHisto.h
+	 *
+	 * Fill picks the shard of the calling thread (see CurrentThreadIndex), FillShard takes it explicitly: a given
+	 * shard must only be filled by one thread at a time. Shard indices from MaxShards on all go to one shared overflow
+	 * shard filled under a lock, so more threads than shards only slow the fills down. Merged adds the shards in shard order and returns the
+	 * result. Only integer counts are supported, so the merged contents do not depend on which thread filled which
+	 * entry, and the output is identical for any number of threads.
+	 *
+	 * Two memory policies are available:
+	 * - Dense: every shard holds a full copy of the bins. Fills never synchronize; memory grows with the number of
+	 *   threads times the histogram size.
+	 * - Buffered: every shard holds at most buffersize cell indices; when full they are added to the single merged
+	 *   histogram under a lock. Memory is one histogram plus a bounded buffer per thread, so this is the policy for
+	 *   large histograms.
+	 */
+	template <class H>
+	class ShardedHistogram
+	{
+	public:
+		static_assert(std::is_same<typename H::storage_type, Int64Storage>::value,
+					  "Sharded histograms need integer storage for an order-independent merge");
+
+		enum class Policy
+		{
+			Dense,
+			Buffered
+		};
+		static const unsigned int MaxShards = MaxThreadShards;
+
+		ShardedHistogram() : _policy{Policy::Dense}, _buffersize{65536}
+		{
+			for (auto &shard : _shards)
+				shard.store(nullptr, std::memory_order_relaxed);
+		}
+
+		ShardedHistogram(const ShardedHistogram &) = delete;
+		ShardedHistogram &operator=(const ShardedHistogram &) = delete;
+
+		/*! @brief Sets the binning (from an empty prototype) and the memory policy, dropping all the contents.
+		 *
+		 * Must not be called while other threads are filling.
+		 */
+		void Reset(const H &prototype, Policy policy = Policy::Dense, size_t buffersize = 65536)
+		{
+			_prototype = prototype;
+			_merged = prototype;
+			_policy = policy;
+			_buffersize = buffersize > 0 ? buffersize : 1;
+			for (unsigned int ishard = 0; ishard <= MaxShards; ++ishard)
+			{
+				_shards[ishard].store(nullptr, std::memory_order_relaxed);
+				_owned[ishard].reset();
+			}
+		}
+
+		template <class... X>
+		void Fill(X... x) { FillShard(CurrentThreadIndex(), x...); }
+
+		template <class... X>
+		void FillShard(unsigned int ishard, X... x)
+		{
+			if (ishard >= MaxShards)
+			{
+				std::lock_guard<std::mutex> lock(_overflowmutex);
+				FillInto(GetShard(MaxShards), x...);
+			}
+			else
+				FillInto(GetShard(ishard), x...);
+		}
+
+		/*! @brief Adds every shard, in shard order, to the merged histogram and returns it.
+		 *
+		 * The shards are emptied, so calling it again only adds what was filled in between. Must not be called while
+		 * other threads are filling.
+		 */
+		H &Merged()
+		{
+			for (unsigned int ishard = 0; ishard <= MaxShards; ++ishard)
+			{
+				Shard *shard = _shards[ishard].load(std::memory_order_acquire);
+				if (!shard)
+					continue;
+				if (_policy == Policy::Dense)
+				{
+					_merged.Merge(shard->histo);
+					shard->histo = _prototype;
+				}
+				else
+					Drain(*shard);
+			}
+			return _merged;
+		}
+
+		template <class TH>
+		std::shared_ptr<TH> ToROOT(const std::string &name, const std::string &title)
+		{
+			return Merged().template ToROOT<TH>(name, title);
+		}
+
+	private:
+		struct Shard
+		{
+			H histo;
+			std::vector<size_t> cells;
+			char padding[64]; // Keeps the counters of shards allocated next to each other on different cache lines
+		};
+
+		template <class... X>
+		void FillInto(Shard &shard, X... x)
+		{
+			if (_policy == Policy::Dense)
+				shard.histo.Fill(x...);
+			else
+			{
+				shard.cells.push_back(_prototype.Locate(x...));
+				if (shard.cells.size() >= _buffersize)
+					Drain(shard);
+			}
+		}
+
+		//Shard ishard, in [0, MaxShards] (the last one is the overflow shard)
+		Shard &GetShard(unsigned int ishard)
+		{
+			Shard *shard = _shards[ishard].load(std::memory_order_acquire);
+			return shard ? *shard : CreateShard(ishard);
+		}
+
+		Shard &CreateShard(unsigned int ishard)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_owned[ishard])
+			{
+				_owned[ishard].reset(new Shard);
+				if (_policy == Policy::Dense)
+					_owned[ishard]->histo = _prototype;
+				else
+					_owned[ishard]->cells.reserve(_buffersize);
+				_shards[ishard].store(_owned[ishard].get(), std::memory_order_release);
+			}
+			return *_owned[ishard];
+		}
+
+		void Drain(Shard &shard)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_merged.FillCells(shard.cells);
+		}
+
+		H _prototype;
+		H _merged;
+		Policy _policy;
+		size_t _buffersize;
+		std::atomic<Shard *> _shards[MaxShards + 1];
+		std::unique_ptr<Shard> _owned[MaxShards + 1];
+		std::mutex _mutex;
+		std::mutex _overflowmutex;
+	};
+
+} // namespace Herd
+
+#endif /* HERD_SHARDEDHISTO_H_ */
@@ -0,0 +1,136 @@
+/*! @file ShardedPoints.h Per-thread graph points sorted by event index. */
+
+#ifndef HERD_SHARDEDPOINTS_H_
+#define HERD_SHARDEDPOINTS_H_
+
+#include "Utils/ThreadIndex.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Herd
+{
+
+	/*! @brief Graph points collected concurrently through one buffer per thread.
+	 * @class ShardedPoints ShardedPoints.h
+	 *
+	 * Every point is tagged with the index of the event which produced it. Sorted merges the per-thread buffers and
+	 * orders the points by event index (points of the same event keep their filling order), so a graph built from it
+	 * has the same points in the same order as one filled serially, for any number of threads.
+	 *
+	 * Threads with an index from MaxShards on (see CurrentThreadIndex) share one overflow shard, filled under a lock.
+	 *
+	 * Each shard stores its points in blocks of BlockSize entries which are never moved, so filling allocates once per
+	 * block instead of reallocating and copying an ever larger buffer.
+	 */
+	template <int N>
+	class ShardedPoints
+	{
+	public:
+		typedef std::array<double, N> point_type;
+		static const unsigned int MaxShards = MaxThreadShards;
+		static const size_t BlockSize = 65536;
+
+		ShardedPoints()
+		{
+			for (auto &shard : _shards)
+				shard.store(nullptr, std::memory_order_relaxed);
+		}
+
+		ShardedPoints(const ShardedPoints &) = delete;
+		ShardedPoints &operator=(const ShardedPoints &) = delete;
+
+		/*! @brief Drops all the points. Must not be called while other threads are filling. */
+		void Reset()
+		{
+			for (unsigned int ishard = 0; ishard <= MaxShards; ++ishard)
+			{
+				_shards[ishard].store(nullptr, std::memory_order_relaxed);
+				_owned[ishard].reset();
+			}
+			_sorted.clear();
+		}
+
+		void Add(unsigned long long eventindex, const point_type &point)
+		{
+			const unsigned int ishard = CurrentThreadIndex();
+			if (ishard >= MaxShards)
+			{
+				std::lock_guard<std::mutex> lock(_overflowmutex);
+				AddTo(GetShard(MaxShards), eventindex, point);
+			}
+			else
+				AddTo(GetShard(ishard), eventindex, point);
+		}
+
+		/*! @brief Moves the points of every shard to the sorted list and returns it.
+		 *
+		 * Calling it again adds the points filled in between. Must not be called while other threads are filling.
+		 */
+		const std::vector<point_type> &Sorted()
+		{
+			std::vector<Entry> entries;
+			for (unsigned int ishard = 0; ishard <= MaxShards; ++ishard)
+			{
+				Shard *shard = _shards[ishard].load(std::memory_order_acquire);
+				if (!shard)
+					continue;
+				for (auto &block : *shard)
+					entries.insert(entries.end(), block.begin(), block.end());
+				shard->clear();
+			}
+			std::stable_sort(entries.begin(), entries.end(),
+							 [](const Entry &a, const Entry &b) { return a.eventindex < b.eventindex; });
+			for (auto &entry : entries)
+				_sorted.push_back(entry.point);
+			return _sorted;
+		}
+
+	private:
+		struct Entry
+		{
+			unsigned long long eventindex;
+			point_type point;
+		};
+		typedef std::vector<std::vector<Entry>> Shard;
+
+		static void AddTo(Shard &shard, unsigned long long eventindex, const point_type &point)
+		{
+			if (shard.empty() || shard.back().size() == BlockSize)
+			{
+				shard.emplace_back();
+				shard.back().reserve(BlockSize);
+			}
+			shard.back().push_back(Entry{eventindex, point});
+		}
+
+		//Shard ishard, in [0, MaxShards] (the last one is the overflow shard)
+		Shard &GetShard(unsigned int ishard)
+		{
+			Shard *shard = _shards[ishard].load(std::memory_order_acquire);
+			if (shard)
+				return *shard;
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_owned[ishard])
+			{
+				_owned[ishard].reset(new Shard);
+				_shards[ishard].store(_owned[ishard].get(), std::memory_order_release);
+			}
+			return *_owned[ishard];
+		}
+
+		std::atomic<Shard *> _shards[MaxShards + 1];
+		std::unique_ptr<Shard> _owned[MaxShards + 1];
+		std::vector<point_type> _sorted;
+		std::mutex _mutex;
+		std::mutex _overflowmutex;
+	};
+
+} // namespace Herd
+
+#endif /* HERD_SHARDEDPOINTS_H_ */
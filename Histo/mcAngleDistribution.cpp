@@ -2,6 +2,7 @@
 
 // Root headers
 #include "TH2D.h"
+#include "TH3D.h"
 #include "TVector3.h"
 
 // HerdSoftware headers
@@ -25,8 +26,12 @@ namespace Herd
 																		energy_axispar{100, 1e+1, 1e+4},
 																		polar_axispar{100, -1, 1},
 																		azimuth_axispar{180, -M_PI, M_PI},
+																		folding("none"),
 																		logaxis{false},
-																		title("title")
+																		exportslices{false},
+																		title("title"),
+																		deferred{false},
+																		perfcounters{false}
 	{
 
 		DeclareConsumedObject("mcTruth", ObjectCategory::EVENT, "evStore");
@@ -34,8 +39,12 @@ namespace Herd
 		DefineParameter("energy_axispar", energy_axispar);
 		DefineParameter("polar_axispar", polar_axispar);
 		DefineParameter("azimuth_axispar", azimuth_axispar);
+		DefineParameter("folding", folding);
 		DefineParameter("logaxis", logaxis);
+		DefineParameter("exportslices", exportslices);
 		DefineParameter("title", title);
+		DefineParameter("deferred", deferred);
+		DefineParameter("perfcounters", perfcounters);
 	}
 
 	bool mcAngleDistribution::Initialize()
@@ -49,124 +58,64 @@ namespace Herd
 			return false;
 		}
 
-		// Check the user setting for the axis
-		if (energy_axispar.size() != 3)
+		// Check the user setting for the axes and build the binnings
+		std::string errmsg;
+		std::vector<double> folded_polar_axispar(polar_axispar), folded_azimuth_axispar(azimuth_axispar);
+		if (!energy_binning.Set(energy_axispar, logaxis, "energy", errmsg) ||
+			!polar_binning.Set(polar_axispar, false, "polar", errmsg) ||
+			!azimuth_binning.Set(azimuth_axispar, false, "azimuth", errmsg) ||
+			!angle_folding.Set(folding, errmsg) ||
+			!angle_folding.FoldAxes(folded_polar_axispar, folded_azimuth_axispar, errmsg) ||
+			!folded_polar_binning.Set(folded_polar_axispar, false, "polar", errmsg) ||
+			!folded_azimuth_binning.Set(folded_azimuth_axispar, false, "azimuth", errmsg))
 		{
-			COUT(ERROR) << "The energy axis must be specified by exactly 3 parameters" << ENDL;
-			return false;
-		}
-		if (polar_axispar.size() != 3)
-		{
-			COUT(ERROR) << "The polar axis must be specified by exactly 3 parameters" << ENDL;
-			return false;
-		}
-		if (azimuth_axispar.size() != 3)
-		{
-			COUT(ERROR) << "The azimut axis must be specified by exactly 3 parameters" << ENDL;
+			COUT(ERROR) << errmsg << ENDL;
 			return false;
 		}
+		angle_folding.SetUpperEdges(folded_polar_binning.High(), folded_azimuth_binning.High());
+		if (angle_folding.Enabled())
+			COUT(INFO) << "Folding the directions (" << folding << "): " << angle_folding.Order() << " times fewer cells" << ENDL;
 
-		if ((float)((int)(energy_axispar[0])) != energy_axispar[0])
-		{
-			COUT(ERROR) << "The number of energy bins is not an integer." << ENDL;
-			return false;
-		}
-		if ((float)((int)(polar_axispar[0])) != polar_axispar[0])
-		{
-			COUT(ERROR) << "The number of polar bins is not an integer." << ENDL;
-			return false;
-		}
-		if ((float)((int)(azimuth_axispar[0])) != azimuth_axispar[0])
-		{
-			COUT(ERROR) << "The number of azimut bins is not an integer." << ENDL;
-			return false;
-		}
+		angles.Reset(AngleHisto(BinningAxis(energy_binning), BinningAxis(folded_polar_binning), BinningAxis(folded_azimuth_binning)));
 
-		if (energy_axispar[0] < 0)
-		{
-			COUT(ERROR) << "The number of energy bins is a negative value." << ENDL;
-			return false;
-		}
-		if (polar_axispar[0] < 0)
-		{
-			COUT(ERROR) << "The number of polar bins is a negative value." << ENDL;
-			return false;
-		}
-		if (azimuth_axispar[0] < 0)
-		{
-			COUT(ERROR) << "The number of azimut bins is a negative value." << ENDL;
-			return false;
-		}
+		if (deferred)
+			KernelRegistry::Instance().Register(GetName(), this);
 
-		if (energy_axispar[1] >= energy_axispar[2])
-		{
-			COUT(ERROR) << "The lower axis limit is greater or equal to the upper limit." << ENDL;
-			return false;
-		}
-		if (polar_axispar[1] >= polar_axispar[2])
-		{
-			COUT(ERROR) << "The lower axis limit is greater or equal to the upper limit." << ENDL;
-			return false;
-		}
-		if (azimuth_axispar[1] >= azimuth_axispar[2])
-		{
-			COUT(ERROR) << "The lower axis limit is greater or equal to the upper limit." << ENDL;
-			return false;
-		}
-
-		if (logaxis)
-			GenerateLogEnergyBinning();
-		else
-			GenerateEnergyBinning();
-
-		// Define the number of TH2 histos as the number of energy bins
-		histo.resize(energy_axispar[0]);
-		
-		// Create the histos
-		for (auto ebIdx=0; ebIdx< histo.size(); ++ebIdx)
-		{
-			std::string histo_name = "h_" + GetName() + "_energyBin_" + std::to_string(ebIdx);
-			histo[ebIdx] = std::make_shared<TH2D> (
-				histo_name.c_str(), 
-				title.c_str(), 
-				polar_axispar[0], polar_axispar[1], polar_axispar[2],
-				azimuth_axispar[0], azimuth_axispar[1], azimuth_axispar[2]);
-		}
-
-		h_gen_theta_phi = std::make_shared<TH2D>(
-			"h_gen_theta_phi", 
-			"gen #theta/#phi distribution", 
-			polar_axispar[0], polar_axispar[1], polar_axispar[2],
-			azimuth_axispar[0], azimuth_axispar[1], azimuth_axispar[2]);
+		if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
 
 		return true;
 	}
 
 	bool mcAngleDistribution::Process()
 	{
-		const std::string routineName("mcAngleDistribution::Process");
+		static const std::string routineName("mcAngleDistribution::Process");
+		ProcessScope timing(_timer);
+		if (deferred)
+			return true;
 
-		auto mcTruth = _evStore->GetObject<Herd::MCTruth>("mcTruth");
-		if (!mcTruth)
+		AcceptanceEvent event;
+		if (!LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), event))
 		{
 			COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
 			return false;
 		}
+		ProcessEvent(event);
+
+		return true;
+	}
 
-		Momentum &Mom = mcTruth->primaries[0].initialMomentum;
-		Point &Pos = mcTruth->primaries[0].initialPosition;
+	bool mcAngleDistribution::ProcessEvent(const AcceptanceEvent &event)
+	{
+		Momentum Mom(event.momentum[0], event.momentum[1], event.momentum[2]);
+		Point Pos(event.position[0], event.position[1], event.position[2]);
 		Line MCtrack(Pos, Mom);
 
-		auto theta_deg = MCtrack.Polar() * 180 / M_PI;
-		auto costheta = cos(MCtrack.Polar());
-		auto phi_deg = MCtrack.Azimuth() * 180 / M_PI;
-		auto phi = MCtrack.Azimuth();
-		auto mcmom = std::sqrt(mcTruth->primaries[0].initialMomentum * mcTruth->primaries[0].initialMomentum);
-		auto ebIdx = getCurrentEnergyBin(mcmom);
-		
-		histo[ebIdx]->Fill(costheta, phi);
+		double costheta = cos(MCtrack.Polar());
+		double phi = MCtrack.Azimuth();
+		auto mcmom = std::sqrt(event.Momentum2());
+		angle_folding.Fold(costheta, phi);
 
-		h_gen_theta_phi->Fill(costheta, phi);
+		angles.Fill(mcmom, costheta, phi);
 
 		return true;
 	}
@@ -174,6 +123,9 @@ namespace Herd
 	bool mcAngleDistribution::Finalize()
 	{
 		const std::string routineName("mcAngleDistribution::Finalize");
+		KernelRegistry::Instance().Drain();
+		KernelRegistry::Instance().Unregister(GetName());
+
 		auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
 		if (!globStore)
 		{
@@ -181,36 +133,88 @@ namespace Herd
 			return false;
 		}
 		
-		// Book histos to the global store
-		for (auto hIdx=0; hIdx<histo.size(); ++hIdx)
-			globStore->AddObject(histo[hIdx]->GetName(), histo[hIdx]);
-
+		const int nE = energy_binning.NBins();
+		const int nC = polar_binning.NBins();
+		const int nP = azimuth_binning.NBins();
+
+		// The full distribution, stored as a single object
+		auto &merged = angles.Merged();
+		const auto &counts = merged.Contents();
+		const double order = angle_folding.Order();
+		// Content of a full-domain cell: the counts of its folded cell shared among the images
+		auto content = [&](int ebIdx, int cbIdx, int pbIdx) -> double {
+			return counts.Count(merged.Cell(ebIdx, angle_folding.PolarBin(cbIdx, nC), angle_folding.AzimuthBin(pbIdx, nP))) / order;
+		};
+		std::shared_ptr<TH3D> histo;
+		if (angle_folding.Enabled())
+		{
+			histo = std::make_shared<TH3D>(("h_" + GetName()).c_str(), title.c_str(),
+										   nE, energy_binning.Edges().data(), nC, polar_binning.Edges().data(), nP, azimuth_binning.Edges().data());
+			for (int pbIdx = -1; pbIdx <= nP; ++pbIdx)
+				for (int cbIdx = -1; cbIdx <= nC; ++cbIdx)
+					for (int ebIdx = -1; ebIdx <= nE; ++ebIdx)
+					{
+						const double value = content(ebIdx, cbIdx, pbIdx);
+						if (value == 0.)
+							continue;
+						const int bin = histo->GetBin(ebIdx + 1, cbIdx + 1, pbIdx + 1);
+						histo->SetBinContent(bin, value);
+						histo->SetBinError(bin, std::sqrt(value / order));
+					}
+			histo->SetEntries(merged.Entries());
+		}
+		else
+			histo = merged.ToROOT<TH3D>("h_" + GetName(), title);
+		histo->GetXaxis()->SetTitle("MC Momentum (GV)");
+		histo->GetYaxis()->SetTitle("cos(#theta)");
+		histo->GetZaxis()->SetTitle("#phi");
+		globStore->AddObject(histo->GetName(), histo);
+
+		// Energy-integrated distribution (all the events, under/overflow energies included)
+		auto h_gen_theta_phi = std::make_shared<TH2D>(
+			"h_gen_theta_phi",
+			"gen #theta/#phi distribution",
+			nC, polar_binning.Low(), polar_binning.High(),
+			nP, azimuth_binning.Low(), azimuth_binning.High());
+		for (int pbIdx = -1; pbIdx <= nP; ++pbIdx)
+			for (int cbIdx = -1; cbIdx <= nC; ++cbIdx)
+			{
+				double sum = 0;
+				for (int ebIdx = -1; ebIdx <= nE; ++ebIdx)
+					sum += content(ebIdx, cbIdx, pbIdx);
+				if (sum)
+					h_gen_theta_phi->SetBinContent(cbIdx + 1, pbIdx + 1, sum);
+			}
+		h_gen_theta_phi->SetEntries(merged.Entries());
 		globStore->AddObject(h_gen_theta_phi->GetName(), h_gen_theta_phi);
 
+		// Optional per-energy-bin slices, in the legacy format
+		if (exportslices)
+		{
+			for (int ebIdx = 0; ebIdx < nE; ++ebIdx)
+			{
+				std::string slice_name = "h_" + GetName() + "_energyBin_" + std::to_string(ebIdx);
+				auto slice = std::make_shared<TH2D>(
+					slice_name.c_str(),
+					title.c_str(),
+					nC, polar_binning.Low(), polar_binning.High(),
+					nP, azimuth_binning.Low(), azimuth_binning.High());
+				double sliceentries = 0;
+				for (int pbIdx = -1; pbIdx <= nP; ++pbIdx)
+					for (int cbIdx = -1; cbIdx <= nC; ++cbIdx)
+					{
+						auto count = content(ebIdx, cbIdx, pbIdx);
+						if (count)
+							slice->SetBinContent(cbIdx + 1, pbIdx + 1, count);
+						sliceentries += count;
+					}
+				slice->SetEntries(sliceentries);
+				globStore->AddObject(slice->GetName(), slice);
+			}
+		}
+
+		_timer.Publish(*globStore, GetName());
 		return true;
 	}
 
-	void mcAngleDistribution::GenerateLogEnergyBinning()
-	{
-		energy_binning.resize((int)energy_axispar[0] + 1);
-		double log_interval = (log10(energy_axispar[2]) - log10(energy_axispar[1])) / (int)energy_axispar[0];
-		for (auto bIdx = 0; bIdx <= (int)energy_axispar[0]; ++bIdx)
-			energy_binning[bIdx] = pow(10, log10(energy_axispar[1]) + bIdx * log_interval);
-	}
-
-	void mcAngleDistribution::GenerateEnergyBinning()
-	{
-		energy_binning.resize((int)energy_axispar[0] + 1);
-		double interval = (energy_axispar[2] - energy_axispar[1]) / (int)energy_axispar[0];
-		for (auto bIdx = 0; bIdx <= (int)energy_axispar[0]; ++bIdx)
-			energy_binning[bIdx] = energy_axispar[1] + bIdx * interval;
-	}
-	
-	int mcAngleDistribution::getCurrentEnergyBin(double energy)
-	{
-		for (auto ebIdx=0; ebIdx<energy_binning.size()-1; ++ebIdx)
-			if (energy_binning[ebIdx] <= energy && energy_binning[ebIdx+1] >= energy)
-				return ebIdx;
-	}
-
 } // namespace Herd
\ No newline at end of file
@@ -6,14 +6,21 @@
 // HerdSoftware headers
 #include "dataobjects/MCTruth.h"
 
+#include "AngleFolding.h"
+#include "Binning.h"
+#include "ShardedHisto.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/ProcessTimer.h"
+
 using namespace EA;
 
 class TH2D;
+class TH3D;
 
 namespace Herd
 {
 
-    class mcAngleDistribution : public Algorithm
+    class mcAngleDistribution : public Algorithm, public AcceptanceKernel
     {
     public:
         mcAngleDistribution(const std::string &name);
@@ -21,23 +28,31 @@ namespace Herd
         bool Process();
         bool Finalize();
 
+        bool ProcessEvent(const AcceptanceEvent &event);
+
     private:
         std::vector<double> energy_axispar;
         std::vector<double> polar_axispar;
         std::vector<double> azimuth_axispar;
-        std::vector<double> energy_binning;
+        Binning energy_binning;
+        Binning polar_binning;
+        Binning azimuth_binning;
+        std::string folding; // Symmetry folding of the directions: none, xy or xyz (see AngleFolding)
+        AngleFolding angle_folding;
+        Binning folded_polar_binning; // Axes of the filled histogram: the full ones without folding
+        Binning folded_azimuth_binning;
         bool logaxis;
+        bool exportslices;
         std::string title;
+        bool deferred; // Processing done by ParallelAcceptance
 
-        void GenerateLogEnergyBinning();
-        void GenerateEnergyBinning();
-        int getCurrentEnergyBin(double energy);
-
-        // Created global objects
-        std::vector<std::shared_ptr<TH2D>> histo;
-        std::shared_ptr<TH2D> h_gen_theta_phi;
+        // Event counts in (energy, cos(theta), phi), sharded per thread and exported (unfolded) as a TH3D in Finalize
+        typedef Histogram<Int64Storage, BinningAxis, BinningAxis, BinningAxis> AngleHisto;
+        ShardedHistogram<AngleHisto> angles;
 
         // Utility variables
+        bool perfcounters; // Also read the hardware counters when timing Process()
+        ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
         observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
     };
 
@@ -8,18 +8,29 @@
 #include <numeric>
 #include <cmath>
 #include <cstdlib>
+#include <map>
 #include <string>
 
 RegisterAlgorithm(mcEnergyHisto);
 
+namespace
+{
+	// Initialized instances by name, for AcceptanceMonitor
+	std::map<std::string, mcEnergyHisto *> instances;
+}
+
 mcEnergyHisto::mcEnergyHisto(const std::string &name) : Algorithm{name},
 												   axispar{100., 0., 100.},
 												   logaxis{false},
-												   title("title")
+												   title("title"),
+												   deferred{false},
+												   perfcounters{false}
 {
 	DefineParameter("axispar", axispar);
 	DefineParameter("logaxis", logaxis);
 	DefineParameter("title", title);
+	DefineParameter("deferred", deferred);
+	DefineParameter("perfcounters", perfcounters);
 }
 
 bool mcEnergyHisto::Initialize()
@@ -33,60 +44,76 @@ bool mcEnergyHisto::Initialize()
 		return false;
 	}
 
-	// Check the user setting for the axis
-	if (axispar.size() != 3)
-	{
-		COUT(ERROR) << "The axis must be specified by exactly 3 parameters" << ENDL;
-		return false;
-	}
-	if ((float)((int)(axispar[0])) != axispar[0])
-	{
-		COUT(ERROR) << "The number of bins is not an integer." << ENDL;
-		return false;
-	}
-	if (axispar[0] < 0)
+	// Check the user setting for the axis and build the binning
+	std::string errmsg;
+	if (!binning.Set(axispar, logaxis, "", errmsg))
 	{
-		COUT(ERROR) << "The number of bins is a negative value." << ENDL;
+		COUT(ERROR) << errmsg << ENDL;
 		return false;
 	}
-	if (axispar[1] >= axispar[2])
-	{
-		COUT(ERROR) << "The lower axis limit is greater or equal to the upper limit." << ENDL;
-		return false;
-	}
-	
-	if (logaxis)
-		GenerateLogBinning();
-	else
-		GenerateBinning();
 
 	// Create the histogram
-	std::string histo_name = "h_" + GetName();
-	histo = std::make_shared<TH1D>(histo_name.c_str(), title.c_str(), binning.size()-1, &(binning[0]));
-	histo->GetXaxis()->SetTitle("MC Momentum (GV()");
+	histo.Reset(Histo(Herd::BinningAxis(binning)));
+
+	if (deferred)
+		Herd::KernelRegistry::Instance().Register(GetName(), this);
+	instances[GetName()] = this;
+
+	if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
 
 	return true;
 }
 
 bool mcEnergyHisto::Process()
 {
-	const std::string routineName("mcEnergyHisto::Process");
-	
-	auto mctruth = _evStore->GetObject<Herd::MCTruth>("mcTruth");
-	if (!mctruth)
+	static const std::string routineName("mcEnergyHisto::Process");
+	Herd::ProcessScope timing(_timer);
+	if (deferred)
+		return true;
+
+	Herd::AcceptanceEvent event;
+	if (!Herd::LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), event))
 	{
 		COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
 		return false;
 	}
-	auto mcmom = std::sqrt(mctruth->primaries.at(0).initialMomentum * mctruth->primaries.at(0).initialMomentum);
-	histo->Fill(mcmom);
+	ProcessEvent(event);
+
+	return true;
+}
+
+bool mcEnergyHisto::ProcessEvent(const Herd::AcceptanceEvent &event)
+{
+	histo.Fill(std::sqrt(event.Momentum2()));
+	return true;
+}
+
+mcEnergyHisto *mcEnergyHisto::Find(const std::string &name)
+{
+	auto it = instances.find(name);
+	return it == instances.end() ? nullptr : it->second;
+}
 
+bool mcEnergyHisto::Counts(std::vector<unsigned long long> &counts)
+{
+	// Merging while the kernels fill their shards would race with them
+	if (Herd::KernelRegistry::Instance().BatchRunning())
+		return false;
+	Herd::KernelRegistry::Instance().Drain();
+	const Histo &merged = histo.Merged();
+	counts.resize(binning.NBins() + 2);
+	for (int bin = -1; bin <= binning.NBins(); ++bin)
+		counts[bin + 1] = merged.Contents().Count(merged.Cell(bin));
 	return true;
 }
 
 bool mcEnergyHisto::Finalize()
 {
 	const std::string routineName("mcEnergyHisto::Finalize");
+	Herd::KernelRegistry::Instance().Drain();
+	Herd::KernelRegistry::Instance().Unregister(GetName());
+	instances.erase(GetName());
+
 	auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
 	if (!globStore)
 	{
@@ -94,23 +121,10 @@ bool mcEnergyHisto::Finalize()
 		return false;
 	}
 
-	globStore->AddObject(histo->GetName(), histo);
+	auto rootHisto = histo.ToROOT<TH1D>("h_" + GetName(), title);
+	rootHisto->GetXaxis()->SetTitle("MC Momentum (GV()");
+	globStore->AddObject(rootHisto->GetName(), rootHisto);
 	
+	_timer.Publish(*globStore, GetName());
 	return true;
 }
-
-void mcEnergyHisto::GenerateLogBinning()
-{
-	binning.resize((int)axispar[0]+1);
-	double log_interval = (log10(axispar[2]) - log10(axispar[1])) / (int)axispar[0];
-	for (auto bIdx = 0; bIdx <= (int)axispar[0]; ++bIdx)
-		binning[bIdx] = pow(10, log10(axispar[1]) + bIdx * log_interval);
-}
-
-void mcEnergyHisto::GenerateBinning()
-{
-	binning.resize((int)axispar[0]+1);
-	double interval = (axispar[2] - axispar[1]) / (int)axispar[0];
-	for (auto bIdx = 0; bIdx <= (int)axispar[0]; ++bIdx)
-		binning[bIdx] = axispar[1] + bIdx * interval;
-}
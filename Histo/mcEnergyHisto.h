@@ -6,11 +6,16 @@
 // HerdSoftware headers
 #include "dataobjects/MCTruth.h"
 
+#include "Binning.h"
+#include "ShardedHisto.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/ProcessTimer.h"
+
 using namespace EA;
 
 class TH1D;
 
-class mcEnergyHisto : public Algorithm
+class mcEnergyHisto : public Algorithm, public Herd::AcceptanceKernel
 {
 public:
   mcEnergyHisto(const std::string &name);
@@ -18,19 +23,29 @@ public:
   bool Process();
   bool Finalize();
 
+  bool ProcessEvent(const Herd::AcceptanceEvent &event);
+
+  // Live access for AcceptanceMonitor: the instance with the given name (nullptr if none), its binning and its counts
+  // per bin up to now (under/overflow included). Counts first drains the events held by a deferred driver, so they
+  // cover every event which reached it; it returns false, leaving counts untouched, from inside a deferred batch
+  static mcEnergyHisto *Find(const std::string &name);
+  const Herd::Binning &GetBinning() const { return binning; }
+  bool Counts(std::vector<unsigned long long> &counts);
+
 private:
   std::vector<double> axispar;
-  std::vector<double> binning;
+  Herd::Binning binning;
   bool logaxis;
   std::string title;
+  bool deferred; // Processing done by ParallelAcceptance
 
-  void GenerateLogBinning();
-  void GenerateBinning();
-
-  // Created global objects
-  std::shared_ptr<TH1D> histo; // Objects to be pushed on global store must be held by a shared_ptr
+  // Momentum histogram, sharded per thread and converted to a TH1D in Finalize
+  typedef Herd::Histogram<Herd::Int64Storage, Herd::BinningAxis> Histo;
+  Herd::ShardedHistogram<Histo> histo;
 
   // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
 };
 
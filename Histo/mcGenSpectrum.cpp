@@ -1,5 +1,6 @@
 // Example headers
 #include "mcGenSpectrum.h"
+#include "Core/PowerLaw.h"
 
 // Root headers
 #include "TH1D.h"
@@ -7,21 +8,51 @@
 // C/C++ standard headers
 #include <numeric>
 #include <cmath>
+#include <map>
 
 RegisterAlgorithm(mcGenSpectrum);
 
+namespace
+{
+	// Generated spectra summed over the datasets, by name (the first dataset to finalize books it). The sums live from
+	// the initialization of the first combining instance of a run to the finalization of the last one, so a second run
+	// in the same process starts from empty sums and no ROOT object is left for the static destruction
+	std::map<std::string, std::shared_ptr<TH1D>> combined;
+	int ncombining = 0;
+
+	struct CombinedRelease
+	{
+		bool active;
+		~CombinedRelease()
+		{
+			if (active && --ncombining == 0)
+				combined.clear();
+		}
+	};
+}
+
 mcGenSpectrum::mcGenSpectrum(const std::string &name) : Algorithm{name},
 														axispar{100., 1., 100000.},
 														logaxis{true},
 														title("title"),
+														deferred{false},
+														index{-1},
 														momrange{-1., -1.},
-														index{-1}
+														eventrange{0., -1.},
+														bymomentum{false},
+														combine(""),
+														perfcounters{false}
 {
 	DefineParameter("axispar", axispar);
 	DefineParameter("logaxis", logaxis);
 	DefineParameter("title", title);
 	DefineParameter("momrange", momrange);
 	DefineParameter("index", index);
+	DefineParameter("eventrange", eventrange);
+	DefineParameter("bymomentum", bymomentum);
+	DefineParameter("combine", combine);
+	DefineParameter("deferred", deferred);
+	DefineParameter("perfcounters", perfcounters);
 }
 
 bool mcGenSpectrum::Initialize()
@@ -35,83 +66,102 @@ bool mcGenSpectrum::Initialize()
 		return false;
 	}
 
-	// Check the user setting for the axis
-	if (axispar.size() != 3)
+	// Check the user setting for the axis and build the binning
+	std::string errmsg;
+	if (!binning.Set(axispar, logaxis, "", errmsg))
 	{
-		COUT(ERROR) << "The axis must be specified by exactly 3 parameters" << ENDL;
+		COUT(ERROR) << errmsg << ENDL;
 		return false;
 	}
-	if ((float)((int)(axispar[0])) != axispar[0])
+
+	// Without a momentum range the generation covers the axis
+	if (momrange.size() != 2 || momrange[0] <= 0 || momrange[1] <= 0)
+		momrange = {binning.Low(), binning.High()};
+	if (momrange[0] >= momrange[1] || momrange[0] <= 0)
 	{
-		COUT(ERROR) << "The number of bins is not an integer." << ENDL;
+		COUT(ERROR) << "Invalid momentum range {" << momrange[0] << ", " << momrange[1] << "}" << ENDL;
 		return false;
 	}
-	if (axispar[0] < 0.)
+	if (eventrange.size() != 2 || eventrange[0] < 0 || (eventrange[1] >= 0 && eventrange[1] <= eventrange[0]))
 	{
-		COUT(ERROR) << "The number of bins is a negative value." << ENDL;
+		COUT(ERROR) << "eventrange must be {first, last} with last > first, or last = -1" << ENDL;
 		return false;
 	}
-	if (axispar[1] >= axispar[2])
+	// The event index restarts in every forkRunner chunk and catalogBuilder shard, the primary momentum does not
+	if (bymomentum && (eventrange[0] != 0 || eventrange[1] >= 0))
 	{
-		COUT(ERROR) << "The lower axis limit is greater or equal to the upper limit." << ENDL;
+		COUT(ERROR) << "eventrange and bymomentum cannot be used together" << ENDL;
 		return false;
 	}
-
-	if (logaxis)
-		GenerateLogBinning();
-	else
-		GenerateBinning();
+	_momrange2[0] = momrange[0] * momrange[0];
+	_momrange2[1] = momrange[1] * momrange[1];
 
 	// Create the histogram
 	std::string histo_name = "h_" + GetName();
-	histo = std::make_shared<TH1D>(histo_name.c_str(), title.c_str(), binning.size() -1, &(binning[0]));
+	histo = std::make_shared<TH1D>(histo_name.c_str(), title.c_str(), binning.NBins(), &(binning.Edges()[0]));
 	histo->GetXaxis()->SetTitle("MC Momentum (GV()");
 
 	ngen = 0;
 
+	if (deferred)
+		Herd::KernelRegistry::Instance().Register(GetName(), this);
+
+	if (!_timer.Init(perfcounters, GetName())) COUT(WARNING) << "Hardware counters not available: timing Process() without them" << ENDL;
+
+	if (!combine.empty() && ncombining++ == 0)
+		combined.clear();
+
 	return true;
 }
 
 bool mcGenSpectrum::Process()
 {
-	const std::string routineName("mcGenSpectrum::Process");
+	static const std::string routineName("mcGenSpectrum::Process");
+	Herd::ProcessScope timing(_timer);
+	if (deferred)
+		return true;
 
-	auto mctruth = _evStore->GetObject<Herd::MCTruth>("mcTruth");
-	if (!mctruth)
+	Herd::AcceptanceEvent event;
+	if (!Herd::LoadAcceptanceEvent(*_evStore, GetEventLoopProxy()->GetCurrentEvent(), event))
 	{
 		COUT(DEBUG) << "MCTruth not present for event " << GetEventLoopProxy()->GetCurrentEvent() << ENDL;
 		return false;
 	}
-	ngen += mctruth->nDiscarded + 1;
+	ProcessEvent(event);
 
 	return true;
 }
 
+bool mcGenSpectrum::ProcessEvent(const Herd::AcceptanceEvent &event)
+{
+	// Events of the other datasets are counted by their own instance. With bymomentum the discarded events are
+	// attributed to the dataset of the event which follows them, which comes from the same generator run
+	if (bymomentum)
+	{
+		const double momentum2 = event.Momentum2();
+		if (momentum2 < _momrange2[0] || momentum2 >= _momrange2[1])
+			return true;
+	}
+	else if (event.index < eventrange[0] || (eventrange[1] >= 0 && event.index >= eventrange[1]))
+		return true;
+	ngen += event.ndiscarded + 1;
+	return true;
+}
+
 bool mcGenSpectrum::Finalize()
 {
 	const std::string routineName("mcGenSpectrum::Finalize");
+	const CombinedRelease release{!combine.empty()};
+	Herd::KernelRegistry::Instance().Drain();
+	Herd::KernelRegistry::Instance().Unregister(GetName());
 
-	for (int bIdx = 1; bIdx < histo->GetNbinsX(); ++bIdx)
+	// Expected generated events in each bin, for the whole generation spectrum of this dataset
+	for (int bIdx = 1; bIdx <= histo->GetNbinsX(); ++bIdx)
 	{
-		if (histo->GetBinLowEdge(bIdx + 1) < momrange[0]) 
-			histo->SetBinContent(bIdx, 0);
-		else if (histo->GetBinLowEdge(bIdx) > momrange[1]) 
-			histo->SetBinContent(bIdx, 0);
-		else
-		{
-			double lowedge = std::max(histo->GetBinLowEdge(bIdx), momrange[0]);
-			double highedge = std::min(histo->GetBinLowEdge(bIdx + 1), momrange[1]);
-			double w = 0;
-			if (index == -1)
-				w = (log10(highedge) - log10(lowedge)) / (log10(momrange[1]) - log10(momrange[0]));
-			else
-			{
-				w = (1./(1-index))/(pow(highedge, -index + 1) - pow(lowedge, -index +1));
-				w /= (1./(1-index))/(pow(momrange[1], -index + 1) - pow(momrange[0], -index +1))
-			}
-			histo->SetBinContent(bIdx, ngen * w);
-		}
+		double w = Herd::PowerLawFraction(histo->GetBinLowEdge(bIdx), histo->GetBinLowEdge(bIdx + 1), momrange[0], momrange[1], index);
+		histo->SetBinContent(bIdx, ngen.load() * w);
 	}
+	histo->SetEntries(ngen.load());
 
 	auto globStore = GetDataStoreManager()->GetGlobalDataStore("globStore");
 	if (!globStore)
@@ -121,20 +171,31 @@ bool mcGenSpectrum::Finalize()
 	}
 	globStore->AddObject(histo->GetName(), histo);
 
-	return true;
-}
+	// The selected events of all the datasets fill the same histograms, so their generated spectra are summed: in
+	// the overlap of two datasets the expected counts of both add up and the ratio needs no further weighting
+	if (!combine.empty())
+	{
+		auto it = combined.find(combine);
+		if (it == combined.end())
+		{
+			auto sum = std::shared_ptr<TH1D>(static_cast<TH1D *>(histo->Clone(combine.c_str())));
+			sum->SetDirectory(nullptr);
+			combined[combine] = sum;
+			globStore->AddObject(sum->GetName(), sum);
+		}
+		else
+		{
+			auto &sum = it->second;
+			if (sum->GetNbinsX() != histo->GetNbinsX() || sum->GetBinLowEdge(1) != histo->GetBinLowEdge(1) ||
+				sum->GetBinLowEdge(sum->GetNbinsX() + 1) != histo->GetBinLowEdge(histo->GetNbinsX() + 1))
+			{
+				COUT(ERROR) << "The binning differs from the one of " << combine << ENDL;
+				return false;
+			}
+			sum->Add(histo.get());
+		}
+	}
 
-void mcGenSpectrum::GenerateLogBinning()
-{
-	binning.resize((int)axispar[0]+1);
-	double log_interval = (log10(axispar[2]) - log10(axispar[1])) / (int)axispar[0];
-	for (auto bIdx = 0; bIdx <= (int)axispar[0]; ++bIdx)
-		binning[bIdx] = pow(10, log10(axispar[1]) + bIdx * log_interval);
-}
-void mcGenSpectrum::GenerateBinning()
-{
-	binning.resize((int)axispar[0]+1);
-	double interval = (axispar[2] - axispar[1]) / (int)axispar[0];
-	for (auto bIdx = 0; bIdx <= (int)axispar[0]; ++bIdx)
-		binning[bIdx] = axispar[1] + bIdx * interval;
+	_timer.Publish(*globStore, GetName());
+	return true;
 }
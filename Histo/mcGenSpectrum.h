@@ -7,35 +7,47 @@
 // HerdSoftware headers
 #include "dataobjects/MCTruth.h"
 
+#include "Binning.h"
+#include "Core/AcceptanceKernel.h"
+#include "Core/ProcessTimer.h"
+
+// C/C++ standard headers
+#include <atomic>
+
 using namespace EA;
 
 class TH1D;
 
-class mcGenSpectrum : public Algorithm {
+class mcGenSpectrum : public Algorithm, public Herd::AcceptanceKernel {
 public:
   mcGenSpectrum(const std::string &name);
   bool Initialize();
   bool Process();
   bool Finalize();
 
+  bool ProcessEvent(const Herd::AcceptanceEvent &event);
+
 private:
 
   std::vector<double> axispar;
-  std::vector<double> binning;
+  Herd::Binning binning;
   bool logaxis;
   std::string title;
-  
-  void GenerateLogBinning();
-  void GenerateBinning();
-  
-
-  unsigned int ngen;
-  int index;
-  std::vector<double> momrange;
-  
+  bool deferred; // Processing done by ParallelAcceptance
+
+  std::atomic<unsigned long long> ngen; // Summed by the kernel from several threads
+  double index;                         // Generation spectrum dN/dE ~ E^index (-1: log-uniform)
+  std::vector<double> momrange;         // Generation momentum range (default: the axis range)
+  std::vector<double> eventrange;       // Events [first, last) of the dataset in the input (last -1: until the end)
+  bool bymomentum;                      // Dataset events told apart by primary momentum in momrange, not by eventrange
+  double _momrange2[2];                 // Squared momentum range, for bymomentum
+  std::string combine;                  // Name of the generated spectrum summed over all the datasets ("": none)
+
   std::shared_ptr<TH1D> histo; // Objects to be pushed on global store must be held by a shared_ptr
 
   // Utility variables
+  bool perfcounters; // Also read the hardware counters when timing Process()
+  Herd::ProcessTimer _timer; // Latency of the Process() calls, published at Finalize
   observer_ptr<EventDataStore> _evStore; // Pointer to the event data store
 };
 
@@ -1,13 +1,48 @@
 #include "TFile.h"
 #include "TH1D.h"
 #include "TH2D.h"
+#include "TH3D.h"
 
 #include <vector>
 #include <memory>
 #include <iostream>
 
+// Dense (energy, cos(theta), phi) distribution written by mcAngleDistribution: merging is a single Add
+std::shared_ptr<TH3D> readAngularDistribution(const char* dataFile)
+{
+    TFile myInFile(dataFile, "READ");
+	if (myInFile.IsZombie())
+	{
+		std::cerr << "\n\nError reading input ROOT file: " << dataFile << std::endl;
+		exit(123);
+	}
+    std::shared_ptr<TH3D> histo (dynamic_cast<TH3D*>(myInFile.Get("h_angularDistribution")));
+    if (histo)
+        histo->SetDirectory(0);
+    myInFile.Close();
+    return histo;
+}
+
 void addAngularDistributions(const char* LE_dataFile, const char* HE_dataFile)
 {
+    auto h_LE_angular_distribution = readAngularDistribution(LE_dataFile);
+    auto h_HE_angular_distribution = readAngularDistribution(HE_dataFile);
+    if (h_LE_angular_distribution && h_HE_angular_distribution)
+    {
+        h_LE_angular_distribution->Add(h_HE_angular_distribution.get());
+
+        TFile outFile("eventAngularDistribution.root", "RECREATE");
+        if (outFile.IsZombie())
+        {
+            std::cerr << "\n\nError writing output TFile" << std::endl;
+            exit(123);
+        }
+        h_LE_angular_distribution->Write();
+        outFile.Close();
+        return;
+    }
+
+    // Legacy files: one TH2D per energy bin
     TFile myInFile_LE(LE_dataFile, "READ");
 	if (myInFile_LE.IsZombie())
 	{
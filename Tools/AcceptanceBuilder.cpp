@@ -0,0 +1,119 @@
+/*! @file AcceptanceBuilder.cpp CountSum class and binomial interval implementations. */
+
+#include "AcceptanceBuilder.h"
+#include "OutputMerger.h"
+
+// Root headers
+#include "Math/QuantFuncMathCore.h"
+#include "TH1.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Herd {
+
+bool CountSum::Add(const TH1 &histo, std::string &errmsg) {
+  if (!_shape) {
+    _shape.reset(static_cast<TH1 *>(histo.Clone()));
+    _shape->SetDirectory(nullptr);
+    _shape->Reset();
+    _integer.assign(histo.GetNcells(), 0);
+    _fraction.assign(histo.GetNcells(), 0.);
+  } else if (strcmp(histo.ClassName(), _shape->ClassName()) != 0 || !OutputMerger::SameBinning(*_shape, histo)) {
+    errmsg = std::string("Different binning for ") + histo.GetName();
+    return false;
+  }
+
+  for (size_t cell = 0; cell < _integer.size(); cell++) {
+    const double content = histo.GetBinContent(cell);
+    if (content < 0) {
+      errmsg = std::string("Negative content in ") + histo.GetName();
+      return false;
+    }
+    const double integer = std::floor(content);
+    _integer[cell] += (unsigned long long)integer;
+    _fraction[cell] += content - integer;
+  }
+  return true;
+}
+
+bool CountSum::Add(const CountSum &other, std::string &errmsg) {
+  if (other.Empty()) return true;
+  if (Empty()) {
+    _shape.reset(static_cast<TH1 *>(other._shape->Clone()));
+    _shape->SetDirectory(nullptr);
+    _integer = other._integer;
+    _fraction = other._fraction;
+    return true;
+  }
+  if (!OutputMerger::SameBinning(*_shape, *other._shape)) {
+    errmsg = std::string("Different binning for ") + _shape->GetName();
+    return false;
+  }
+  for (size_t cell = 0; cell < _integer.size(); cell++) {
+    _integer[cell] += other._integer[cell];
+    _fraction[cell] += other._fraction[cell];
+  }
+  return true;
+}
+
+std::unique_ptr<TH1> CountSum::ToROOT(const std::string &name, const std::string &title) const {
+  std::unique_ptr<TH1> histo(static_cast<TH1 *>(_shape->Clone(name.c_str())));
+  histo->SetDirectory(nullptr);
+  histo->SetTitle(title.c_str());
+  double entries = 0;
+  for (size_t cell = 0; cell < _integer.size(); cell++) {
+    histo->SetBinContent(cell, Value(cell));
+    entries += Value(cell);
+  }
+  histo->SetEntries(entries);
+  return histo;
+}
+
+bool ParseIntervalMethod(const std::string &name, IntervalMethod &method) {
+  if (name == "cp" || name == "clopper-pearson")
+    method = IntervalMethod::ClopperPearson;
+  else if (name == "wilson")
+    method = IntervalMethod::Wilson;
+  else
+    return false;
+  return true;
+}
+
+void BinomialIntervals(IntervalMethod method, double cl, size_t size, const double *pass, const double *total,
+                       double *eff, double *low, double *high) {
+  const double alpha = 0.5 * (1. - cl);
+
+  if (method == IntervalMethod::Wilson) {
+    //Branch-free over the bins so the loop vectorizes; empty bins are fixed afterwards
+    const double z = ROOT::Math::normal_quantile(1. - alpha, 1.);
+    const double z2 = z * z;
+    for (size_t i = 0; i < size; i++) {
+      const double n = std::max(total[i], 1e-300);
+      const double p = std::min(pass[i], total[i]) / n;
+      const double denom = 1. + z2 / n;
+      const double center = (p + 0.5 * z2 / n) / denom;
+      const double halfwidth = z * std::sqrt(p * (1. - p) / n + 0.25 * z2 / (n * n)) / denom;
+      eff[i] = p;
+      low[i] = std::max(0., center - halfwidth);
+      high[i] = std::min(1., center + halfwidth);
+    }
+  } else {
+    for (size_t i = 0; i < size; i++) {
+      const double n = total[i], k = std::min(pass[i], total[i]);
+      eff[i] = n > 0 ? k / n : 0.;
+      low[i] = k > 0 ? ROOT::Math::beta_quantile(alpha, k, n - k + 1) : 0.;
+      high[i] = k < n ? ROOT::Math::beta_quantile(1. - alpha, k + 1, n - k) : 1.;
+    }
+  }
+
+  for (size_t i = 0; i < size; i++)
+    if (!(total[i] > 0)) {
+      eff[i] = low[i] = 0.;
+      high[i] = 1.;
+    }
+}
+
+} // namespace Herd
@@ -0,0 +1,67 @@
+/*! @file AcceptanceBuilder.h CountSum class and binomial interval declarations. */
+
+#ifndef HERD_ACCEPTANCEBUILDER_H_
+#define HERD_ACCEPTANCEBUILDER_H_
+
+// C/C++ standard headers
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+
+namespace Herd {
+
+/*! @brief Sum of the bin contents of histograms with the same binning.
+ * @class CountSum AcceptanceBuilder.h
+ *
+ * The integer part of every content is summed in 64 bits, so event counts are exact whatever their number; only the
+ * fractional parts (e.g. of the expected counts of mcGenSpectrum) are summed in floating point. Cells follow the
+ * global bin numbering of ROOT, under/overflows included.
+ */
+class CountSum {
+public:
+  /*! @brief Adds the contents of a histogram.
+   *
+   * The first histogram defines the binning.
+   * @return false if the binning differs from the one of the previous histograms or a content is negative.
+   */
+  bool Add(const TH1 &histo, std::string &errmsg);
+
+  /*! @brief Adds another sum with the same binning. */
+  bool Add(const CountSum &other, std::string &errmsg);
+
+  bool Empty() const { return !_shape; }
+
+  /*! @brief An empty histogram with the binning of the sum. */
+  const TH1 &Shape() const { return *_shape; }
+
+  size_t NCells() const { return _integer.size(); }
+  double Value(size_t cell) const { return _integer[cell] + _fraction[cell]; }
+
+  /*! @brief The sum as a histogram of the same type as the added ones. */
+  std::unique_ptr<TH1> ToROOT(const std::string &name, const std::string &title) const;
+
+private:
+  std::unique_ptr<TH1> _shape;
+  std::vector<unsigned long long> _integer;
+  std::vector<double> _fraction;
+};
+
+enum class IntervalMethod { ClopperPearson, Wilson };
+
+/*! @brief Converts "cp"/"clopper-pearson" or "wilson" to an interval method. */
+bool ParseIntervalMethod(const std::string &name, IntervalMethod &method);
+
+/*! @brief Binomial efficiencies and confidence intervals of arrays of counts.
+ *
+ * For each i, eff[i] = pass[i] / total[i] with the central interval [low[i], high[i]] of confidence level cl. Counts
+ * need not be integers (the Clopper-Pearson bounds use the beta quantiles with real parameters); pass is limited to
+ * total. Bins with total = 0 get eff = low = 0 and high = 1.
+ */
+void BinomialIntervals(IntervalMethod method, double cl, size_t size, const double *pass, const double *total,
+                       double *eff, double *low, double *high);
+
+} // namespace Herd
+
+#endif /* HERD_ACCEPTANCEBUILDER_H_ */
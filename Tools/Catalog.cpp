@@ -0,0 +1,208 @@
+/*! @file Catalog.cpp Catalog and CostModel class implementations. */
+
+#include "Catalog.h"
+#include "Utils/WorkStealingPool.h"
+
+// Root headers
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <sstream>
+
+// POSIX headers
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace Herd {
+
+namespace {
+
+//Regular files in directory ending with extension, with their size and modification time
+void ListFiles(const std::string &directory, const std::string &extension, bool subdirs, std::vector<CatalogEntry> &files) {
+  DIR *dir = opendir(directory.c_str());
+  if (!dir) return;
+  std::vector<std::string> dirs;
+  while (dirent *item = readdir(dir)) {
+    const std::string name = item->d_name;
+    if (name == "." || name == "..") continue;
+    const std::string path = directory + "/" + name;
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) continue;
+    if (S_ISDIR(info.st_mode)) {
+      if (subdirs) dirs.push_back(path);
+    } else if (S_ISREG(info.st_mode) && name.size() >= extension.size() &&
+               name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+      CatalogEntry entry;
+      entry.path = path;
+      entry.bytes = info.st_size;
+      entry.mtime = info.st_mtime;
+      files.push_back(entry);
+    }
+  }
+  closedir(dir);
+  for (auto const &subdir : dirs) ListFiles(subdir, extension, false, files);
+}
+
+void ReadFile(CatalogEntry &entry, const std::string &treename, const std::string &momexpr) {
+  entry.entries = -1;
+  entry.mommin = entry.mommax = -1;
+  std::unique_ptr<TFile> file(TFile::Open(entry.path.c_str(), "READ"));
+  if (!file || file->IsZombie()) return;
+  TTree *tree = file->Get<TTree>(treename.c_str());
+  if (!tree) return;
+  entry.entries = tree->GetEntries();
+  if (!momexpr.empty() && entry.entries > 0) {
+    tree->SetEstimate(entry.entries);
+    Long64_t n = tree->Draw(momexpr.c_str(), "", "goff");
+    if (n > 0) {
+      const double *values = tree->GetV1();
+      auto range = std::minmax_element(values, values + std::min(n, tree->GetSelectedRows()));
+      entry.mommin = *range.first;
+      entry.mommax = *range.second;
+    }
+  }
+  file->Close();
+}
+
+} // namespace
+
+bool Catalog::Load(const std::string &filename, std::string &errmsg) {
+  _entries.clear();
+  std::ifstream in(filename);
+  if (!in) return true;
+  std::string line;
+  int iline = 0;
+  while (std::getline(in, line)) {
+    iline++;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    CatalogEntry entry;
+    if (!(fields >> entry.path >> entry.bytes >> entry.mtime >> entry.entries >> entry.mommin >> entry.mommax)) {
+      errmsg = filename + ":" + std::to_string(iline) + ": malformed line";
+      return false;
+    }
+    _entries.push_back(entry);
+  }
+  std::sort(_entries.begin(), _entries.end(), [](const CatalogEntry &a, const CatalogEntry &b) { return a.path < b.path; });
+  return true;
+}
+
+bool Catalog::Save(const std::string &filename, std::string &errmsg) const {
+  std::ofstream out(filename);
+  out << "# path bytes mtime entries mommin mommax\n";
+  out.precision(9);
+  for (auto const &entry : _entries)
+    out << entry.path << " " << entry.bytes << " " << entry.mtime << " " << entry.entries << " " << entry.mommin << " "
+        << entry.mommax << "\n";
+  if (!out) {
+    errmsg = "Cannot write " + filename;
+    return false;
+  }
+  return true;
+}
+
+size_t Catalog::Scan(const std::string &directory, bool subdirs, const std::string &extension,
+                     const std::string &treename, const std::string &momexpr, unsigned int nthreads) {
+
+  std::vector<CatalogEntry> files;
+  ListFiles(directory, extension, subdirs, files);
+  std::sort(files.begin(), files.end(), [](const CatalogEntry &a, const CatalogEntry &b) { return a.path < b.path; });
+
+  //Keep the indexed information of the unchanged files (both lists are sorted by path)
+  std::vector<size_t> toread;
+  auto indexed = _entries.begin();
+  for (size_t ifile = 0; ifile < files.size(); ifile++) {
+    while (indexed != _entries.end() && indexed->path < files[ifile].path) ++indexed;
+    if (indexed != _entries.end() && indexed->path == files[ifile].path && indexed->bytes == files[ifile].bytes &&
+        indexed->mtime == files[ifile].mtime && indexed->entries >= 0)
+      files[ifile] = *indexed;
+    else
+      toread.push_back(ifile);
+  }
+
+  if (!toread.empty()) {
+    ROOT::EnableThreadSafety();
+    WorkStealingPool pool(std::max(1u, nthreads));
+    pool.ParallelFor(toread.size(), [&](size_t i, unsigned int) { ReadFile(files[toread[i]], treename, momexpr); });
+  }
+
+  _entries.swap(files);
+  return toread.size();
+}
+
+int CostModel::Bin(const CatalogEntry &entry) {
+  if (entry.mommin <= 0 || entry.mommax <= 0) return std::numeric_limits<int>::min();
+  //Geometric mean of the range: files are usually generated with a log-uniform spectrum
+  return (int)std::floor(0.5 * (std::log10(entry.mommin) + std::log10(entry.mommax)) / binwidth);
+}
+
+bool CostModel::Calibrate(const std::string &filename, const Catalog &catalog, std::string &errmsg) {
+  std::ifstream in(filename);
+  if (!in) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+  std::map<std::string, const CatalogEntry *> bypath;
+  for (auto const &entry : catalog.Entries()) bypath[entry.path] = &entry;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string path;
+    double seconds;
+    if (!(fields >> path >> seconds)) continue;
+    auto it = bypath.find(path);
+    if (it == bypath.end() || it->second->entries <= 0) continue;
+    auto &bin = _bins[Bin(*it->second)];
+    bin.first += seconds;
+    bin.second += it->second->entries;
+    _totseconds += seconds;
+    _totentries += it->second->entries;
+  }
+  return true;
+}
+
+double CostModel::Cost(const CatalogEntry &entry) const {
+  const double entries = std::max(0LL, entry.entries);
+  if (!IsCalibrated()) return entries;
+  auto it = _bins.find(Bin(entry));
+  if (it != _bins.end() && it->first != std::numeric_limits<int>::min() && it->second.second > 0)
+    return entries * it->second.first / it->second.second;
+  return entries * _totseconds / _totentries;
+}
+
+std::vector<std::vector<const CatalogEntry *>> MakeShards(const Catalog &catalog, const CostModel &model,
+                                                          unsigned int nshards, std::vector<double> &shardcosts) {
+  std::vector<std::vector<const CatalogEntry *>> shards(std::max(1u, nshards));
+  shardcosts.assign(shards.size(), 0.);
+
+  //Most expensive files first, each to the currently cheapest shard (ties broken by path and shard index)
+  std::vector<std::pair<double, const CatalogEntry *>> files;
+  for (auto const &entry : catalog.Entries())
+    if (entry.entries > 0) files.emplace_back(model.Cost(entry), &entry);
+  std::sort(files.begin(), files.end(), [](const std::pair<double, const CatalogEntry *> &a,
+                                           const std::pair<double, const CatalogEntry *> &b) {
+    return a.first != b.first ? a.first > b.first : a.second->path < b.second->path;
+  });
+  for (auto const &file : files) {
+    size_t ishard = std::min_element(shardcosts.begin(), shardcosts.end()) - shardcosts.begin();
+    shards[ishard].push_back(file.second);
+    shardcosts[ishard] += file.first;
+  }
+
+  //Files in path order inside each shard
+  for (auto &shard : shards)
+    std::sort(shard.begin(), shard.end(), [](const CatalogEntry *a, const CatalogEntry *b) { return a->path < b->path; });
+  return shards;
+}
+
+} // namespace Herd
@@ -0,0 +1,89 @@
+/*! @file Catalog.h Catalog and CostModel class declarations. */
+
+#ifndef HERD_CATALOG_H_
+#define HERD_CATALOG_H_
+
+// C/C++ standard headers
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Description of one data file. */
+struct CatalogEntry {
+  std::string path;
+  long long bytes = 0;
+  long long mtime = 0;     // Modification time (s), used with bytes to detect changed files
+  long long entries = -1;  // Number of events, -1 if the file could not be read
+  double mommin = -1;      // Momentum range of the primaries (GeV/c), -1 if not available
+  double mommax = -1;
+};
+
+/*! @brief Index of the data files with their size, number of events and momentum range.
+ * @class Catalog Catalog.h
+ *
+ * The index is a text file with one line per data file. Scan lists a directory and reads only the files which are
+ * not in the index or changed since they were indexed, on several threads.
+ */
+class Catalog {
+public:
+  /*! @brief Loads an index file. A missing file gives an empty catalog. */
+  bool Load(const std::string &filename, std::string &errmsg);
+  bool Save(const std::string &filename, std::string &errmsg) const;
+
+  /*! @brief Updates the catalog with the files found in a directory.
+   *
+   * @param directory The data directory.
+   * @param subdirs If true, the first level of subdirectories is searched too (as listBuilder -s).
+   * @param extension Only files ending with it are considered.
+   * @param treename Name of the event tree.
+   * @param momexpr Tree expression giving the primary momentum (empty: do not compute the momentum range).
+   * @param nthreads Threads reading the new or changed files.
+   * @return The number of files which were (re)read.
+   */
+  size_t Scan(const std::string &directory, bool subdirs, const std::string &extension, const std::string &treename,
+              const std::string &momexpr, unsigned int nthreads);
+
+  const std::vector<CatalogEntry> &Entries() const { return _entries; }
+
+private:
+  std::vector<CatalogEntry> _entries; // Sorted by path
+};
+
+/*! @brief Processing time per event as a function of the momentum, calibrated on previous runs.
+ * @class CostModel Catalog.h
+ *
+ * The time per event is averaged in bins of log10(momentum); files outside the calibrated bins (or without a momentum
+ * range) use the average over all the files. Without any calibration every event costs 1, so the cost is the number
+ * of entries.
+ */
+class CostModel {
+public:
+  /*! @brief Adds the times of a previous run.
+   *
+   * @param filename Timings file: one "path seconds" line per data file (as written by forkRunner).
+   * @param catalog Catalog giving the entries and the momentum of the files.
+   */
+  bool Calibrate(const std::string &filename, const Catalog &catalog, std::string &errmsg);
+
+  double Cost(const CatalogEntry &entry) const;
+
+  bool IsCalibrated() const { return _totentries > 0; }
+
+private:
+  static int Bin(const CatalogEntry &entry);
+
+  static constexpr double binwidth = 0.25; // In log10(momentum)
+  std::map<int, std::pair<double, double>> _bins; // Bin -> (seconds, entries)
+  double _totseconds = 0;
+  double _totentries = 0;
+};
+
+/*! @brief Splits the files into nshards lists of similar total cost (longest processing time first). */
+std::vector<std::vector<const CatalogEntry *>> MakeShards(const Catalog &catalog, const CostModel &model,
+                                                          unsigned int nshards, std::vector<double> &shardcosts);
+
+} // namespace Herd
+
+#endif /* HERD_CATALOG_H_ */
@@ -0,0 +1,116 @@
+/*! @file EaConfig.cpp EaConfig class implementation. */
+
+#include "EaConfig.h"
+
+// C/C++ standard headers
+#include <fstream>
+
+namespace Herd {
+
+namespace {
+
+//Position and length of the itoken-th whitespace-separated token of line, false if there are not enough tokens
+bool FindToken(const std::string &line, int itoken, size_t &pos, size_t &len) {
+  size_t begin = 0;
+  for (int i = 0; i <= itoken; i++) {
+    begin = line.find_first_not_of(" \t", begin);
+    if (begin == std::string::npos) return false;
+    size_t end = line.find_first_of(" \t", begin);
+    if (end == std::string::npos) end = line.size();
+    if (i == itoken) {
+      pos = begin;
+      len = end - begin;
+      return true;
+    }
+    begin = end;
+  }
+  return false;
+}
+
+std::string Token(const std::string &line, int itoken) {
+  size_t pos, len;
+  return FindToken(line, itoken, pos, len) ? line.substr(pos, len) : std::string();
+}
+
+} // namespace
+
+bool EaConfig::Load(const std::string &filename, std::string &errmsg) {
+  std::ifstream in(filename);
+  if (!in) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+
+  _lines.clear();
+  _datalistline = _outputline = -1;
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::string keyword = Token(line, 0);
+    if (keyword == "DataProvider" && _datalistline < 0) {
+      _datalistline = _lines.size();
+      _datalist = Token(line, 3);
+    } else if (keyword == "Persistence" && _outputline < 0) {
+      _outputline = _lines.size();
+      _output = Token(line, 3);
+    }
+    _lines.push_back(line);
+  }
+
+  if (_datalistline < 0 || _datalist.empty()) {
+    errmsg = "No DataProvider with a data list in " + filename;
+    return false;
+  }
+  return true;
+}
+
+bool EaConfig::Save(const std::string &filename, std::string &errmsg) const {
+  std::ofstream out(filename);
+  for (auto const &line : _lines) out << line << "\n";
+  if (!out) {
+    errmsg = "Cannot write " + filename;
+    return false;
+  }
+  return true;
+}
+
+bool EaConfig::SetsParameter(const std::string &name) const {
+  for (auto const &line : _lines)
+    if (Token(line, 0) == "Set" && Token(line, 1) == name) return true;
+  return false;
+}
+
+void EaConfig::SetField(int line, std::string &field, const std::string &value) {
+  field = value;
+  if (line < 0) return;
+  size_t pos, len;
+  if (FindToken(_lines[line], 3, pos, len))
+    _lines[line].replace(pos, len, value);
+  else
+    _lines[line] += " " + value;
+}
+
+bool EaConfig::ReadFileList(const std::string &filename, std::vector<std::string> &files, std::string &errmsg) {
+  std::ifstream in(filename);
+  if (!in) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::string file = Token(line, 0);
+    if (!file.empty() && file[0] != '#') files.push_back(file);
+  }
+  return true;
+}
+
+bool EaConfig::WriteFileList(const std::string &filename, const std::vector<std::string> &files, std::string &errmsg) {
+  std::ofstream out(filename);
+  for (auto const &file : files) out << file << "\n";
+  if (!out) {
+    errmsg = "Cannot write " + filename;
+    return false;
+  }
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,57 @@
+/*! @file EaConfig.h EaConfig class declaration. */
+
+#ifndef HERD_EACONFIG_H_
+#define HERD_EACONFIG_H_
+
+// C/C++ standard headers
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Minimal reader/writer of EventAnalysis configuration files.
+ * @class EaConfig EaConfig.h
+ *
+ * The file is kept line by line, so a rewritten configuration differs from the original only in the fields which
+ * were changed. Only the fields needed to run the same configuration on a different input are exposed: the data
+ * list of the DataProvider and the output file of the Persistence service.
+ */
+class EaConfig {
+public:
+  /*! @brief Reads a configuration file.
+   *
+   * @return false if the file cannot be read or has no DataProvider line.
+   */
+  bool Load(const std::string &filename, std::string &errmsg);
+
+  /*! @brief Writes the (possibly modified) configuration. */
+  bool Save(const std::string &filename, std::string &errmsg) const;
+
+  const std::string &DataList() const { return _datalist; }
+  const std::string &Output() const { return _output; }
+
+  /*! @brief Whether an active (not commented) Set line of the configuration sets the parameter name. */
+  bool SetsParameter(const std::string &name) const;
+
+  void SetDataList(const std::string &datalist) { SetField(_datalistline, _datalist, datalist); }
+  void SetOutput(const std::string &output) { SetField(_outputline, _output, output); }
+
+  /*! @brief Reads a list of files (one per line, empty lines and lines starting with # are skipped). */
+  static bool ReadFileList(const std::string &filename, std::vector<std::string> &files, std::string &errmsg);
+
+  /*! @brief Writes a list of files, one per line. */
+  static bool WriteFileList(const std::string &filename, const std::vector<std::string> &files, std::string &errmsg);
+
+private:
+  void SetField(int line, std::string &field, const std::string &value);
+
+  std::vector<std::string> _lines;
+  int _datalistline = -1; // Line of the DataProvider, its 4th token is the data list
+  int _outputline = -1;   // Line of the Persistence service, its 4th token is the output file
+  std::string _datalist;
+  std::string _output;
+};
+
+} // namespace Herd
+
+#endif /* HERD_EACONFIG_H_ */
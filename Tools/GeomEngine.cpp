@@ -0,0 +1,192 @@
+/*! @file GeomEngine.cpp CaloPrism, PlaneLayers and GeomEngine class implementations. */
+
+#include "GeomEngine.h"
+#include "Utils/Philox.h"
+#include "Utils/WorkStealingPool.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace Herd {
+
+CaloPrism::CaloPrism() { Set(79., 33.4, 73.2, 32.4, -36.6, 73.2, 0.); }
+
+void CaloPrism::Set(double xsidebig, double xsidesmall, double ysidebig, double ysidesmall, double zcenter,
+                    double zheight, double shrink) {
+  auto setface = [this](Face face, double nx, double ny, double nz, double offset) {
+    _normal[face][0] = nx;
+    _normal[face][1] = ny;
+    _normal[face][2] = nz;
+    _offset[face] = offset;
+  };
+  const double xhalf = xsidebig / 2. - shrink, yhalf = ysidebig / 2. - shrink;
+  setface(XPOS, +1., 0., 0., xhalf);
+  setface(XNEG, -1., 0., 0., xhalf);
+  setface(YPOS, 0., +1., 0., yhalf);
+  setface(YNEG, 0., -1., 0., yhalf);
+  setface(ZPOS, 0., 0., +1., zcenter + zheight / 2. - shrink);
+  setface(ZNEG, 0., 0., -1., -(zcenter - zheight / 2. + shrink));
+
+  //Corner faces through (xsidesmall/2, yhalf) and (xhalf, ysidesmall/2), mirrored in the other quadrants
+  const double ax = xsidesmall / 2., ay = yhalf, bx = xhalf, by = ysidesmall / 2.;
+  const double nx = ay - by, ny = bx - ax, norm = std::sqrt(nx * nx + ny * ny);
+  const double offset = (nx * ax + ny * ay) / norm;
+  setface(XPOSYPOS, +nx / norm, +ny / norm, 0., offset);
+  setface(XNEGYPOS, -nx / norm, +ny / norm, 0., offset);
+  setface(XPOSYNEG, +nx / norm, -ny / norm, 0., offset);
+  setface(XNEGYNEG, -nx / norm, -ny / norm, 0., offset);
+}
+
+bool CaloPrism::Clip(const double point[3], const double direction[3], double &tin, double &tout, Face &entry) const {
+  tin = -std::numeric_limits<double>::infinity();
+  tout = std::numeric_limits<double>::infinity();
+  entry = NFACES;
+  for (int face = 0; face < NFACES; face++) {
+    const double *n = _normal[face];
+    const double denom = n[0] * direction[0] + n[1] * direction[1] + n[2] * direction[2];
+    const double num = _offset[face] - (n[0] * point[0] + n[1] * point[1] + n[2] * point[2]);
+    if (denom == 0.) {
+      if (num < 0.) return false; // Parallel and outside
+      continue;
+    }
+    const double t = num / denom;
+    if (denom < 0.) {
+      if (t > tin) {
+        tin = t;
+        entry = static_cast<Face>(face);
+      }
+    } else if (t < tout) {
+      tout = t;
+    }
+  }
+  return tin < tout;
+}
+
+bool PlaneLayers::Load(const std::string &filename, std::string &errmsg) {
+  std::ifstream in(filename);
+  if (!in) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+  _layers.clear();
+  std::string line;
+  int iline = 0;
+  while (std::getline(in, line)) {
+    iline++;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string axis;
+    Layer layer;
+    if (!(fields >> axis >> layer.position >> layer.min1 >> layer.max1 >> layer.min2 >> layer.max2) ||
+        (axis != "x" && axis != "y" && axis != "z")) {
+      errmsg = filename + ":" + std::to_string(iline) + ": malformed line";
+      return false;
+    }
+    layer.axis = axis[0] - 'x';
+    layer.axis1 = layer.axis == 0 ? 1 : 0;
+    layer.axis2 = layer.axis == 2 ? 1 : 2;
+    _layers.push_back(layer);
+  }
+  return true;
+}
+
+int PlaneLayers::Intersections(const double point[3], const double direction[3]) const {
+  int n = 0;
+  for (auto const &layer : _layers) {
+    if (direction[layer.axis] == 0.) continue;
+    const double t = (layer.position - point[layer.axis]) / direction[layer.axis];
+    if (!(t > 0.)) continue;
+    const double c1 = point[layer.axis1] + t * direction[layer.axis1];
+    const double c2 = point[layer.axis2] + t * direction[layer.axis2];
+    if (c1 >= layer.min1 && c1 <= layer.max1 && c2 >= layer.min2 && c2 <= layer.max2) n++;
+  }
+  return n;
+}
+
+bool GeomEngine::Configure(const SphereGenerator &generator, const GeomSelection &selection, const Binning &binning,
+                           std::string &errmsg) {
+  if (!(selection.cubeside > 0) || selection.alpha < 0 || !(selection.lysox0 > 0)) {
+    errmsg = "Invalid Calo parameters";
+    return false;
+  }
+  _generator = generator;
+  _selection = selection;
+  _binning = binning;
+  _calo.Set(79., 33.4, 73.2, 32.4, -36.6, 73.2, 0.);
+  _fiducial.Set(79., 33.4, 73.2, 32.4, -36.6, 73.2, selection.alpha * selection.cubeside);
+  _cosmaxtheta = std::cos(selection.maxtheta * M_PI / 180.);
+  Reset();
+  return true;
+}
+
+void GeomEngine::Reset() {
+  for (auto &counts : _counts) counts.assign(_binning.NBins() + 2, 0);
+  _ngenerated = 0;
+}
+
+bool GeomEngine::LoadStkLayers(const std::string &filename, std::string &errmsg) {
+  return _stk.Load(filename, errmsg);
+}
+
+const char *GeomEngine::StageName(Stage stage) {
+  static const char *names[NSTAGES] = {"mcgenspectrum", "polar_filtered", "X0_filtered", "calo_filtered_fidvolume"};
+  return stage >= 0 && stage < NSTAGES ? names[stage] : "";
+}
+
+GeomEngine::Stage GeomEngine::Process(uint64_t seed, uint64_t ievent, double &momentum) const {
+  double u[5];
+  if (_sampling == SOBOL)
+    _sobol.Point((uint32_t)ievent, seed, u);
+  else {
+    PhiloxStream random(seed, ievent);
+    for (auto &value : u) value = random.Uniform();
+  }
+  double position[3], mom[3];
+  _generator.Map(u, position, mom);
+  momentum = std::sqrt(mom[0] * mom[0] + mom[1] * mom[1] + mom[2] * mom[2]);
+  const double direction[3] = {mom[0] / momentum, mom[1] / momentum, mom[2] / momentum};
+
+  //Polar angle of the arrival direction, i.e. of -p
+  if (-direction[2] < _cosmaxtheta) return GENERATED;
+
+  double tin, tout;
+  CaloPrism::Face entry;
+  const bool incalo = _calo.Clip(position, direction, tin, tout, entry);
+  if (!incalo || (_selection.notfrombottom && entry == CaloPrism::ZNEG)) return POLAR;
+  if ((tout - tin) * _selection.activefraction / _selection.lysox0 < _selection.mincalotrackx0) return POLAR;
+  if (_stk.Size() > 0 && _stk.Intersections(position, direction) < _selection.minstkintersections) return POLAR;
+
+  CaloPrism::Face fidentry;
+  if (!_fiducial.Clip(position, direction, tin, tout, fidentry)) return X0;
+  return FIDVOLUME;
+}
+
+void GeomEngine::Run(uint64_t seed, uint64_t first, uint64_t nevents, unsigned int nthreads) {
+  static const uint64_t chunksize = 65536;
+  const uint64_t nchunks = (nevents + chunksize - 1) / chunksize;
+  const size_t nbins = _counts[0].size();
+
+  WorkStealingPool pool(std::max(1u, nthreads));
+  std::vector<std::vector<uint64_t>> threadcounts(pool.NThreads(), std::vector<uint64_t>(NSTAGES * nbins, 0));
+  pool.ParallelFor(nchunks, [&](size_t ichunk, unsigned int thread) {
+    uint64_t *counts = threadcounts[thread].data();
+    const uint64_t begin = first + ichunk * chunksize, end = first + std::min(nevents, (ichunk + 1) * chunksize);
+    for (uint64_t ievent = begin; ievent < end; ievent++) {
+      double momentum;
+      const Stage stage = Process(seed, ievent, momentum);
+      const size_t bin = _binning.FindBin(momentum) + 1;
+      for (int istage = 0; istage <= stage; istage++) counts[istage * nbins + bin]++;
+    }
+  });
+
+  for (auto const &counts : threadcounts)
+    for (int istage = 0; istage < NSTAGES; istage++)
+      for (size_t bin = 0; bin < nbins; bin++) _counts[istage][bin] += counts[istage * nbins + bin];
+  _ngenerated += nevents;
+}
+
+} // namespace Herd
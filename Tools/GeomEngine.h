@@ -0,0 +1,146 @@
+/*! @file GeomEngine.h CaloPrism and GeomEngine class declarations. */
+
+#ifndef HERD_GEOMENGINE_H_
+#define HERD_GEOMENGINE_H_
+
+#include "Core/SphereGenerator.h"
+#include "Histo/Binning.h"
+#include "Utils/Sobol.h"
+
+// C/C++ standard headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief The octagonal prism of the Calo, as built by CaloGeomFidVolumeAlgo.
+ * @class CaloPrism GeomEngine.h
+ *
+ * The faces are the planes of CaloGeomFidVolumeAlgo::Initialize: the X, Y and Z faces moved inward by shrink, the
+ * corner faces through the ends of the shrunk X and Y faces. Clip intersects a line with the prism as the
+ * intersection of the ten half-spaces.
+ */
+class CaloPrism {
+public:
+  enum Face { XNEG, XPOS, YNEG, YPOS, ZNEG, ZPOS, XNEGYNEG, XPOSYNEG, XNEGYPOS, XPOSYPOS, NFACES };
+
+  CaloPrism();
+
+  /*! @brief Builds the faces; dimensions in cm, as the constants of CaloGeomFidVolumeAlgo. */
+  void Set(double xsidebig, double xsidesmall, double ysidebig, double ysidesmall, double zcenter, double zheight,
+           double shrink);
+
+  /*! @brief Intersection of the line point + t * direction with the prism.
+   *
+   * @return false if the line misses the prism; otherwise [tin, tout] is the inner segment and entry the face
+   *         crossed at tin.
+   */
+  bool Clip(const double point[3], const double direction[3], double &tin, double &tout, Face &entry) const;
+
+private:
+  double _normal[NFACES][3]; // Outward normals
+  double _offset[NFACES];    // The face is normal . x = offset
+};
+
+/*! @brief Rectangular planar layers of a tracker, for counting the intersections of a track.
+ * @class PlaneLayers GeomEngine.h
+ *
+ * The layer file has one layer per line: "<axis> <position> <min1> <max1> <min2> <max2>", where axis is x, y or z,
+ * the layer lies on the plane axis = position and covers [min1, max1] x [min2, max2] in the other two coordinates
+ * (y and z for x, x and z for y, x and y for z), in cm. Empty lines and lines starting with # are skipped.
+ */
+class PlaneLayers {
+public:
+  bool Load(const std::string &filename, std::string &errmsg);
+
+  size_t Size() const { return _layers.size(); }
+
+  /*! @brief Number of layers crossed by the ray point + t * direction, t > 0. */
+  int Intersections(const double point[3], const double direction[3]) const;
+
+private:
+  struct Layer {
+    int axis, axis1, axis2;
+    double position, min1, max1, min2, max2;
+  };
+  std::vector<Layer> _layers;
+};
+
+/*! @brief Selections of the geometric acceptance, with the defaults of the reference configuration. */
+struct GeomSelection {
+  double maxtheta = 180.;          // Maximum polar angle of the arrival direction (deg), as PolarAngleCut
+  bool notfrombottom = true;       // Reject tracks entering the Calo from the bottom face, as MCtruthProcess
+  double mincalotrackx0 = 20.;     // Minimum track length in the Calo (X0), as MCtruthProcess
+  int minstkintersections = -1;    // Minimum number of tracker layers crossed, as MCtruthProcess
+  double alpha = 1.;               // Fiducial volume shrink in cube sizes, as CaloGeomFidVolumeAlgo with checkint
+  double cubeside = 3.;            // Calo cube side (cm)
+  double activefraction = 0.569861492; // Mean LYSO fraction of the Calo volume
+  double lysox0 = 1.1;             // LYSO radiation length (cm)
+};
+
+/*! @brief Standalone geometric acceptance: sphere generation, selections and momentum histograms.
+ * @class GeomEngine GeomEngine.h
+ *
+ * Event i is generated from the Philox stream (seed, i), or with SOBOL sampling from point i of the Sobol sequence
+ * scrambled by seed, so the counts of a run depend only on the seed and on the range of event indices: the same for
+ * any number of threads, and a run split into index ranges sums up exactly to the full run. Runs with different seeds
+ * are independent in both modes, so the spread of their results estimates the error; with SOBOL sampling that error
+ * decreases faster than 1/sqrt(N) when the runs use 2^m events from index 0. The counts of every stage are integers per momentum bin (under/overflow included), summed per thread
+ * and then over the threads.
+ *
+ * Stages, as the reference chain PolarAngleCut -> MCtruthProcess -> CaloGeomFidVolumeAlgo:
+ *   GENERATED   all the events
+ *   POLAR       arrival direction within maxtheta
+ *   X0          not from the bottom, Calo track length and tracker layers above the thresholds
+ *   FIDVOLUME   line crossing the Calo prism shrunk by alpha cube sides
+ * The Calo track length is the path inside the prism times activefraction / lysox0.
+ */
+class GeomEngine {
+public:
+  enum Stage { GENERATED, POLAR, X0, FIDVOLUME, NSTAGES };
+  enum Sampling { PSEUDORANDOM, SOBOL };
+
+  /*! @brief Largest event index + 1 with SOBOL sampling. */
+  static const uint64_t MaxSobolEvents = 1ULL << 32;
+
+  bool Configure(const SphereGenerator &generator, const GeomSelection &selection, const Binning &binning,
+                 std::string &errmsg);
+
+  /*! @brief Tracker layers for minstkintersections; without layers that cut is not applied. */
+  bool LoadStkLayers(const std::string &filename, std::string &errmsg);
+
+  void SetSampling(Sampling sampling) { _sampling = sampling; }
+
+  /*! @brief Sets the counts to zero, e.g. before a run with another seed. */
+  void Reset();
+
+  /*! @brief Processes the events [first, first + nevents) on nthreads threads, adding to the counts. */
+  void Run(uint64_t seed, uint64_t first, uint64_t nevents, unsigned int nthreads);
+
+  /*! @brief Counts of a stage per bin: index 0 is the underflow, NBins() + 1 the overflow. */
+  const std::vector<uint64_t> &Counts(Stage stage) const { return _counts[stage]; }
+
+  uint64_t NGenerated() const { return _ngenerated; }
+
+  static const char *StageName(Stage stage);
+
+private:
+  //Highest stage passed by event ievent, and its momentum
+  Stage Process(uint64_t seed, uint64_t ievent, double &momentum) const;
+
+  SphereGenerator _generator;
+  GeomSelection _selection;
+  Binning _binning;
+  CaloPrism _calo, _fiducial;
+  PlaneLayers _stk;
+  Sampling _sampling = PSEUDORANDOM;
+  SobolSampler _sobol;
+  double _cosmaxtheta;
+  std::vector<uint64_t> _counts[NSTAGES];
+  uint64_t _ngenerated = 0;
+};
+
+} // namespace Herd
+
+#endif /* HERD_GEOMENGINE_H_ */
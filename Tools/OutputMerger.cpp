@@ -0,0 +1,133 @@
+/*! @file OutputMerger.cpp OutputMerger class implementation. */
+
+#include "OutputMerger.h"
+
+// Root headers
+#include "TFile.h"
+#include "TGraph.h"
+#include "TGraph2D.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TList.h"
+
+// C/C++ standard headers
+#include <cstring>
+
+namespace Herd {
+
+namespace {
+
+bool SameAxis(const TAxis &a, const TAxis &b) {
+  if (a.GetNbins() != b.GetNbins()) return false;
+  for (int ibin = 1; ibin <= a.GetNbins() + 1; ibin++)
+    if (a.GetBinLowEdge(ibin) != b.GetBinLowEdge(ibin)) return false;
+  return true;
+}
+
+} // namespace
+
+OutputMerger::OutputMerger() { TH1::AddDirectory(false); }
+
+OutputMerger::~OutputMerger() {}
+
+bool OutputMerger::Add(const std::string &filename, std::string &errmsg, const std::set<std::string> *classes) {
+  std::unique_ptr<TFile> file(TFile::Open(filename.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    errmsg = "Cannot read " + filename;
+    return false;
+  }
+
+  //Keys are listed with the highest cycle first: older cycles of the same object are skipped
+  std::set<std::string> names;
+  TList *keys = file->GetListOfKeys();
+  for (int ikey = 0; keys && ikey < keys->GetSize(); ikey++) {
+    TKey *key = static_cast<TKey *>(keys->At(ikey));
+    if (classes && classes->count(key->GetClassName()) == 0) continue;
+    if (!names.insert(key->GetName()).second) continue;
+    std::unique_ptr<TObject> object(key->ReadObj());
+    if (!object) continue;
+    auto it = _index.find(object->GetName());
+    if (it == _index.end()) {
+      Insert(std::move(object));
+    } else if (!Merge(*_objects[it->second], *object, errmsg)) {
+      errmsg = filename + ": " + errmsg;
+      return false;
+    }
+  }
+
+  file->Close();
+  return true;
+}
+
+bool OutputMerger::Add(OutputMerger &other, std::string &errmsg) {
+  for (auto &object : other._objects) {
+    auto it = _index.find(object->GetName());
+    if (it == _index.end()) {
+      Insert(std::move(object));
+    } else if (!Merge(*_objects[it->second], *object, errmsg)) {
+      return false;
+    }
+  }
+  other.Clear();
+  return true;
+}
+
+void OutputMerger::Insert(std::unique_ptr<TObject> object) {
+  _index[object->GetName()] = _objects.size();
+  _objects.push_back(std::move(object));
+}
+
+void OutputMerger::Clear() {
+  _objects.clear();
+  _index.clear();
+}
+
+bool OutputMerger::Merge(TObject &target, const TObject &source, std::string &errmsg) {
+  if (strcmp(target.ClassName(), source.ClassName()) != 0) {
+    errmsg = std::string(target.GetName()) + " is a " + target.ClassName() + " and a " + source.ClassName();
+    return false;
+  }
+
+  if (auto htarget = dynamic_cast<TH1 *>(&target)) {
+    auto &hsource = static_cast<const TH1 &>(source);
+    if (!SameBinning(*htarget, hsource)) {
+      errmsg = std::string("Different binning for ") + target.GetName();
+      return false;
+    }
+    htarget->Add(&hsource);
+  } else if (auto gtarget = dynamic_cast<TGraph2D *>(&target)) {
+    auto &gsource = static_cast<const TGraph2D &>(source);
+    const int n = gtarget->GetN();
+    for (int ipoint = 0; ipoint < gsource.GetN(); ipoint++)
+      gtarget->SetPoint(n + ipoint, gsource.GetX()[ipoint], gsource.GetY()[ipoint], gsource.GetZ()[ipoint]);
+  } else if (auto gtarget = dynamic_cast<TGraph *>(&target)) {
+    auto &gsource = static_cast<const TGraph &>(source);
+    const int n = gtarget->GetN();
+    for (int ipoint = 0; ipoint < gsource.GetN(); ipoint++)
+      gtarget->SetPoint(n + ipoint, gsource.GetX()[ipoint], gsource.GetY()[ipoint]);
+  }
+  return true;
+}
+
+bool OutputMerger::SameBinning(const TH1 &a, const TH1 &b) {
+  return SameAxis(*a.GetXaxis(), *b.GetXaxis()) && SameAxis(*a.GetYaxis(), *b.GetYaxis()) &&
+         SameAxis(*a.GetZaxis(), *b.GetZaxis());
+}
+
+bool OutputMerger::Write(const std::string &filename, std::string &errmsg) const {
+  TFile file(filename.c_str(), "RECREATE");
+  if (file.IsZombie()) {
+    errmsg = "Cannot write " + filename;
+    return false;
+  }
+  Write(file);
+  file.Close();
+  return true;
+}
+
+void OutputMerger::Write(TDirectory &directory) const {
+  directory.cd();
+  for (auto const &object : _objects) object->Write();
+}
+
+} // namespace Herd
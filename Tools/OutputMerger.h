@@ -0,0 +1,65 @@
+/*! @file OutputMerger.h OutputMerger class declaration. */
+
+#ifndef HERD_OUTPUTMERGER_H_
+#define HERD_OUTPUTMERGER_H_
+
+// C/C++ standard headers
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class TDirectory;
+class TH1;
+class TObject;
+
+namespace Herd {
+
+/*! @brief Sums the objects of several output files.
+ * @class OutputMerger OutputMerger.h
+ *
+ * Objects are matched by name. Histograms are added, graphs get the points of the following files appended; other
+ * objects are taken from the first file containing them. The result depends only on the order of the files.
+ */
+class OutputMerger {
+public:
+  OutputMerger();
+  ~OutputMerger();
+
+  /*! @brief Merges the content of a file into the current result.
+   *
+   * @param classes If not null, only the objects of these classes are read.
+   * @return false if the file cannot be read or contains a histogram with a binning different from the current one.
+   */
+  bool Add(const std::string &filename, std::string &errmsg, const std::set<std::string> *classes = nullptr);
+
+  /*! @brief Merges the result of another merger (of the files following the ones of this merger) and clears it. */
+  bool Add(OutputMerger &other, std::string &errmsg);
+
+  /*! @brief Writes the result, in the order in which the objects were first found. */
+  bool Write(const std::string &filename, std::string &errmsg) const;
+
+  /*! @brief Writes the result into an open file or directory. */
+  void Write(TDirectory &directory) const;
+
+  void Clear();
+
+  size_t NObjects() const { return _objects.size(); }
+
+  /*! @brief Merges source into target: histograms with the same binning are added, graph points are appended. */
+  static bool Merge(TObject &target, const TObject &source, std::string &errmsg);
+
+  /*! @brief True if the two histograms have the same bin edges on every axis. */
+  static bool SameBinning(const TH1 &a, const TH1 &b);
+
+private:
+  void Insert(std::unique_ptr<TObject> object);
+
+  std::vector<std::unique_ptr<TObject>> _objects;
+  std::map<std::string, size_t> _index;
+};
+
+} // namespace Herd
+
+#endif /* HERD_OUTPUTMERGER_H_ */
@@ -0,0 +1,109 @@
+/*! @file ParallelMerger.cpp ParallelMerger class implementation. */
+
+#include "ParallelMerger.h"
+#include "OutputMerger.h"
+#include "Utils/WorkStealingPool.h"
+
+// Root headers
+#include "TFile.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TROOT.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+
+namespace Herd {
+
+ParallelMerger::ParallelMerger(unsigned int nthreads) : _nthreads{std::max(1u, nthreads)}, _nobjects{0} {}
+
+bool ParallelMerger::Merge(const std::vector<std::string> &inputs, const std::string &output, std::string &errmsg) {
+  _nobjects = 0;
+  ROOT::EnableThreadSafety();
+  WorkStealingPool pool(_nthreads);
+
+  //Names and classes of the objects of every input, in key order
+  std::vector<std::vector<std::pair<std::string, std::string>>> filekeys(inputs.size());
+  std::vector<std::string> errors(std::max(inputs.size(), (size_t)_nthreads));
+  pool.ParallelFor(inputs.size(), [&](size_t ifile, unsigned int) {
+    std::unique_ptr<TFile> file(TFile::Open(inputs[ifile].c_str(), "READ"));
+    if (!file || file->IsZombie()) {
+      errors[ifile] = "Cannot read " + inputs[ifile];
+      return;
+    }
+    TList *keys = file->GetListOfKeys();
+    for (int ikey = 0; keys && ikey < keys->GetSize(); ikey++) {
+      TKey *key = static_cast<TKey *>(keys->At(ikey));
+      filekeys[ifile].emplace_back(key->GetName(), key->GetClassName());
+    }
+    file->Close();
+  });
+  for (auto const &error : errors)
+    if (!error.empty()) {
+      errmsg = error;
+      return false;
+    }
+
+  //Classes in order of first appearance, so the output does not depend on the number of threads
+  //(objects are merged within a class, so the same name must have the same class everywhere)
+  std::vector<std::string> classes;
+  std::set<std::string> known;
+  std::map<std::string, std::string> objectclass;
+  for (size_t ifile = 0; ifile < inputs.size(); ifile++)
+    for (auto const &key : filekeys[ifile]) {
+      auto it = objectclass.emplace(key.first, key.second).first;
+      if (it->second != key.second) {
+        errmsg = inputs[ifile] + ": " + key.first + " is a " + it->second + " and a " + key.second;
+        return false;
+      }
+      if (known.insert(key.second).second) classes.push_back(key.second);
+    }
+
+  TFile file(output.c_str(), "RECREATE");
+  if (file.IsZombie()) {
+    errmsg = "Cannot write " + output;
+    return false;
+  }
+
+  const size_t nblocks = std::min(inputs.size(), (size_t)_nthreads);
+  std::vector<OutputMerger> blocks(nblocks);
+  for (auto const &classname : classes) {
+    const std::set<std::string> selection{classname};
+
+    //Contiguous blocks of inputs, each merged in file order
+    pool.ParallelFor(nblocks, [&](size_t iblock, unsigned int) {
+      const size_t first = inputs.size() * iblock / nblocks, last = inputs.size() * (iblock + 1) / nblocks;
+      for (size_t ifile = first; ifile < last && errors[iblock].empty(); ifile++)
+        blocks[iblock].Add(inputs[ifile], errors[iblock], &selection);
+    });
+
+    //Tree reduction: block i + stride is merged into block i, preserving the input order
+    for (size_t stride = 1; stride < nblocks; stride *= 2) {
+      const size_t npairs = (nblocks + 2 * stride - 1) / (2 * stride);
+      pool.ParallelFor(npairs, [&](size_t ipair, unsigned int) {
+        const size_t target = 2 * stride * ipair, source = target + stride;
+        if (source < nblocks && errors[target].empty() && errors[source].empty())
+          blocks[target].Add(blocks[source], errors[target]);
+      });
+    }
+
+    for (size_t iblock = 0; iblock < nblocks; iblock++)
+      if (!errors[iblock].empty()) {
+        errmsg = errors[iblock];
+        return false;
+      }
+    if (nblocks > 0) {
+      blocks[0].Write(file);
+      _nobjects += blocks[0].NObjects();
+      blocks[0].Clear();
+    }
+  }
+
+  file.Close();
+  return true;
+}
+
+} // namespace Herd
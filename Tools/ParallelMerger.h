@@ -0,0 +1,41 @@
+/*! @file ParallelMerger.h ParallelMerger class declaration. */
+
+#ifndef HERD_PARALLELMERGER_H_
+#define HERD_PARALLELMERGER_H_
+
+// C/C++ standard headers
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Merges any number of output files on several threads.
+ * @class ParallelMerger ParallelMerger.h
+ *
+ * The objects are merged one class at a time (e.g. all the TH3D, then all the TH1D), so only the objects of one
+ * class are in memory. For each class the input list is split into one contiguous block per thread; every block is
+ * merged in file order by an OutputMerger, then the blocks are combined pairwise (a tree reduction) keeping their
+ * order. Histogram contents are summed in a different order than a serial merge only when they are not integers, so
+ * count histograms are identical to the ones of OutputMerger.
+ */
+class ParallelMerger {
+public:
+  explicit ParallelMerger(unsigned int nthreads);
+
+  /*! @brief Merges the inputs into output.
+   *
+   * @return false if an input cannot be read or two histograms with the same name have different binnings.
+   */
+  bool Merge(const std::vector<std::string> &inputs, const std::string &output, std::string &errmsg);
+
+  /*! @brief Number of objects written by the last Merge. */
+  size_t NObjects() const { return _nobjects; }
+
+private:
+  unsigned int _nthreads;
+  size_t _nobjects;
+};
+
+} // namespace Herd
+
+#endif /* HERD_PARALLELMERGER_H_ */
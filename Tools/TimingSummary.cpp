@@ -0,0 +1,128 @@
+/*! @file TimingSummary.cpp Helpers to run EventAnalysis and read the ProcessTimer summaries of its output. */
+
+#include "TimingSummary.h"
+
+// Root headers
+#include "TFile.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TList.h"
+
+// C/C++ standard headers
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// POSIX headers
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace Herd {
+
+namespace {
+const std::string summaryprefix = "h_timingsummary_";
+const std::string latencyprefix = "h_timing_";
+}
+
+int RunEventAnalysis(const std::string &executable, const std::string &config, const std::string &log,
+                     const std::string &preload) {
+  pid_t pid = fork();
+  if (pid < 0) return -1;
+  if (pid == 0) {
+    int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    if (!preload.empty()) {
+      const char *current = getenv("LD_PRELOAD");
+      setenv("LD_PRELOAD", (current && *current ? preload + ":" + current : preload).c_str(), 1);
+    }
+    execlp(executable.c_str(), executable.c_str(), "-c", config.c_str(), (char *)nullptr);
+    perror("execlp");
+    _exit(127);
+  }
+  int status;
+  if (waitpid(pid, &status, 0) != pid) return -1;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+std::string DefaultAllocHooks() {
+  char path[PATH_MAX];
+  ssize_t size = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (size <= 0) return "libacceptanceAllocHooks.so";
+  const std::string exe(path, size);
+  return exe.substr(0, exe.rfind('/') + 1) + "libacceptanceAllocHooks.so";
+}
+
+bool ReadTimingSummaries(const std::string &filename, std::map<std::string, std::unique_ptr<TH1>> &summaries,
+                         std::string &errmsg, std::map<std::string, std::unique_ptr<TH1>> *latencies) {
+  std::unique_ptr<TFile> file(TFile::Open(filename.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    errmsg = "Cannot open " + filename;
+    return false;
+  }
+  //Keys are listed with the highest cycle first: older cycles of the same object are skipped
+  TList *keys = file->GetListOfKeys();
+  for (int ikey = 0; keys && ikey < keys->GetSize(); ikey++) {
+    TKey *key = static_cast<TKey *>(keys->At(ikey));
+    const std::string name = key->GetName();
+    std::map<std::string, std::unique_ptr<TH1>> *target = nullptr;
+    std::string algoname;
+    if (name.compare(0, summaryprefix.size(), summaryprefix) == 0) {
+      target = &summaries;
+      algoname = name.substr(summaryprefix.size());
+    } else if (latencies && name.compare(0, latencyprefix.size(), latencyprefix) == 0) {
+      target = latencies;
+      algoname = name.substr(latencyprefix.size());
+    }
+    if (!target || target->count(algoname)) continue;
+    std::unique_ptr<TObject> object(key->ReadObj());
+    TH1 *histo = dynamic_cast<TH1 *>(object.get());
+    if (!histo) continue;
+    histo->SetDirectory(nullptr);
+    object.release();
+    (*target)[algoname].reset(histo);
+  }
+  return true;
+}
+
+double SummaryValue(const TH1 &summary, const char *label) {
+  for (int bin = 1; bin <= summary.GetNbinsX(); bin++)
+    if (strcmp(summary.GetXaxis()->GetBinLabel(bin), label) == 0) return summary.GetBinContent(bin);
+  return -1.;
+}
+
+double SummaryRatio(const TH1 &summary, const char *numerator, const char *denominator) {
+  const double num = SummaryValue(summary, numerator), den = SummaryValue(summary, denominator);
+  if (num < 0 || den < 0) return -1.;
+  return den > 0 ? num / den : 0.;
+}
+
+double LatencyQuantile(const TH1 &latency, double q) {
+  const int nbins = latency.GetNbinsX();
+  double ncalls = 0.;
+  for (int bin = 0; bin <= nbins + 1; bin++) ncalls += latency.GetBinContent(bin);
+  if (ncalls == 0) return 0.;
+  const double target = q * ncalls;
+  const TAxis &axis = *latency.GetXaxis();
+  double cumulative = 0.;
+  for (int bin = 0; bin <= nbins + 1; bin++) {
+    const double count = latency.GetBinContent(bin);
+    if (count > 0 && cumulative + count >= target) {
+      if (bin == 0) return axis.GetXmin();
+      if (bin == nbins + 1) return axis.GetXmax();
+      //Geometric interpolation, the bins being uniform in log
+      const double low = axis.GetBinLowEdge(bin), high = axis.GetBinUpEdge(bin);
+      return low * std::pow(high / low, (target - cumulative) / count);
+    }
+    cumulative += count;
+  }
+  return axis.GetXmax();
+}
+
+} // namespace Herd
@@ -0,0 +1,48 @@
+/*! @file TimingSummary.h Helpers to run EventAnalysis and read the ProcessTimer summaries of its output. */
+
+#ifndef HERD_TIMINGSUMMARY_H_
+#define HERD_TIMINGSUMMARY_H_
+
+// C/C++ standard headers
+#include <map>
+#include <memory>
+#include <string>
+
+class TH1;
+
+namespace Herd {
+
+/*! @brief Runs "executable -c config" with stdout and stderr redirected to log.
+ *
+ * @param preload Library preloaded in the child (e.g. the allocation hooks), nothing if empty.
+ * @return The exit status of the child, 128 + the signal if it was killed, -1 if it could not be run.
+ */
+int RunEventAnalysis(const std::string &executable, const std::string &config, const std::string &log,
+                     const std::string &preload);
+
+/*! @brief The allocation hooks library (libacceptanceAllocHooks.so) next to the running executable. */
+std::string DefaultAllocHooks();
+
+/*! @brief Reads the timing summaries (h_timingsummary_<algorithm>, see ProcessTimer) of an output file.
+ *
+ * @param summaries Filled with the summaries by algorithm name, the highest cycle of each.
+ * @param latencies If not null, filled with the latency histograms (h_timing_<algorithm>) in the same way.
+ * @return false if the file cannot be read.
+ */
+bool ReadTimingSummaries(const std::string &filename, std::map<std::string, std::unique_ptr<TH1>> &summaries,
+                         std::string &errmsg, std::map<std::string, std::unique_ptr<TH1>> *latencies = nullptr);
+
+/*! @brief Content of the summary bin with the given label, or -1 if there is none. */
+double SummaryValue(const TH1 &summary, const char *label);
+
+/*! @brief Ratio of two summary bins (e.g. "total (ns)" over "calls" for the mean latency), 0 if the denominator is 0,
+ *         or -1 if one of them is missing. */
+double SummaryRatio(const TH1 &summary, const char *numerator, const char *denominator);
+
+/*! @brief Latency (ns) below which the fraction q of the calls are, interpolated in the log bins of h_timing_<algo>.
+ *         Calls in the overflow are set at the upper edge of the axis. */
+double LatencyQuantile(const TH1 &latency, double q);
+
+} // namespace Herd
+
+#endif /* HERD_TIMINGSUMMARY_H_ */
@@ -0,0 +1,247 @@
+/*! @file acceptanceBuilder.cpp Computes the acceptance and its uncertainties from any number of outputs.
+ *
+ * The selected (mcEnergyHisto) and generated (mcGenSpectrum) counts of all the inputs are summed exactly, then the
+ * acceptance of every energy bin is the selection efficiency times the geometric factor of the generation sphere,
+ * pi * 4 pi R^2, with a Clopper-Pearson or Wilson interval. If the inputs contain the energy-angle distribution of the
+ * selected events (mcAngleDistribution) the acceptance of every (energy, cos(theta), phi) cell is computed too, for a
+ * generation isotropic in direction: the generated events of a cell are the ones of its energy bin times
+ * dcos(theta) dphi / 4 pi, and its acceptance is the efficiency times pi R^2 dcos(theta) dphi.
+ *
+ * Usage: acceptanceBuilder -o <summary.root> [-s selected] [-g generated] [-a angular] [-r radius] [-m cp|wilson]
+ *                          [-c cl] [-j nthreads] [-l filelist] [input.root ...]
+ */
+
+#include "AcceptanceBuilder.h"
+#include "EaConfig.h"
+#include "Utils/WorkStealingPool.h"
+
+// Root headers
+#include "TFile.h"
+#include "TGraphAsymmErrors.h"
+#include "TH1.h"
+#include "TMath.h"
+#include "TROOT.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " -o <summary.root> [-s selected] [-g generated] [-a angular] [-r radius] [-m cp|wilson] [-c cl]"
+               " [-j nthreads] [-l filelist] [input.root ...]\n"
+            << "  -s  Histogram of the selected events (default: h_calo_filtered_fidvolume)\n"
+            << "  -g  Histogram of the generated events (default: h_mcgenspectrum)\n"
+            << "  -a  Energy-angle distribution of the selected events, empty to skip (default: h_angularDistribution)\n"
+            << "  -r  Radius of the generation sphere in m (default: 3)\n"
+            << "  -m  Confidence interval: cp (Clopper-Pearson) or wilson (default: cp)\n"
+            << "  -c  Confidence level (default: 0.6827)\n"
+            << "  -j  Number of threads reading the inputs (default: number of cores)\n"
+            << "  -l  Text file with one input per line, read before the inputs on the command line\n";
+}
+
+struct Sums {
+  Herd::CountSum selected, generated, angular;
+  size_t nangular = 0;
+  std::string error;
+};
+
+//Adds the histogram name of file to sum; false if it is missing or cannot be added
+bool AddHisto(TFile &file, const std::string &name, Herd::CountSum &sum, std::string &errmsg) {
+  std::unique_ptr<TH1> histo(file.Get<TH1>(name.c_str()));
+  if (!histo) {
+    errmsg = std::string(file.GetName()) + ": no histogram " + name;
+    return false;
+  }
+  if (!sum.Add(*histo, errmsg)) {
+    errmsg = std::string(file.GetName()) + ": " + errmsg;
+    return false;
+  }
+  return true;
+}
+
+bool SameEdges(const TAxis &a, const TAxis &b) {
+  if (a.GetNbins() != b.GetNbins()) return false;
+  for (int ibin = 1; ibin <= a.GetNbins() + 1; ibin++)
+    if (a.GetBinLowEdge(ibin) != b.GetBinLowEdge(ibin)) return false;
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string output, filelist, selname = "h_calo_filtered_fidvolume", genname = "h_mcgenspectrum",
+                                angname = "h_angularDistribution", methodname = "cp";
+  double radius = 3, cl = 0.6827;
+  unsigned int nthreads = std::thread::hardware_concurrency();
+
+  int opt;
+  while ((opt = getopt(argc, argv, "o:s:g:a:r:m:c:j:l:h")) != -1) {
+    switch (opt) {
+    case 'o': output = optarg; break;
+    case 's': selname = optarg; break;
+    case 'g': genname = optarg; break;
+    case 'a': angname = optarg; break;
+    case 'r': radius = std::atof(optarg); break;
+    case 'm': methodname = optarg; break;
+    case 'c': cl = std::atof(optarg); break;
+    case 'j': nthreads = std::atoi(optarg); break;
+    case 'l': filelist = optarg; break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  std::string errmsg;
+  std::vector<std::string> inputs;
+  if (!filelist.empty() && !Herd::EaConfig::ReadFileList(filelist, inputs, errmsg)) {
+    std::cerr << errmsg << std::endl;
+    return 1;
+  }
+  for (int iarg = optind; iarg < argc; iarg++) inputs.push_back(argv[iarg]);
+  Herd::IntervalMethod method;
+  if (output.empty() || inputs.empty() || !Herd::ParseIntervalMethod(methodname, method) || radius <= 0 || cl <= 0 ||
+      cl >= 1) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  //Sum the counts: contiguous blocks of inputs on each thread, then the blocks in order
+  ROOT::EnableThreadSafety();
+  TH1::AddDirectory(false);
+  const size_t nblocks = std::min(inputs.size(), (size_t)std::max(1u, nthreads));
+  std::vector<Sums> blocks(nblocks);
+  Herd::WorkStealingPool pool(nblocks);
+  pool.ParallelFor(nblocks, [&](size_t iblock, unsigned int) {
+    Sums &sums = blocks[iblock];
+    const size_t first = inputs.size() * iblock / nblocks, last = inputs.size() * (iblock + 1) / nblocks;
+    for (size_t ifile = first; ifile < last; ifile++) {
+      std::unique_ptr<TFile> file(TFile::Open(inputs[ifile].c_str(), "READ"));
+      if (!file || file->IsZombie()) {
+        sums.error = "Cannot read " + inputs[ifile];
+        return;
+      }
+      if (!AddHisto(*file, selname, sums.selected, sums.error) || !AddHisto(*file, genname, sums.generated, sums.error))
+        return;
+      if (!angname.empty() && file->GetKey(angname.c_str())) {
+        if (!AddHisto(*file, angname, sums.angular, sums.error)) return;
+        sums.nangular++;
+      }
+      file->Close();
+    }
+  });
+  Sums total;
+  for (auto &block : blocks) {
+    if (!block.error.empty()) { std::cerr << block.error << std::endl; return 1; }
+    if (!total.selected.Add(block.selected, errmsg) || !total.generated.Add(block.generated, errmsg) ||
+        !total.angular.Add(block.angular, errmsg)) {
+      std::cerr << errmsg << std::endl;
+      return 1;
+    }
+    total.nangular += block.nangular;
+  }
+  if (total.nangular != 0 && total.nangular != inputs.size()) {
+    std::cerr << angname << " is in " << total.nangular << " of " << inputs.size() << " inputs" << std::endl;
+    return 1;
+  }
+
+  const TH1 &shape = total.generated.Shape();
+  if (total.selected.Shape().GetDimension() != 1 || shape.GetDimension() != 1 ||
+      !SameEdges(*total.selected.Shape().GetXaxis(), *shape.GetXaxis())) {
+    std::cerr << selname << " and " << genname << " must be 1D histograms with the same binning" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<TObject>> results;
+
+  //Energy acceptance
+  {
+    const size_t ncells = total.generated.NCells();
+    std::vector<double> pass(ncells), gen(ncells), eff(ncells), low(ncells), high(ncells);
+    for (size_t cell = 0; cell < ncells; cell++) {
+      pass[cell] = total.selected.Value(cell);
+      gen[cell] = total.generated.Value(cell);
+    }
+    Herd::BinomialIntervals(method, cl, ncells, &pass[0], &gen[0], &eff[0], &low[0], &high[0]);
+
+    const double scale = TMath::Pi() * 4 * TMath::Pi() * radius * radius;
+    std::unique_ptr<TH1> hacceptance(total.selected.ToROOT("h_acceptance", "Acceptance"));
+    hacceptance->GetYaxis()->SetTitle("Acceptance (m^{2} sr)");
+    const int nbins = shape.GetNbinsX();
+    std::unique_ptr<TGraphAsymmErrors> gacceptance(new TGraphAsymmErrors(nbins));
+    gacceptance->SetName("g_acceptance");
+    gacceptance->SetTitle("Acceptance;MC Momentum (GV);Acceptance (m^{2} sr)");
+    for (int ibin = 0; ibin <= nbins + 1; ibin++) {
+      hacceptance->SetBinContent(ibin, eff[ibin] * scale);
+      hacceptance->SetBinError(ibin, 0.5 * (high[ibin] - low[ibin]) * scale);
+      if (ibin == 0 || ibin > nbins) continue;
+      const double lowedge = shape.GetXaxis()->GetBinLowEdge(ibin), highedge = shape.GetXaxis()->GetBinUpEdge(ibin);
+      const double center = 0.5 * (lowedge + highedge);
+      gacceptance->SetPoint(ibin - 1, center, eff[ibin] * scale);
+      gacceptance->SetPointError(ibin - 1, center - lowedge, highedge - center, (eff[ibin] - low[ibin]) * scale,
+                                 (high[ibin] - eff[ibin]) * scale);
+    }
+    results.push_back(total.selected.ToROOT("h_selected", "Selected events"));
+    results.push_back(total.generated.ToROOT("h_generated", "Generated events"));
+    results.push_back(std::move(hacceptance));
+    results.push_back(std::move(gacceptance));
+  }
+
+  //Energy-angle acceptance
+  if (total.nangular > 0) {
+    const TH1 &angshape = total.angular.Shape();
+    if (angshape.GetDimension() != 3 || !SameEdges(*angshape.GetXaxis(), *shape.GetXaxis())) {
+      std::cerr << angname << " must be a 3D histogram with the energy binning of " << genname << std::endl;
+      return 1;
+    }
+    const int nE = angshape.GetNbinsX(), nC = angshape.GetNbinsY(), nP = angshape.GetNbinsZ();
+    const size_t ncells = total.angular.NCells();
+    std::vector<double> pass(ncells), gen(ncells, 0.), eff(ncells), low(ncells), high(ncells), solidangle(ncells, 0.);
+    for (int iP = 1; iP <= nP; iP++)
+      for (int iC = 1; iC <= nC; iC++) {
+        const double dcostheta = angshape.GetYaxis()->GetBinUpEdge(iC) - angshape.GetYaxis()->GetBinLowEdge(iC);
+        const double dphi = angshape.GetZaxis()->GetBinUpEdge(iP) - angshape.GetZaxis()->GetBinLowEdge(iP);
+        for (int iE = 0; iE <= nE + 1; iE++) {
+          const int cell = angshape.GetBin(iE, iC, iP);
+          solidangle[cell] = dcostheta * dphi;
+          gen[cell] = total.generated.Value(iE) * solidangle[cell] / (4 * TMath::Pi());
+        }
+      }
+    for (size_t cell = 0; cell < ncells; cell++) pass[cell] = total.angular.Value(cell);
+    Herd::BinomialIntervals(method, cl, ncells, &pass[0], &gen[0], &eff[0], &low[0], &high[0]);
+
+    std::unique_ptr<TH1> hacceptance(total.angular.ToROOT("h_acceptance_angular", "Acceptance per solid angle cell"));
+    std::unique_ptr<TH1> hlow(total.angular.ToROOT("h_acceptance_angular_low", "Lower bound of the acceptance"));
+    std::unique_ptr<TH1> hhigh(total.angular.ToROOT("h_acceptance_angular_high", "Upper bound of the acceptance"));
+    for (size_t cell = 0; cell < ncells; cell++) {
+      const double scale = TMath::Pi() * radius * radius * solidangle[cell];
+      hacceptance->SetBinContent(cell, eff[cell] * scale);
+      hacceptance->SetBinError(cell, 0.5 * (high[cell] - low[cell]) * scale);
+      hlow->SetBinContent(cell, low[cell] * scale);
+      hhigh->SetBinContent(cell, high[cell] * scale);
+    }
+    results.push_back(total.angular.ToROOT("h_selected_angular", "Selected events"));
+    results.push_back(std::move(hacceptance));
+    results.push_back(std::move(hlow));
+    results.push_back(std::move(hhigh));
+  }
+
+  TFile file(output.c_str(), "RECREATE");
+  if (file.IsZombie()) { std::cerr << "Cannot write " << output << std::endl; return 1; }
+  for (auto const &result : results) result->Write();
+  file.Close();
+  std::cout << "Acceptance of " << inputs.size() << " files (" << methodname << " intervals, CL " << cl
+            << ") written to " << output << std::endl;
+
+  return 0;
+}
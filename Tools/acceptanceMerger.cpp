@@ -0,0 +1,68 @@
+/*! @file acceptanceMerger.cpp Merges any number of acceptance outputs (replaces hadd and ROOT_Macro/Adder).
+ *
+ * Histograms with the same name are added after checking that their binnings match, graphs get the points of the
+ * following files appended and other objects are taken from the first file. The merge runs on several threads, one
+ * object class at a time to bound the memory; the result depends only on the order of the inputs.
+ *
+ * Usage: acceptanceMerger -o <output.root> [-j nthreads] [-l filelist] [input.root ...]
+ */
+
+#include "EaConfig.h"
+#include "ParallelMerger.h"
+
+// C/C++ standard headers
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0 << " -o <output.root> [-j nthreads] [-l filelist] [input.root ...]\n"
+            << "  -j  Number of threads (default: number of cores)\n"
+            << "  -l  Text file with one input per line, merged before the inputs on the command line\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string output, filelist;
+  unsigned int nthreads = std::thread::hardware_concurrency();
+
+  int opt;
+  while ((opt = getopt(argc, argv, "o:j:l:h")) != -1) {
+    switch (opt) {
+    case 'o': output = optarg; break;
+    case 'j': nthreads = std::atoi(optarg); break;
+    case 'l': filelist = optarg; break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  std::string errmsg;
+  std::vector<std::string> inputs;
+  if (!filelist.empty() && !Herd::EaConfig::ReadFileList(filelist, inputs, errmsg)) {
+    std::cerr << errmsg << std::endl;
+    return 1;
+  }
+  for (int iarg = optind; iarg < argc; iarg++) inputs.push_back(argv[iarg]);
+  if (output.empty() || inputs.empty()) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Herd::ParallelMerger merger(nthreads);
+  if (!merger.Merge(inputs, output, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  std::cout << "Merged " << merger.NObjects() << " objects of " << inputs.size() << " files into " << output << " in "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*! @file allocCheck.cpp Fails if an algorithm allocates memory in Process() once past its warm-up.
+ *
+ * Runs an EventAnalysis configuration with the allocation hooks preloaded (libacceptanceAllocHooks.so, see
+ * Utils/AllocHooks.cpp), so that every ProcessTimer adds the allocation counts to its timing summary, then reads the
+ * summaries back from the output. The check fails if an algorithm makes more steady-state allocations per call than the
+ * tolerance: the default allows only the amortized growth of the outputs kept per event (one block of graph points
+ * every 65536 points, see ShardedPoints). With -r an existing output of such a run is checked without running anything.
+ *
+ * Usage: allocCheck -c <config.eaconf> [-e executable] [-p hookslib] [-o output] [-a algorithm]... [-t tolerance]
+ *        allocCheck -r <output.root> [-a algorithm]... [-t tolerance]
+ */
+
+#include "EaConfig.h"
+#include "TimingSummary.h"
+
+// Root headers
+#include "TH1.h"
+
+// C/C++ standard headers
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " -c <config.eaconf> [-e executable] [-p hookslib] [-o output] [-a algorithm]... [-t tolerance]\n"
+            << "       " << argv0 << " -r <output.root> [-a algorithm]... [-t tolerance]\n"
+            << "  -e  EventAnalysis executable (default: EventAnalysis)\n"
+            << "  -p  Allocation hooks library (default: libacceptanceAllocHooks.so next to this executable)\n"
+            << "  -o  Output of the run, its configuration and log get the .eaconf and .log suffixes"
+               " (default: alloccheck.root)\n"
+            << "  -a  Algorithm to check (can be repeated, default: all the timed algorithms)\n"
+            << "  -t  Allowed steady-state allocations per call (default: 1e-4)\n"
+            << "  -r  Only check an existing output\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string configfile, resultfile, executable = "EventAnalysis", hooks, output = "alloccheck.root";
+  std::set<std::string> algorithms;
+  double tolerance = 1e-4;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "c:e:p:o:a:t:r:h")) != -1) {
+    switch (opt) {
+    case 'c': configfile = optarg; break;
+    case 'e': executable = optarg; break;
+    case 'p': hooks = optarg; break;
+    case 'o': output = optarg; break;
+    case 'a': algorithms.insert(optarg); break;
+    case 't': tolerance = std::atof(optarg); break;
+    case 'r': resultfile = optarg; break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (configfile.empty() == resultfile.empty() || tolerance < 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  if (resultfile.empty()) {
+    std::string errmsg;
+    Herd::EaConfig config;
+    if (!config.Load(configfile, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+    config.SetOutput(output);
+    const std::string runconfig = output + ".eaconf", log = output + ".log";
+    if (!config.Save(runconfig, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+    if (hooks.empty()) hooks = Herd::DefaultAllocHooks();
+    if (access(hooks.c_str(), R_OK) != 0) { std::cerr << "Cannot read the allocation hooks " << hooks << std::endl; return 1; }
+
+    std::cout << "Running " << executable << " on " << runconfig << " with " << hooks << std::endl;
+    const int status = Herd::RunEventAnalysis(executable, runconfig, log, hooks);
+    if (status != 0) { std::cerr << executable << " failed with status " << status << ", see " << log << std::endl; return 1; }
+    resultfile = output;
+  }
+
+  std::string errmsg;
+  std::map<std::string, std::unique_ptr<TH1>> summaries;
+  if (!Herd::ReadTimingSummaries(resultfile, summaries, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+
+  std::set<std::string> missing = algorithms;
+  int nchecked = 0, nfailed = 0;
+  std::cout << std::left << std::setw(32) << "algorithm" << std::right << std::setw(12) << "calls" << std::setw(16)
+            << "allocs/call" << std::setw(16) << "steady/call" << std::setw(16) << "allocating" << std::endl;
+  for (auto const &entry : summaries) {
+    const std::string &algoname = entry.first;
+    const TH1 &summary = *entry.second;
+    if (!algorithms.empty() && !algorithms.count(algoname)) continue;
+    nchecked++;
+    missing.erase(algoname);
+
+    const double steady = Herd::SummaryRatio(summary, "steady allocs", "steady calls");
+    if (steady < 0) {
+      std::cerr << algoname << ": no allocation counts, the hooks were not loaded" << std::endl;
+      nfailed++;
+      continue;
+    }
+    const bool failed = steady > tolerance;
+    if (failed) nfailed++;
+    std::cout << std::left << std::setw(32) << algoname << std::right << std::setw(12)
+              << Herd::SummaryValue(summary, "calls") << std::setw(16) << Herd::SummaryRatio(summary, "allocs", "calls")
+              << std::setw(16) << steady << std::setw(16) << Herd::SummaryValue(summary, "steady allocating calls")
+              << (failed ? "  FAILED" : "") << std::endl;
+  }
+  for (auto const &algoname : missing) {
+    std::cerr << algoname << ": no timing summary in " << resultfile << std::endl;
+    nfailed++;
+  }
+  if (nchecked == 0 && nfailed == 0) { std::cerr << "No timing summary in " << resultfile << std::endl; return 1; }
+
+  std::cout << (nfailed ? "FAILED: " : "OK: ") << nfailed << " of " << nchecked + missing.size()
+            << " algorithms allocate in steady state (tolerance " << tolerance << " per call)" << std::endl;
+  return nfailed ? 1 : 0;
+}
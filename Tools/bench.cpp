@@ -0,0 +1,450 @@
+/*! @file bench.cpp Microbenchmarks of the geometry, Calo and histogram hot paths.
+ *
+ * Without -c the kernels run in this process on synthetic events (primaries from SphereGenerator, Calo showers as
+ * clouds of hits), so no input file and no framework are needed: every kernel processes the same events in each of
+ * its repetitions and the median time per event is reported, with the allocations per event when the allocation
+ * hooks are loaded (-a re-runs the benchmark with them preloaded). The checksum of each kernel only keeps its results
+ * alive. With -i the primaries are those of an EventSample file (see EventCapture), cycled over to nevents, so the
+ * geometry and histogram kernels see the event mix of a production; the Calo showers stay synthetic, since the hit
+ * positions need the Calo geometry.
+ *
+ * These kernels time the building blocks (GeomEngine clipping, CaloMoments, histogram fills), not the algorithms:
+ * CaloGeomFidVolumeAlgo, CaloAxis and CaloGlob need the framework and the Calo geometry, so their Process() is only
+ * measured with -c.
+ *
+ * With -c the algorithms themselves (CaloGeomFidVolumeAlgo, CaloAxis, CaloGlob, the histogram algorithms, ...) are
+ * measured by running an EventAnalysis configuration and reading the ProcessTimer summaries of its output (see
+ * benchmark.eaconf), with the allocation hooks preloaded if -a is given.
+ *
+ * Usage: bench [-n nevents] [-r repetitions] [-s seed] [-i sample] [-H hits] [-k kernel]... [-a] [-l]
+ *        bench -c <config.eaconf> [-e executable] [-o output] [-k algorithm]... [-a]
+ */
+
+#include "EaConfig.h"
+#include "GeomEngine.h"
+#include "TimingSummary.h"
+#include "Calo/CaloMoments.h"
+#include "Core/EventSample.h"
+#include "Histo/HistoEngine.h"
+#include "Histo/ShardedHisto.h"
+#include "Utils/AllocTracker.h"
+#include "Utils/FastRandom.h"
+
+// Root headers
+#include "TH1.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " [-n nevents] [-r repetitions] [-s seed] [-i sample] [-H hits] [-k kernel]... [-a] [-l]\n"
+            << "       " << argv0 << " -c <config.eaconf> [-e executable] [-o output] [-k algorithm]... [-a]\n"
+            << "  -n  Events per repetition (default: 1000000)\n"
+            << "  -r  Repetitions of each kernel (default: 5)\n"
+            << "  -s  Seed of the synthetic events (default: 1)\n"
+            << "  -i  Take the primaries from an EventSample file\n"
+            << "  -H  Calo hits per shower (default: 64)\n"
+            << "  -k  Kernel (or algorithm with -c) to run, can be repeated (default: all)\n"
+            << "  -a  Count the allocations, preloading the allocation hooks\n"
+            << "  -l  List the kernels\n"
+            << "  -c  Run the algorithms of an EventAnalysis configuration instead\n"
+            << "  -e  EventAnalysis executable (default: EventAnalysis)\n"
+            << "  -o  Output of the run, its configuration and log get the .eaconf and .log suffixes"
+               " (default: bench.root)\n";
+}
+
+typedef Herd::Histogram<Herd::Int64Storage, Herd::BinningAxis> Histo1D;
+typedef Herd::Histogram<Herd::Int64Storage, Herd::BinningAxis, Herd::BinningAxis, Herd::BinningAxis> AngleHisto;
+typedef Herd::Histogram<Herd::Int64Storage, Herd::RegularAxis, Herd::RegularAxis, Herd::RegularAxis> CooHisto;
+
+struct Inputs {
+  std::vector<std::array<double, 3>> position, direction;
+  std::vector<double> momentum, costheta, phi;
+  std::vector<std::array<float, 4>> hits; // Edep, X, Y, Z of a pool of hits, nhits consecutive ones per shower
+  unsigned int nhits;
+};
+
+void MakeInputs(uint64_t seed, size_t nevents, unsigned int nhits, Inputs &inputs) {
+  Herd::SphereGenerator generator;
+  std::string errmsg;
+  generator.Configure(300., -1., 10., 10000., errmsg);
+  generator.Seed(seed);
+  inputs.position.resize(nevents);
+  inputs.direction.resize(nevents);
+  inputs.momentum.resize(nevents);
+  inputs.costheta.resize(nevents);
+  inputs.phi.resize(nevents);
+  for (size_t ievent = 0; ievent < nevents; ievent++) {
+    double momentum[3];
+    generator.Generate(inputs.position[ievent].data(), momentum);
+    const double p = std::sqrt(momentum[0] * momentum[0] + momentum[1] * momentum[1] + momentum[2] * momentum[2]);
+    for (int i = 0; i < 3; i++) inputs.direction[ievent][i] = momentum[i] / p;
+    inputs.momentum[ievent] = p;
+    inputs.costheta[ievent] = momentum[2] / p;
+    inputs.phi[ievent] = std::atan2(momentum[1], momentum[0]);
+  }
+
+  //Showers: exponential energies around a random axis through the Calo
+  Herd::Xoshiro256 random;
+  random.Seed(seed + 1);
+  inputs.nhits = nhits;
+  inputs.hits.resize(65536 / nhits * nhits);
+  for (size_t ihit = 0; ihit < inputs.hits.size(); ihit++) {
+    const float depth = 70.f * random.Uniform(), spread = 3.f;
+    auto &hit = inputs.hits[ihit];
+    hit[0] = -std::log(1. - random.Uniform());
+    hit[1] = spread * (2.f * random.Uniform() - 1.f);
+    hit[2] = spread * (2.f * random.Uniform() - 1.f);
+    hit[3] = -depth;
+  }
+}
+
+//Replaces the synthetic primaries with those of a sample, cycling over it
+void SamplePrimaries(const Herd::EventSample &sample, Inputs &inputs) {
+  for (size_t ievent = 0; ievent < inputs.momentum.size(); ievent++) {
+    const Herd::SampleEvent &event = sample.Event(ievent % sample.Size());
+    double p2 = 0;
+    for (int i = 0; i < 3; i++) p2 += (double)event.momentum[i] * event.momentum[i];
+    const double p = std::sqrt(p2) > 0 ? std::sqrt(p2) : 1.;
+    for (int i = 0; i < 3; i++) {
+      inputs.position[ievent][i] = event.position[i];
+      inputs.direction[ievent][i] = event.momentum[i] / p;
+    }
+    inputs.momentum[ievent] = p;
+    inputs.costheta[ievent] = event.momentum[2] / p;
+    inputs.phi[ievent] = std::atan2(event.momentum[1], event.momentum[0]);
+  }
+}
+
+struct Kernel {
+  std::string name, description;
+  std::function<void()> setup;   // Untimed, before every repetition
+  std::function<uint64_t()> run; // Processes all the events, returns a checksum
+};
+
+std::vector<Kernel> MakeKernels(const Inputs &inputs) {
+  std::vector<Kernel> kernels;
+  const size_t nevents = inputs.momentum.size();
+
+  kernels.push_back({"sphere", "SphereGenerator::Generate (SyntheticEvents)", [] {}, [nevents] {
+                       Herd::SphereGenerator generator;
+                       std::string errmsg;
+                       generator.Configure(300., -1., 10., 10000., errmsg);
+                       double position[3], momentum[3], sum = 0;
+                       for (size_t ievent = 0; ievent < nevents; ievent++) {
+                         generator.Generate(position, momentum);
+                         sum += momentum[2];
+                       }
+                       return (uint64_t)(sum != 0);
+                     }});
+
+  //GeomEngine clipping on the volumes of CaloGeomFidVolumeAlgo (checkext, checkint with alpha = 1); the algorithm
+  //computes its crossings with its own plane intersections, so these only give the cost of the geometry
+  auto prism = std::make_shared<Herd::CaloPrism>(), fiducial = std::make_shared<Herd::CaloPrism>();
+  fiducial->Set(79., 33.4, 73.2, 32.4, -36.6, 73.2, 3.);
+  auto clip = [&inputs, nevents](const Herd::CaloPrism &calo) {
+    uint64_t npass = 0;
+    for (size_t ievent = 0; ievent < nevents; ievent++) {
+      double tin, tout;
+      Herd::CaloPrism::Face entry;
+      npass += calo.Clip(inputs.position[ievent].data(), inputs.direction[ievent].data(), tin, tout, entry);
+    }
+    return npass;
+  };
+  kernels.push_back({"prism-clip", "CaloPrism::Clip on the Calo prism (not CheckExt)", [] {}, [=] { return clip(*prism); }});
+  kernels.push_back({"fiducial-clip", "CaloPrism::Clip on the fiducial volume (not CheckInt)", [] {}, [=] { return clip(*fiducial); }});
+
+  kernels.push_back({"moments", "CaloMoments of a synthetic shower, the accumulation of BuildAxis without the axis fit", [] {}, [&inputs, nevents] {
+                       double sum = 0;
+                       const size_t nshowers = inputs.hits.size() / inputs.nhits;
+                       for (size_t ievent = 0; ievent < nevents; ievent++) {
+                         const auto *hit = &inputs.hits[(ievent % nshowers) * inputs.nhits];
+                         Herd::CaloMoments moments;
+                         for (unsigned int ihit = 0; ihit < inputs.nhits; ihit++, hit++)
+                           moments.Add((*hit)[1], (*hit)[2], (*hit)[3], (*hit)[0]);
+                         sum += moments.Cov(0, 0) + moments.Cov(2, 2) + moments.Cog(2);
+                       }
+                       return (uint64_t)(sum != 0);
+                     }});
+
+  kernels.push_back({"hit-reduce", "Energy sum and hit count of a synthetic shower (not CaloGlob)", [] {}, [&inputs, nevents] {
+                       uint64_t nhits = 0;
+                       double edep = 0;
+                       const size_t nshowers = inputs.hits.size() / inputs.nhits;
+                       for (size_t ievent = 0; ievent < nevents; ievent++) {
+                         const auto *hit = &inputs.hits[(ievent % nshowers) * inputs.nhits];
+                         float sum = 0;
+                         int n = 0;
+                         for (unsigned int ihit = 0; ihit < inputs.nhits; ihit++, hit++) {
+                           sum += (*hit)[0];
+                           n += (*hit)[0] > 0;
+                         }
+                         edep += sum;
+                         nhits += n;
+                       }
+                       return nhits + (edep != 0);
+                     }});
+
+  auto linbinning = std::make_shared<Herd::Binning>(), logbinning = std::make_shared<Herd::Binning>(),
+       polarbinning = std::make_shared<Herd::Binning>(), azimuthbinning = std::make_shared<Herd::Binning>();
+  std::string errmsg;
+  linbinning->Set({100, 10, 10000}, false, "", errmsg);
+  logbinning->Set({100, 10, 10000}, true, "", errmsg);
+  polarbinning->Set({100, -1, 1}, false, "", errmsg);
+  azimuthbinning->Set({180, -M_PI, M_PI}, false, "", errmsg);
+  auto findbin = [&inputs, nevents](const Herd::Binning &binning) {
+    uint64_t sum = 0;
+    for (size_t ievent = 0; ievent < nevents; ievent++) sum += binning.FindBin(inputs.momentum[ievent]);
+    return sum;
+  };
+  kernels.push_back({"findbin-lin", "Binning::FindBin, linear axis", [] {}, [=] { return findbin(*linbinning); }});
+  kernels.push_back({"findbin-log", "Binning::FindBin, logarithmic axis", [] {}, [=] { return findbin(*logbinning); }});
+
+  auto energyhisto = std::make_shared<Histo1D>();
+  kernels.push_back({"fill1d", "Momentum histogram fill (mcEnergyHisto)",
+                     [=] { *energyhisto = Histo1D(Herd::BinningAxis(*logbinning)); },
+                     [=, &inputs] {
+                       for (size_t ievent = 0; ievent < nevents; ievent++) energyhisto->Fill(inputs.momentum[ievent]);
+                       return energyhisto->Entries();
+                     }});
+
+  auto anglehisto = std::make_shared<AngleHisto>();
+  auto angleprototype = std::make_shared<AngleHisto>(Herd::BinningAxis(*logbinning), Herd::BinningAxis(*polarbinning),
+                                                     Herd::BinningAxis(*azimuthbinning));
+  kernels.push_back({"fill3d", "(energy, cos(theta), phi) histogram fill (mcAngleDistribution)",
+                     [=] { *anglehisto = *angleprototype; },
+                     [=, &inputs] {
+                       for (size_t ievent = 0; ievent < nevents; ievent++)
+                         anglehisto->Fill(inputs.momentum[ievent], inputs.costheta[ievent], inputs.phi[ievent]);
+                       return anglehisto->Entries();
+                     }});
+
+  auto shardedangles = std::make_shared<Herd::ShardedHistogram<AngleHisto>>();
+  kernels.push_back({"sharded3d", "Dense sharded histogram fill (mcAngleDistribution, deferred)",
+                     [=] {
+                       shardedangles->Reset(*angleprototype);
+                       shardedangles->Fill(0., 0., 0.); // Creates the shard of this thread
+                     },
+                     [=, &inputs] {
+                       for (size_t ievent = 0; ievent < nevents; ievent++)
+                         shardedangles->Fill(inputs.momentum[ievent], inputs.costheta[ievent], inputs.phi[ievent]);
+                       return (uint64_t)1;
+                     }});
+
+  auto shardedcoo = std::make_shared<Herd::ShardedHistogram<CooHisto>>();
+  kernels.push_back({"buffered3d", "Buffered sharded histogram fill, 10^6 cells (MCtruthProcess hgencoo)",
+                     [=] {
+                       shardedcoo->Reset(CooHisto(Herd::RegularAxis(100, -500, 500), Herd::RegularAxis(100, -500, 500),
+                                                  Herd::RegularAxis(100, -500, 500)),
+                                         Herd::ShardedHistogram<CooHisto>::Policy::Buffered);
+                       shardedcoo->Fill(0., 0., 0.);
+                     },
+                     [=, &inputs] {
+                       for (size_t ievent = 0; ievent < nevents; ievent++)
+                         shardedcoo->Fill(inputs.position[ievent][0], inputs.position[ievent][1],
+                                          inputs.position[ievent][2]);
+                       return (uint64_t)1;
+                     }});
+
+  return kernels;
+}
+
+//Checks that the closed-form estimate of Binning::FindBin lands within one bin of the result on the benchmark axes
+//and on the production ones (mcEnergyHisto, CaloAxis hhitedep), otherwise the correction loops are not O(1)
+bool CheckBinEstimates() {
+  const struct { int nbins; double low, high; bool log; } axes[] = {
+      {100, 10, 10000, false}, {100, 10, 10000, true}, {30, 10, 10000, true}, {1500, 1e-10, 1e+5, true}};
+  bool good = true;
+  for (auto const &axis : axes) {
+    Herd::Binning binning;
+    std::string errmsg;
+    binning.Set({(double)axis.nbins, axis.low, axis.high}, axis.log, "", errmsg);
+    const std::vector<double> &edges = binning.Edges();
+    int worst = 0;
+    for (int bin = 0; bin < axis.nbins; bin++) {
+      for (int step = 0; step < 64; step++) {
+        const double x = edges[bin] + (edges[bin + 1] - edges[bin]) * step / 64.;
+        worst = std::max(worst, std::abs(binning.EstimateBin(x) - binning.FindBin(x)));
+      }
+      const double last = std::nextafter(edges[bin + 1], edges[bin]);
+      worst = std::max(worst, std::abs(binning.EstimateBin(last) - binning.FindBin(last)));
+    }
+    if (worst > 1) {
+      std::cerr << "Binning estimate off by " << worst << " bins on the " << (axis.log ? "log" : "linear") << " axis ("
+                << axis.nbins << ", " << axis.low << ", " << axis.high << ")" << std::endl;
+      good = false;
+    }
+  }
+  return good;
+}
+
+//Re-runs this program with the allocation hooks preloaded, -a removed; returns only on failure
+int RerunWithHooks(int argc, char **argv) {
+  const std::string hooks = Herd::DefaultAllocHooks();
+  if (access(hooks.c_str(), R_OK) != 0) {
+    std::cerr << "Cannot read the allocation hooks " << hooks << std::endl;
+    return 1;
+  }
+  std::vector<char *> args;
+  for (int iarg = 0; iarg < argc; iarg++)
+    if (std::string(argv[iarg]) != "-a") args.push_back(argv[iarg]);
+  args.push_back(nullptr);
+  const char *preload = getenv("LD_PRELOAD");
+  setenv("LD_PRELOAD", (preload && *preload ? hooks + ":" + preload : hooks).c_str(), 1);
+  execv("/proc/self/exe", args.data());
+  perror("execv");
+  return 1;
+}
+
+int RunKernels(const std::vector<Kernel> &kernels, const std::set<std::string> &selected, size_t nevents,
+               int nrepetitions) {
+  const bool allocs = Herd::AllocTrackingActive();
+  std::cout << std::left << std::setw(14) << "kernel" << std::right << std::setw(14) << "ns/event" << std::setw(14)
+            << "min ns/event" << std::setw(14) << "Mevents/s" << std::setw(14) << "allocs/event" << std::setw(14)
+            << "checksum" << "  " << std::left << "description" << std::endl;
+  for (auto const &kernel : kernels) {
+    if (!selected.empty() && !selected.count(kernel.name)) continue;
+    std::vector<double> nsperevent;
+    Herd::AllocCount used{0, 0};
+    uint64_t checksum = 0;
+    for (int irepetition = 0; irepetition < nrepetitions; irepetition++) {
+      kernel.setup();
+      const Herd::AllocCount before = Herd::CurrentAllocCount();
+      const auto start = std::chrono::steady_clock::now();
+      checksum = kernel.run();
+      const auto stop = std::chrono::steady_clock::now();
+      const Herd::AllocCount after = Herd::CurrentAllocCount();
+      nsperevent.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / nevents);
+      used = {after.allocs - before.allocs, after.bytes - before.bytes}; // Last repetition: warm caches and pools
+    }
+    std::sort(nsperevent.begin(), nsperevent.end());
+    const double median = nsperevent[nsperevent.size() / 2];
+    std::cout << std::left << std::setw(14) << kernel.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << median << std::setw(14) << nsperevent.front() << std::setw(14) << 1e3 / median
+              << std::setw(14);
+    if (allocs)
+      std::cout << std::setprecision(4) << (double)used.allocs / nevents;
+    else
+      std::cout << "n/a";
+    std::cout << std::setw(14) << checksum << "  " << std::left << kernel.description << std::endl;
+  }
+  return 0;
+}
+
+int RunConfig(const std::string &configfile, const std::string &executable, const std::string &output,
+              const std::set<std::string> &selected, bool allocs) {
+  std::string errmsg;
+  Herd::EaConfig config;
+  if (!config.Load(configfile, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  config.SetOutput(output);
+  const std::string runconfig = output + ".eaconf", log = output + ".log";
+  if (!config.Save(runconfig, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  const std::string hooks = allocs ? Herd::DefaultAllocHooks() : "";
+  if (allocs && access(hooks.c_str(), R_OK) != 0) { std::cerr << "Cannot read the allocation hooks " << hooks << std::endl; return 1; }
+
+  std::cout << "Running " << executable << " on " << runconfig << (allocs ? " with " + hooks : "") << std::endl;
+  const int status = Herd::RunEventAnalysis(executable, runconfig, log, hooks);
+  if (status != 0) { std::cerr << executable << " failed with status " << status << ", see " << log << std::endl; return 1; }
+
+  std::map<std::string, std::unique_ptr<TH1>> summaries, latencies;
+  if (!Herd::ReadTimingSummaries(output, summaries, errmsg, &latencies)) { std::cerr << errmsg << std::endl; return 1; }
+  std::cout << std::left << std::setw(32) << "algorithm" << std::right << std::setw(12) << "calls" << std::setw(14)
+            << "ns/call" << std::setw(14) << "p99 ns" << std::setw(14) << "Mcalls/s" << std::setw(14) << "allocs/call"
+            << std::endl;
+  for (auto const &entry : summaries) {
+    if (!selected.empty() && !selected.count(entry.first)) continue;
+    const TH1 &summary = *entry.second;
+    const double mean = Herd::SummaryRatio(summary, "total (ns)", "calls"), nallocs = Herd::SummaryRatio(summary, "allocs", "calls");
+    auto latency = latencies.find(entry.first);
+    const double p99 = latency != latencies.end() ? Herd::LatencyQuantile(*latency->second, 0.99) : -1.;
+    std::cout << std::left << std::setw(32) << entry.first << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << Herd::SummaryValue(summary, "calls") << std::setprecision(1) << std::setw(14) << mean
+              << std::setw(14) << p99 << std::setprecision(3) << std::setw(14)
+              << (mean > 0 ? 1e3 / mean : 0.) << std::setw(14);
+    if (nallocs >= 0)
+      std::cout << std::setprecision(4) << nallocs;
+    else
+      std::cout << "n/a";
+    std::cout << std::endl;
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string configfile, executable = "EventAnalysis", output = "bench.root", samplefile;
+  std::set<std::string> selected;
+  unsigned long long nevents = 1000000, seed = 1;
+  int nrepetitions = 5, nhits = 64;
+  bool allocs = false, list = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:r:s:i:H:k:alc:e:o:h")) != -1) {
+    switch (opt) {
+    case 'n': nevents = std::strtoull(optarg, nullptr, 10); break;
+    case 'r': nrepetitions = std::atoi(optarg); break;
+    case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+    case 'i': samplefile = optarg; break;
+    case 'H': nhits = std::atoi(optarg); break;
+    case 'k': selected.insert(optarg); break;
+    case 'a': allocs = true; break;
+    case 'l': list = true; break;
+    case 'c': configfile = optarg; break;
+    case 'e': executable = optarg; break;
+    case 'o': output = optarg; break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (nevents == 0 || nrepetitions <= 0 || nhits <= 0 || nhits > 65536) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  if (!configfile.empty()) return RunConfig(configfile, executable, output, selected, allocs);
+  if (allocs && !Herd::AllocTrackingActive()) return RerunWithHooks(argc, argv);
+
+  Inputs inputs;
+  MakeInputs(seed, list ? 1 : nevents, nhits, inputs);
+  if (!samplefile.empty() && !list) {
+    Herd::EventSample sample;
+    std::string errmsg;
+    if (!sample.Read(samplefile, errmsg) || sample.Size() == 0) {
+      std::cerr << (errmsg.empty() ? samplefile + " has no events" : errmsg) << std::endl;
+      return 1;
+    }
+    SamplePrimaries(sample, inputs);
+  }
+  const std::vector<Kernel> kernels = MakeKernels(inputs);
+  if (list) {
+    for (auto const &kernel : kernels) std::cout << std::left << std::setw(14) << kernel.name << kernel.description << std::endl;
+    return 0;
+  }
+  for (auto const &name : selected) {
+    if (std::none_of(kernels.begin(), kernels.end(), [&name](const Kernel &kernel) { return kernel.name == name; })) {
+      std::cerr << "Unknown kernel " << name << std::endl;
+      return 1;
+    }
+  }
+  if (!CheckBinEstimates()) return 1;
+  return RunKernels(kernels, selected, nevents, nrepetitions);
+}
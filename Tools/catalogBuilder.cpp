@@ -0,0 +1,112 @@
+/*! @file catalogBuilder.cpp Indexes a data directory and splits it into shards of similar processing cost.
+ *
+ * The index file keeps, for every data file, its size, modification time, number of events and momentum range; on
+ * each run only new or changed files are read, on several threads. The shards are file lists balanced on the predicted
+ * cost of their files: entries times the time per event measured by previous forkRunner runs (timings.txt in the
+ * forkRunner work directory) in the momentum range of the file. Without timings the cost is the number of entries.
+ *
+ * Usage: catalogBuilder -i <datadir> [-s] [-x extension] [-c index] [-t tree] [-m momentum] [-T timings]...
+ *                       [-n nshards] [-o prefix] [-j nthreads]
+ */
+
+#include "Catalog.h"
+#include "EaConfig.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " -i <datadir> [-s] [-x extension] [-c index] [-t tree] [-m momentum] [-T timings]... [-n nshards]"
+               " [-o prefix] [-j nthreads]\n"
+            << "  -s  Search also the first level of subdirectories\n"
+            << "  -x  Extension of the data files (default: .root)\n"
+            << "  -c  Index file, updated incrementally (default: <datadir>/catalog.txt)\n"
+            << "  -t  Name of the event tree (default: Events)\n"
+            << "  -m  Tree expression of the primary momentum, for the momentum range (default: none)\n"
+            << "  -T  Timings of a previous run for the cost model (can be repeated)\n"
+            << "  -n  Number of shards (default: 0, only update the index)\n"
+            << "  -o  Prefix of the shard lists, written as <prefix>_<i>.txt (default: shard)\n"
+            << "  -j  Threads reading the data files (default: number of cores)\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string datadir, extension = ".root", indexfile, treename = "Events", momexpr, prefix = "shard";
+  std::vector<std::string> timings;
+  bool subdirs = false;
+  unsigned int nshards = 0;
+  unsigned int nthreads = std::thread::hardware_concurrency();
+
+  int opt;
+  while ((opt = getopt(argc, argv, "i:sx:c:t:m:T:n:o:j:h")) != -1) {
+    switch (opt) {
+    case 'i': datadir = optarg; break;
+    case 's': subdirs = true; break;
+    case 'x': extension = optarg; break;
+    case 'c': indexfile = optarg; break;
+    case 't': treename = optarg; break;
+    case 'm': momexpr = optarg; break;
+    case 'T': timings.push_back(optarg); break;
+    case 'n': nshards = std::atoi(optarg); break;
+    case 'o': prefix = optarg; break;
+    case 'j': nthreads = std::atoi(optarg); break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (datadir.empty()) {
+    Usage(argv[0]);
+    return 1;
+  }
+  if (indexfile.empty()) indexfile = datadir + "/catalog.txt";
+
+  std::string errmsg;
+  Herd::Catalog catalog;
+  if (!catalog.Load(indexfile, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  const size_t nread = catalog.Scan(datadir, subdirs, extension, treename, momexpr, nthreads);
+  if (!catalog.Save(indexfile, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+
+  long long nentries = 0;
+  size_t nbad = 0;
+  for (auto const &entry : catalog.Entries()) {
+    if (entry.entries < 0) nbad++;
+    else nentries += entry.entries;
+  }
+  std::cout << "Indexed " << catalog.Entries().size() << " files (" << nread << " read, " << nbad << " unreadable), "
+            << nentries << " events, into " << indexfile << std::endl;
+  if (nshards == 0) return 0;
+
+  Herd::CostModel model;
+  for (auto const &filename : timings)
+    if (!model.Calibrate(filename, catalog, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  if (!timings.empty() && !model.IsCalibrated())
+    std::cerr << "No file of the timings is in the index, the cost is the number of entries" << std::endl;
+
+  std::vector<double> costs;
+  auto shards = Herd::MakeShards(catalog, model, nshards, costs);
+  for (size_t ishard = 0; ishard < shards.size(); ishard++) {
+    std::vector<std::string> files;
+    for (auto entry : shards[ishard]) files.push_back(entry->path);
+    const std::string filename = prefix + "_" + std::to_string(ishard) + ".txt";
+    if (!Herd::EaConfig::WriteFileList(filename, files, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+    std::cout << filename << ": " << files.size() << " files, cost " << costs[ishard]
+              << (model.IsCalibrated() ? " s" : " events") << std::endl;
+  }
+  auto range = std::minmax_element(costs.begin(), costs.end());
+  if (*range.second > 0)
+    std::cout << "Cheapest/most expensive shard: " << *range.first / *range.second << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/*! @file forkRunner.cpp Runs an EventAnalysis configuration on several processes and merges the outputs.
+ *
+ * The data list of the configuration is split into chunks of a few files. Up to nworkers EventAnalysis processes run
+ * at the same time, each on one chunk with a copy of the configuration pointing to the chunk list and to a chunk
+ * output; a new chunk is started as soon as a worker finishes, so slow files do not hold the others back. At the end
+ * the chunk outputs are merged, in chunk order, into the output of the original configuration. The processing time
+ * of every data file (the chunk time shared among its files) is written to timings.txt in the work directory, for
+ * the cost model of catalogBuilder.
+ *
+ * Each chunk sees its events numbered from 0, so configurations setting an mcGenSpectrum eventrange are rejected.
+ *
+ * Usage: forkRunner -c <config.eaconf> [-j nworkers] [-n filesperchunk] [-w workdir] [-e executable] [-o output] [-k]
+ */
+
+#include "EaConfig.h"
+#include "ParallelMerger.h"
+
+// C/C++ standard headers
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX headers
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Chunk {
+  std::string config;
+  std::string output;
+  std::string log;
+  std::vector<std::string> files;
+  int status = -1;
+  double seconds = 0;
+};
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " -c <config.eaconf> [-j nworkers] [-n filesperchunk] [-w workdir] [-e executable] [-o output] [-k]\n"
+            << "  -j  Number of concurrent EventAnalysis processes (default: number of cores)\n"
+            << "  -n  Files of the data list per chunk (default: 1)\n"
+            << "  -w  Directory for the chunk configurations, logs and outputs (default: <output>.chunks)\n"
+            << "  -e  EventAnalysis executable (default: EventAnalysis)\n"
+            << "  -o  Merged output (default: the Persistence output of the configuration)\n"
+            << "  -k  Keep the chunk outputs after merging\n";
+}
+
+//Starts the executable on a configuration, with stdout and stderr redirected to a log file
+pid_t Spawn(const std::string &executable, const Chunk &chunk) {
+  pid_t pid = fork();
+  if (pid != 0) return pid;
+  int fd = open(chunk.log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0) {
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+  }
+  execlp(executable.c_str(), executable.c_str(), "-c", chunk.config.c_str(), (char *)nullptr);
+  perror("execlp");
+  _exit(127);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string configfile, workdir, output, executable = "EventAnalysis";
+  unsigned int nworkers = std::thread::hardware_concurrency();
+  unsigned int filesperchunk = 1;
+  bool keep = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "c:j:n:w:e:o:kh")) != -1) {
+    switch (opt) {
+    case 'c': configfile = optarg; break;
+    case 'j': nworkers = std::atoi(optarg); break;
+    case 'n': filesperchunk = std::atoi(optarg); break;
+    case 'w': workdir = optarg; break;
+    case 'e': executable = optarg; break;
+    case 'o': output = optarg; break;
+    case 'k': keep = true; break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (configfile.empty() || nworkers == 0 || filesperchunk == 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  std::string errmsg;
+  Herd::EaConfig config;
+  if (!config.Load(configfile, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  //Every chunk restarts the event index at 0, so event ranges would select the wrong events
+  if (config.SetsParameter("eventrange")) {
+    std::cerr << configfile << " sets eventrange, which counts events from the start of the whole data list: split the"
+              << " datasets with mcGenSpectrum bymomentum instead" << std::endl;
+    return 1;
+  }
+  if (output.empty()) output = config.Output();
+  if (output.empty()) { std::cerr << "No output file: set one with -o" << std::endl; return 1; }
+  if (workdir.empty()) workdir = output + ".chunks";
+
+  std::vector<std::string> files;
+  if (!Herd::EaConfig::ReadFileList(config.DataList(), files, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  if (files.empty()) { std::cerr << "Empty data list " << config.DataList() << std::endl; return 1; }
+
+  if (mkdir(workdir.c_str(), 0755) != 0 && errno != EEXIST) { std::cerr << "Cannot create " << workdir << std::endl; return 1; }
+
+  //Write the list and the configuration of every chunk
+  std::vector<Chunk> chunks;
+  for (size_t first = 0; first < files.size(); first += filesperchunk) {
+    const std::string prefix = workdir + "/chunk_" + std::to_string(chunks.size());
+    std::vector<std::string> chunkfiles(files.begin() + first, files.begin() + std::min(files.size(), first + filesperchunk));
+    Chunk chunk;
+    chunk.config = prefix + ".eaconf";
+    chunk.output = prefix + ".root";
+    chunk.log = prefix + ".log";
+    chunk.files = chunkfiles;
+    Herd::EaConfig chunkconfig = config;
+    chunkconfig.SetDataList(prefix + ".txt");
+    chunkconfig.SetOutput(chunk.output);
+    if (!Herd::EaConfig::WriteFileList(prefix + ".txt", chunkfiles, errmsg) || !chunkconfig.Save(chunk.config, errmsg)) {
+      std::cerr << errmsg << std::endl;
+      return 1;
+    }
+    chunks.push_back(chunk);
+  }
+  if (nworkers > chunks.size()) nworkers = chunks.size();
+  std::cout << "Running " << chunks.size() << " chunks of " << filesperchunk << " files on " << nworkers << " processes"
+            << std::endl;
+
+  //Dynamic scheduling: the next chunk goes to the first worker which becomes free
+  typedef std::chrono::steady_clock Clock;
+  const auto start = Clock::now();
+  std::map<pid_t, std::pair<size_t, Clock::time_point>> running;
+  size_t next = 0, ndone = 0, nfailed = 0;
+  while (ndone < chunks.size()) {
+    while (running.size() < nworkers && next < chunks.size()) {
+      pid_t pid = Spawn(executable, chunks[next]);
+      if (pid < 0) { perror("fork"); return 1; }
+      running[pid] = std::make_pair(next++, Clock::now());
+    }
+    int status;
+    pid_t pid = wait(&status);
+    if (pid < 0) { perror("wait"); return 1; }
+    auto it = running.find(pid);
+    if (it == running.end()) continue;
+    Chunk &chunk = chunks[it->second.first];
+    chunk.status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    chunk.seconds = std::chrono::duration<double>(Clock::now() - it->second.second).count();
+    running.erase(it);
+    ndone++;
+    if (chunk.status != 0) {
+      nfailed++;
+      std::cerr << "Chunk " << chunk.config << " failed with status " << chunk.status << ", see " << chunk.log << std::endl;
+    }
+    std::cout << "\r" << ndone << "/" << chunks.size() << " chunks done" << std::flush;
+  }
+  double slowest = 0;
+  for (auto const &chunk : chunks) slowest = std::max(slowest, chunk.seconds);
+  std::cout << " in " << std::chrono::duration<double>(Clock::now() - start).count() << " s (slowest chunk " << slowest
+            << " s)" << std::endl;
+
+  //Time per data file of the successful chunks
+  std::ofstream timings(workdir + "/timings.txt");
+  timings << "# path seconds\n";
+  for (auto const &chunk : chunks)
+    if (chunk.status == 0)
+      for (auto const &file : chunk.files) timings << file << " " << chunk.seconds / chunk.files.size() << "\n";
+  timings.close();
+
+  if (nfailed) {
+    std::cerr << nfailed << " chunks failed, the outputs are not merged" << std::endl;
+    return 1;
+  }
+
+  //Merge in chunk order, so the output does not depend on the scheduling
+  std::vector<std::string> outputs;
+  for (auto const &chunk : chunks) outputs.push_back(chunk.output);
+  Herd::ParallelMerger merger(nworkers);
+  if (!merger.Merge(outputs, output, errmsg)) { std::cerr << errmsg << std::endl; return 1; }
+  std::cout << "Merged " << merger.NObjects() << " objects into " << output << std::endl;
+
+  if (!keep)
+    for (auto const &chunk : chunks) std::remove(chunk.output.c_str());
+
+  return 0;
+}
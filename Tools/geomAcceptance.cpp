@@ -0,0 +1,208 @@
+/*! @file geomAcceptance.cpp Standalone multithreaded geometric acceptance of the Calo fiducial volume.
+ *
+ * Generates primaries on the generation sphere as SyntheticEvents, applies the selections of the reference chain
+ * (polar angle, Calo track length and tracker layers, Calo fiducial volume) with a straight-line geometry and writes
+ * the momentum histograms of the generated and selected events with the names of the EventAnalysis outputs, so the
+ * result is read by acceptanceBuilder (with -r set to the radius in m) and merged by acceptanceMerger. The histograms
+ * contain integer counts; the same seed and event range give the same file for any number of threads.
+ *
+ * With -q the primaries come from scrambled Sobol points instead of pseudo-random numbers. With -R the run is repeated
+ * with the seeds seed, seed + 1, ...: the count histograms are the sums of the replicas and h_acceptance_replicas holds
+ * the mean acceptance of the replicas (m^2 sr) with its standard error, which is the error estimate for Sobol runs.
+ *
+ * Usage: geomAcceptance -o <output.root> [-n nevents] [-f first] [-s seed] [-j nthreads] [-q] [-R nreplicas]
+ *                       [-b nbins,min,max] [-L] [-i index] [-r radius] [-t maxtheta] [-B] [-x mincalotrackx0]
+ *                       [-k stklayers] [-m minstk] [-a alpha] [-c cubeside]
+ */
+
+#include "GeomEngine.h"
+
+// Root headers
+#include "TFile.h"
+#include "TH1D.h"
+
+// C/C++ standard headers
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX headers
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " -o <output.root> [-n nevents] [-f first] [-s seed] [-j nthreads] [-q] [-R nreplicas]"
+               " [-b nbins,min,max] [-L] [-i index] [-r radius] [-t maxtheta] [-B] [-x mincalotrackx0] [-k stklayers]"
+               " [-m minstk] [-a alpha] [-c cubeside]\n"
+            << "  -n  Number of events per replica (default: 1000000; a power of 2 is best with -q)\n"
+            << "  -f  Index of the first event, to split a run in independent parts (default: 0)\n"
+            << "  -s  Seed (default: 1)\n"
+            << "  -j  Number of threads (default: number of cores)\n"
+            << "  -q  Scrambled Sobol (quasi-Monte Carlo) sampling\n"
+            << "  -R  Number of independent replicas, for the error estimate (default: 1)\n"
+            << "  -b  Momentum axis and generation range in GeV/c (default: 100,10,10000)\n"
+            << "  -L  Linear momentum axis (default: logarithmic)\n"
+            << "  -i  Spectral index of the generation (default: -1)\n"
+            << "  -r  Radius of the generation sphere in cm (default: 300)\n"
+            << "  -t  Maximum polar angle of the arrival direction in deg (default: 180)\n"
+            << "  -B  Accept tracks entering the Calo from the bottom\n"
+            << "  -x  Minimum Calo track length in X0 (default: 20)\n"
+            << "  -k  Tracker layer file, one \"axis position min1 max1 min2 max2\" per line\n"
+            << "  -m  Minimum number of tracker layers crossed (default: -1)\n"
+            << "  -a  Fiducial volume shrink in cube sides (default: 1)\n"
+            << "  -c  Calo cube side in cm (default: 3)\n";
+}
+
+bool ParseAxis(const std::string &text, std::vector<double> &axispar) {
+  std::istringstream fields(text);
+  std::string field;
+  axispar.clear();
+  while (std::getline(fields, field, ',')) {
+    char *end;
+    axispar.push_back(std::strtod(field.c_str(), &end));
+    if (field.empty() || *end != '\0') return false;
+  }
+  return axispar.size() == 3;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  std::string output, stklayers, axistext = "100,10,10000";
+  unsigned long long nevents = 1000000, first = 0, seed = 1;
+  unsigned int nthreads = std::thread::hardware_concurrency(), nreplicas = 1;
+  bool logaxis = true, sobol = false;
+  double index = -1, radius = 300;
+  Herd::GeomSelection selection;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "o:n:f:s:j:qR:b:Li:r:t:Bx:k:m:a:c:h")) != -1) {
+    switch (opt) {
+    case 'o': output = optarg; break;
+    case 'n': nevents = std::strtoull(optarg, nullptr, 10); break;
+    case 'f': first = std::strtoull(optarg, nullptr, 10); break;
+    case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+    case 'j': nthreads = std::atoi(optarg); break;
+    case 'q': sobol = true; break;
+    case 'R': nreplicas = std::atoi(optarg); break;
+    case 'b': axistext = optarg; break;
+    case 'L': logaxis = false; break;
+    case 'i': index = std::atof(optarg); break;
+    case 'r': radius = std::atof(optarg); break;
+    case 't': selection.maxtheta = std::atof(optarg); break;
+    case 'B': selection.notfrombottom = false; break;
+    case 'x': selection.mincalotrackx0 = std::atof(optarg); break;
+    case 'k': stklayers = optarg; break;
+    case 'm': selection.minstkintersections = std::atoi(optarg); break;
+    case 'a': selection.alpha = std::atof(optarg); break;
+    case 'c': selection.cubeside = std::atof(optarg); break;
+    default: Usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  std::vector<double> axispar;
+  if (output.empty() || nevents == 0 || nreplicas == 0 || !ParseAxis(axistext, axispar) ||
+      (sobol && (first >= Herd::GeomEngine::MaxSobolEvents || nevents > Herd::GeomEngine::MaxSobolEvents - first))) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  std::string errmsg;
+  Herd::Binning binning;
+  Herd::SphereGenerator generator;
+  Herd::GeomEngine engine;
+  if (!binning.Set(axispar, logaxis, "momentum", errmsg) ||
+      !generator.Configure(radius, index, axispar[1], axispar[2], errmsg) ||
+      !engine.Configure(generator, selection, binning, errmsg) ||
+      (!stklayers.empty() && !engine.LoadStkLayers(stklayers, errmsg))) {
+    std::cerr << errmsg << std::endl;
+    return 1;
+  }
+  engine.SetSampling(sobol ? Herd::GeomEngine::SOBOL : Herd::GeomEngine::PSEUDORANDOM);
+
+  //Acceptance of every replica per bin (last entry: all the bins), and the counts summed over the replicas
+  const double geomfactor = M_PI * 4 * M_PI * radius * radius / 1e4;
+  const size_t ncells = binning.NBins() + 2;
+  std::vector<std::vector<double>> acceptance(nreplicas, std::vector<double>(ncells + 1, 0.));
+  std::vector<uint64_t> total[Herd::GeomEngine::NSTAGES];
+  for (auto &counts : total) counts.assign(ncells, 0);
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int ireplica = 0; ireplica < nreplicas; ireplica++) {
+    engine.Reset();
+    engine.Run(seed + ireplica, first, nevents, nthreads);
+    for (int istage = 0; istage < Herd::GeomEngine::NSTAGES; istage++) {
+      const std::vector<uint64_t> &counts = engine.Counts(static_cast<Herd::GeomEngine::Stage>(istage));
+      for (size_t cell = 0; cell < ncells; cell++) total[istage][cell] += counts[cell];
+    }
+    const std::vector<uint64_t> &generated = engine.Counts(Herd::GeomEngine::GENERATED);
+    const std::vector<uint64_t> &selected = engine.Counts(Herd::GeomEngine::FIDVOLUME);
+    uint64_t nselected = 0;
+    for (size_t cell = 0; cell < ncells; cell++) {
+      if (generated[cell] > 0) acceptance[ireplica][cell] = geomfactor * selected[cell] / generated[cell];
+      nselected += selected[cell];
+    }
+    acceptance[ireplica][ncells] = geomfactor * nselected / nevents;
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  //Mean and standard error over the replicas
+  std::vector<double> mean(ncells + 1, 0.), error(ncells + 1, 0.);
+  for (size_t cell = 0; cell <= ncells; cell++) {
+    for (auto const &replica : acceptance) mean[cell] += replica[cell] / nreplicas;
+    if (nreplicas < 2) continue;
+    double sum2 = 0;
+    for (auto const &replica : acceptance) sum2 += (replica[cell] - mean[cell]) * (replica[cell] - mean[cell]);
+    error[cell] = std::sqrt(sum2 / (nreplicas - 1) / nreplicas);
+  }
+
+  TH1::AddDirectory(false);
+  std::unique_ptr<TFile> file(TFile::Open(output.c_str(), "RECREATE"));
+  if (!file || file->IsZombie()) {
+    std::cerr << "Cannot write " << output << std::endl;
+    return 1;
+  }
+  const std::vector<double> &edges = binning.Edges();
+  for (int istage = 0; istage < Herd::GeomEngine::NSTAGES; istage++) {
+    const auto stage = static_cast<Herd::GeomEngine::Stage>(istage);
+    const std::string name = std::string("h_") + Herd::GeomEngine::StageName(stage);
+    TH1D histo(name.c_str(), name.c_str(), binning.NBins(), edges.data());
+    histo.GetXaxis()->SetTitle("p (GeV/c)");
+    const std::vector<uint64_t> &counts = total[istage];
+    uint64_t entries = 0;
+    for (size_t bin = 0; bin < counts.size(); bin++) {
+      histo.SetBinContent(bin, counts[bin]);
+      histo.SetBinError(bin, std::sqrt((double)counts[bin]));
+      entries += counts[bin];
+    }
+    histo.SetEntries(entries);
+    file->cd();
+    histo.Write();
+  }
+  if (nreplicas > 1) {
+    TH1D histo("h_acceptance_replicas", "Acceptance (m^{2} sr)", binning.NBins(), edges.data());
+    histo.GetXaxis()->SetTitle("p (GeV/c)");
+    for (size_t cell = 0; cell < ncells; cell++) {
+      histo.SetBinContent(cell, mean[cell]);
+      histo.SetBinError(cell, error[cell]);
+    }
+    histo.SetEntries(nreplicas);
+    file->cd();
+    histo.Write();
+  }
+  file->Close();
+
+  const uint64_t ngenerated = nevents * nreplicas;
+  std::cout << "Generated " << ngenerated << " events in " << seconds << " s (" << ngenerated / seconds / 1e6
+            << " M/s), acceptance " << mean[ncells];
+  if (nreplicas > 1) std::cout << " +- " << error[ncells];
+  std::cout << " m^2 sr" << std::endl;
+  return 0;
+}
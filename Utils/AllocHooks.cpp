@@ -0,0 +1,111 @@
+/*! @file AllocHooks.cpp Counting replacements of malloc and operator new for the allocation-tracking mode.
+ *
+ * Built as its own library, to be preloaded into EventAnalysis:
+ *
+ *   LD_PRELOAD=libacceptanceAllocHooks.so EventAnalysis -c config.eaconf
+ *
+ * Every allocation increments two process-wide counters and is then forwarded to the glibc allocator, so memory
+ * obtained here can be released by any free. With the hooks loaded, each ProcessTimer publishes the allocations per
+ * Process() call (see AllocTracker.h); Tools/allocCheck runs a configuration this way and checks them.
+ */
+
+// C/C++ standard headers
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+namespace {
+
+//Constant-initialized, so usable by allocations made before the static constructors run
+std::atomic<uint64_t> nallocs{0};
+std::atomic<uint64_t> nbytes{0};
+
+inline void Count(size_t size) {
+  nallocs.fetch_add(1, std::memory_order_relaxed);
+  nbytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void *New(size_t size) {
+  Count(size);
+  void *ptr = __libc_malloc(size ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+} // namespace
+
+extern "C" {
+
+void herd_alloc_count(uint64_t *allocs, uint64_t *bytes) {
+  *allocs = nallocs.load(std::memory_order_relaxed);
+  *bytes = nbytes.load(std::memory_order_relaxed);
+}
+
+void *malloc(size_t size) noexcept {
+  Count(size);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) noexcept {
+  Count(n * size);
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+  Count(size);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept { __libc_free(ptr); }
+
+void *memalign(size_t alignment, size_t size) noexcept {
+  Count(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) noexcept {
+  Count(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) noexcept {
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) return EINVAL;
+  Count(size);
+  void *result = __libc_memalign(alignment, size);
+  if (!result) return ENOMEM;
+  *ptr = result;
+  return 0;
+}
+
+} // extern "C"
+
+void *operator new(size_t size) { return New(size); }
+void *operator new[](size_t size) { return New(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  Count(size);
+  return __libc_malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  Count(size);
+  return __libc_malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept { __libc_free(ptr); }
+void operator delete[](void *ptr) noexcept { __libc_free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { __libc_free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { __libc_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { __libc_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { __libc_free(ptr); }
@@ -0,0 +1,40 @@
+/*! @file AllocTracker.h Process-wide allocation counters of the allocation-tracking mode. */
+
+#ifndef HERD_ALLOCTRACKER_H_
+#define HERD_ALLOCTRACKER_H_
+
+// C/C++ standard headers
+#include <cstdint>
+
+/*! @brief Number and size of the allocations made by all the threads since the start of the process.
+ *
+ * Defined only by the allocation hooks (Utils/AllocHooks.cpp, built as libacceptanceAllocHooks.so and preloaded into
+ * EventAnalysis); the weak reference is null otherwise.
+ */
+extern "C" void herd_alloc_count(uint64_t *allocs, uint64_t *bytes) __attribute__((weak));
+
+namespace Herd {
+
+struct AllocCount {
+  uint64_t allocs;
+  uint64_t bytes;
+};
+
+/*! @brief True if the allocation hooks are loaded in the process. */
+inline bool AllocTrackingActive() { return herd_alloc_count != nullptr; }
+
+/*! @brief Allocations of the process up to now, zero if the hooks are not loaded.
+ *
+ * Every call to malloc, calloc, realloc, the aligned allocation functions and operator new (all the variants) counts
+ * as one allocation. The counters are shared by all the threads, so the difference of two reads around a code section
+ * includes the allocations of the threads it waits for.
+ */
+inline AllocCount CurrentAllocCount() {
+  AllocCount count{0, 0};
+  if (herd_alloc_count) herd_alloc_count(&count.allocs, &count.bytes);
+  return count;
+}
+
+} // namespace Herd
+
+#endif /* HERD_ALLOCTRACKER_H_ */
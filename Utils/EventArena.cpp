@@ -0,0 +1,42 @@
+/*! @file EventArena.cpp EventArena class implementation. */
+
+#include "EventArena.h"
+
+// C/C++ standard headers
+#include <cstdint>
+
+namespace Herd {
+
+EventArena::EventArena(size_t initialbytes)
+    : _block{new char[initialbytes]}, _capacity{initialbytes}, _offset{0}, _overflowbytes{0} {}
+
+void *EventArena::AllocateBytes(size_t bytes, size_t align) {
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(_block.get());
+  size_t offset = ((base + _offset + align - 1) & ~(uintptr_t)(align - 1)) - base;
+  if (offset + bytes <= _capacity) {
+    _offset = offset + bytes;
+    return _block.get() + offset;
+  }
+
+  // Does not fit: serve it from an overflow block, the main block will be enlarged at the next Reset
+  _overflow.emplace_back(new char[bytes + align]);
+  _overflowbytes += bytes + align;
+  uintptr_t ptr = reinterpret_cast<uintptr_t>(_overflow.back().get());
+  return reinterpret_cast<void *>((ptr + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void EventArena::Reset() {
+
+  if (!_overflow.empty()) {
+    size_t capacity = _capacity > 0 ? _capacity : 1;
+    while (capacity < _offset + _overflowbytes) capacity *= 2;
+    _overflow.clear();
+    _block.reset(new char[capacity]);
+    _capacity = capacity;
+  }
+  _overflowbytes = 0;
+  _offset = 0;
+}
+
+} // namespace Herd
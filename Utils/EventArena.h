@@ -0,0 +1,57 @@
+/*! @file EventArena.h EventArena class declaration. */
+
+#ifndef HERD_EVENTARENA_H_
+#define HERD_EVENTARENA_H_
+
+// C/C++ standard headers
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Resettable bump allocator for per-event scratch buffers.
+ * @class EventArena EventArena.h
+ *
+ * Allocate hands out consecutive chunks of one memory block and Reset rewinds it, so the memory is reused by the next
+ * event. Requests that do not fit in the block are served by separate overflow blocks; at the next Reset these are
+ * released and the main block is enlarged to hold the whole peak usage. After the first few events the arena does not
+ * allocate any more. Only trivially destructible types can be allocated, since no destructor is ever run.
+ */
+class EventArena {
+public:
+  /*! @brief Constructor.
+   *
+   * @param initialbytes Initial size of the main block.
+   */
+  explicit EventArena(size_t initialbytes = 65536);
+
+  /*! @brief Allocates and default-constructs n objects of type T. */
+  template <class T> T *Allocate(size_t n) {
+    static_assert(std::is_trivially_destructible<T>::value, "EventArena objects are never destroyed");
+    T *ptr = static_cast<T *>(AllocateBytes(n * sizeof(T), alignof(T)));
+    for (size_t i = 0; i < n; i++) new (ptr + i) T();
+    return ptr;
+  }
+
+  /*! @brief Releases all the allocations, keeping (and possibly enlarging) the main block. */
+  void Reset();
+
+  size_t Capacity() const { return _capacity; }
+  size_t Used() const { return _offset + _overflowbytes; }
+
+private:
+  void *AllocateBytes(size_t bytes, size_t align);
+
+  std::unique_ptr<char[]> _block;
+  size_t _capacity;
+  size_t _offset;
+  std::vector<std::unique_ptr<char[]>> _overflow;
+  size_t _overflowbytes;
+};
+
+} // namespace Herd
+
+#endif /* HERD_EVENTARENA_H_ */
@@ -0,0 +1,52 @@
+/*! @file FastRandom.h Small, fast pseudo-random generator. */
+
+#ifndef HERD_FASTRANDOM_H_
+#define HERD_FASTRANDOM_H_
+
+// C/C++ standard headers
+#include <cstdint>
+
+namespace Herd {
+
+/*! @brief xoshiro256+ generator (Blackman and Vigna), seeded through splitmix64.
+ * @class Xoshiro256 FastRandom.h
+ *
+ * A few ns per number and 32 bytes of state, enough for generating synthetic events; not for cryptography. The
+ * lowest bits of Next() are weaker than the others, which does not matter for Uniform().
+ */
+class Xoshiro256 {
+public:
+  explicit Xoshiro256(uint64_t seed = 0) { Seed(seed); }
+
+  void Seed(uint64_t seed) {
+    for (auto &word : _state) {
+      seed += 0x9e3779b97f4a7c15ull;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t Next() {
+    const uint64_t result = _state[0] + _state[3];
+    const uint64_t t = _state[1] << 17;
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = (_state[3] << 45) | (_state[3] >> 19);
+    return result;
+  }
+
+  /*! @brief Uniform in [0, 1), with 53 random bits. */
+  double Uniform() { return (Next() >> 11) * (1. / 9007199254740992.); }
+
+private:
+  uint64_t _state[4];
+};
+
+} // namespace Herd
+
+#endif /* HERD_FASTRANDOM_H_ */
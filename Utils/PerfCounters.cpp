@@ -0,0 +1,70 @@
+/*! @file PerfCounters.cpp PerfCounters class implementation. */
+
+#include "PerfCounters.h"
+
+// C/C++ standard headers
+#include <cstring>
+
+// POSIX headers
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Herd {
+
+namespace {
+
+const uint64_t configs[PerfCounters::NCOUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_CACHE_MISSES};
+
+} // namespace
+
+PerfCounters &PerfCounters::ThisThread() {
+  thread_local PerfCounters counters;
+  return counters;
+}
+
+const char *PerfCounters::Name(int counter) {
+  static const char *names[NCOUNTERS] = {"cycles", "instructions", "cachemisses"};
+  return counter >= 0 && counter < NCOUNTERS ? names[counter] : "";
+}
+
+PerfCounters::PerfCounters() {
+  for (int icounter = 0; icounter < NCOUNTERS; icounter++) _fds[icounter] = -1;
+
+  for (int icounter = 0; icounter < NCOUNTERS; icounter++) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[icounter];
+    attr.disabled = icounter == 0; // The leader starts the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    _fds[icounter] = syscall(__NR_perf_event_open, &attr, 0, -1, icounter == 0 ? -1 : _fds[0], 0);
+    if (_fds[icounter] < 0) {
+      for (int jcounter = 0; jcounter < icounter; jcounter++) close(_fds[jcounter]);
+      for (int jcounter = 0; jcounter < NCOUNTERS; jcounter++) _fds[jcounter] = -1;
+      return;
+    }
+  }
+  ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int icounter = 0; icounter < NCOUNTERS; icounter++)
+    if (_fds[icounter] >= 0) close(_fds[icounter]);
+}
+
+bool PerfCounters::Read(uint64_t values[NCOUNTERS]) const {
+  if (!IsOpen()) return false;
+  uint64_t buffer[1 + NCOUNTERS]; // Number of counters, then their values
+  if (read(_fds[0], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer) || buffer[0] != NCOUNTERS) return false;
+  for (int icounter = 0; icounter < NCOUNTERS; icounter++) values[icounter] = buffer[1 + icounter];
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,44 @@
+/*! @file PerfCounters.h PerfCounters class declaration. */
+
+#ifndef HERD_PERFCOUNTERS_H_
+#define HERD_PERFCOUNTERS_H_
+
+// C/C++ standard headers
+#include <cstdint>
+
+namespace Herd {
+
+/*! @brief Hardware counters of the calling thread, through perf_event_open.
+ * @class PerfCounters PerfCounters.h
+ *
+ * The counters (user-space cycles, instructions and last-level cache misses) are opened as one group on the first
+ * use from each thread and run freely; Read returns their current values with a single system call, so the cost of
+ * a code section is the difference of two reads on the same thread. If the kernel refuses the counters (e.g.
+ * kernel.perf_event_paranoid, or inside a container) IsOpen is false and Read fails.
+ */
+class PerfCounters {
+public:
+  enum Counter { CYCLES, INSTRUCTIONS, CACHEMISSES, NCOUNTERS };
+
+  /*! @brief The counters of the calling thread. */
+  static PerfCounters &ThisThread();
+
+  static const char *Name(int counter);
+
+  bool IsOpen() const { return _fds[0] >= 0; }
+
+  bool Read(uint64_t values[NCOUNTERS]) const;
+
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+private:
+  PerfCounters();
+
+  int _fds[NCOUNTERS];
+};
+
+} // namespace Herd
+
+#endif /* HERD_PERFCOUNTERS_H_ */
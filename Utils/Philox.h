@@ -0,0 +1,73 @@
+/*! @file Philox.h Counter-based Philox4x32-10 generator. */
+
+#ifndef HERD_PHILOX_H_
+#define HERD_PHILOX_H_
+
+// C/C++ standard headers
+#include <cstdint>
+
+namespace Herd {
+
+/*! @brief The Philox4x32-10 block function (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11).
+ *
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits. Any counter can be evaluated directly, so the random
+ * numbers of an item of work depend only on its index and not on which thread processes it or in which order.
+ */
+inline void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round < 10; round++) {
+    const uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+    const uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+    c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (uint32_t)p1;
+    c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (uint32_t)p0;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+/*! @brief Stream of uniform numbers of one item of work, e.g. an event.
+ * @class PhiloxStream Philox.h
+ *
+ * The counter is (item index, draw number): the n-th number of an item is the same whatever the partition of the
+ * items among threads. Each block gives two doubles with 53 random bits.
+ */
+class PhiloxStream {
+public:
+  PhiloxStream(uint64_t seed, uint64_t item) : _ndraw{0}, _nleft{0} {
+    _key[0] = (uint32_t)seed;
+    _key[1] = (uint32_t)(seed >> 32);
+    _counter[0] = (uint32_t)item;
+    _counter[1] = (uint32_t)(item >> 32);
+    _counter[3] = 0;
+  }
+
+  /*! @brief Uniform in [0, 1). */
+  double Uniform() {
+    if (_nleft == 0) {
+      _counter[2] = _ndraw++;
+      Philox4x32(_counter, _key, _block);
+      _nleft = 2;
+    }
+    const uint32_t *words = _block + 2 * (2 - _nleft--);
+    const uint64_t bits = ((uint64_t)words[0] << 32) | words[1];
+    return (bits >> 11) * (1. / 9007199254740992.);
+  }
+
+private:
+  uint32_t _key[2];
+  uint32_t _counter[4];
+  uint32_t _block[4];
+  uint32_t _ndraw;
+  int _nleft;
+};
+
+} // namespace Herd
+
+#endif /* HERD_PHILOX_H_ */
@@ -0,0 +1,42 @@
+/*! @file ScopedTimer.h Monotonic clock and scoped timer. */
+
+#ifndef HERD_SCOPEDTIMER_H_
+#define HERD_SCOPEDTIMER_H_
+
+// C/C++ standard headers
+#include <cstdint>
+
+// POSIX headers
+#include <time.h>
+
+namespace Herd {
+
+/*! @brief Monotonic time in ns (clock_gettime, served by the vDSO without a system call). */
+inline uint64_t MonotonicNs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+/*! @brief Measures the lifetime of a scope.
+ * @class ScopedTimer ScopedTimer.h
+ *
+ * The recorder provides a Mark type with Mark Start() and void Stop(const Mark &), called at construction and
+ * destruction, so every return path of the timed function is measured.
+ */
+template <class Recorder> class ScopedTimer {
+public:
+  explicit ScopedTimer(Recorder &recorder) : _recorder(recorder), _start(recorder.Start()) {}
+  ~ScopedTimer() { _recorder.Stop(_start); }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  Recorder &_recorder;
+  const typename Recorder::Mark _start;
+};
+
+} // namespace Herd
+
+#endif /* HERD_SCOPEDTIMER_H_ */
@@ -0,0 +1,79 @@
+/*! @file Sobol.cpp SobolSampler class implementation. */
+
+#include "Sobol.h"
+
+// C/C++ standard headers
+#include <algorithm>
+
+namespace Herd {
+
+namespace {
+
+//Degree, coefficients and initial direction numbers of dimensions 2 to 8 (new-joe-kuo-6.21201)
+struct Primitive {
+  int s, a;
+  uint32_t m[5];
+};
+const Primitive primitives[SobolSampler::MaxDimensions - 1] = {
+    {1, 0, {1}},          {2, 1, {1, 3}},          {3, 1, {1, 3, 1}},         {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}}, {4, 4, {1, 3, 5, 13}}, {5, 2, {1, 1, 5, 5, 17}},
+};
+
+uint32_t ReverseBits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+//Nested uniform scramble: every bit is flipped depending on the seed and on the more significant bits only
+uint32_t OwenScramble(uint32_t x, uint32_t seed) {
+  x = ReverseBits(x);
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return ReverseBits(x);
+}
+
+uint32_t Mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return (uint32_t)x;
+}
+
+} // namespace
+
+SobolSampler::SobolSampler(int ndimensions) : _ndimensions{std::max(1, std::min(ndimensions, (int)MaxDimensions))} {
+  for (int bit = 0; bit < 32; bit++) _directions[0][bit] = 1u << (31 - bit);
+  for (int dim = 1; dim < MaxDimensions; dim++) {
+    const Primitive &primitive = primitives[dim - 1];
+    uint32_t *v = _directions[dim];
+    for (int bit = 0; bit < 32; bit++) {
+      if (bit < primitive.s) {
+        v[bit] = primitive.m[bit] << (31 - bit);
+        continue;
+      }
+      v[bit] = v[bit - primitive.s] ^ (v[bit - primitive.s] >> primitive.s);
+      for (int j = 1; j < primitive.s; j++)
+        if ((primitive.a >> (primitive.s - 1 - j)) & 1) v[bit] ^= v[bit - j];
+    }
+  }
+}
+
+void SobolSampler::Point(uint32_t index, uint64_t seed, double *u) const {
+  for (int dim = 0; dim < _ndimensions; dim++) {
+    uint32_t x = 0;
+    for (uint32_t bits = index, bit = 0; bits != 0; bits >>= 1, bit++)
+      if (bits & 1) x ^= _directions[dim][bit];
+    x = OwenScramble(x, Mix(seed * 0x9E3779B97F4A7C15ULL + dim));
+    u[dim] = x * (1. / 4294967296.);
+  }
+}
+
+} // namespace Herd
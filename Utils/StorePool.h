@@ -0,0 +1,65 @@
+/*! @file StorePool.h StorePool class declaration. */
+
+#ifndef HERD_STOREPOOL_H_
+#define HERD_STOREPOOL_H_
+
+// C/C++ standard headers
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Per-event store objects, recycled once nobody else holds them.
+ * @class StorePool StorePool.h
+ *
+ * Acquire returns a reset store which is referenced only by the pool: a store still held by the event data store, or
+ * by anybody who took it from there, is never reused, so every event gets an object of its own as if a new one were
+ * created. New stores are only created while the pool grows to the number of events whose stores are alive at the same
+ * time (one or two), after that Acquire does not allocate. T must have a Reset(), and be constructible from its name
+ * unless the pool is initialized with a function making the stores; types without a Reset() (e.g. the HerdSoftware
+ * data objects) are pooled with a reset function too.
+ */
+template <class T> class StorePool {
+public:
+  /*! @brief Drops the stores of a previous run and creates nstores stores named name. */
+  void Init(const std::string &name, size_t nstores = 2) {
+    Init([name]() { return std::make_shared<T>(name); }, nstores);
+  }
+
+  /*! @brief Drops the stores of a previous run and creates nstores stores with make (also used to grow the pool). */
+  void Init(std::function<std::shared_ptr<T>()> make, size_t nstores = 2) {
+    Init(std::move(make), [](T &store) { store.Reset(); }, nstores);
+  }
+
+  /*! @brief As above, with reset called on a store before it is handed out again. */
+  void Init(std::function<std::shared_ptr<T>()> make, std::function<void(T &)> reset, size_t nstores = 2) {
+    _make = std::move(make);
+    _reset = std::move(reset);
+    _stores.clear();
+    for (size_t istore = 0; istore < nstores; istore++) _stores.push_back(_make());
+  }
+
+  /*! @brief A reset store for the current event. */
+  std::shared_ptr<T> Acquire() {
+    for (auto &store : _stores) {
+      if (store.use_count() == 1) {
+        _reset(*store);
+        return store;
+      }
+    }
+    _stores.push_back(_make());
+    _reset(*_stores.back());
+    return _stores.back();
+  }
+
+private:
+  std::function<std::shared_ptr<T>()> _make;
+  std::function<void(T &)> _reset;
+  std::vector<std::shared_ptr<T>> _stores;
+};
+
+} // namespace Herd
+
+#endif /* HERD_STOREPOOL_H_ */
@@ -0,0 +1,72 @@
+/*! @file ThreadIndex.h Dense per-thread index. */
+
+#ifndef HERD_THREADINDEX_H_
+#define HERD_THREADINDEX_H_
+
+// C/C++ standard headers
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Per-thread shards of the sharded containers (ShardedHistogram, ShardedPoints), hence the largest useful
+ *         thread count of a pool filling them. */
+const unsigned int MaxThreadShards = 64;
+
+namespace detail {
+
+/*! @brief Hands out the smallest index not held by a running thread; an exiting thread gives its index back. */
+class ThreadIndexRegistry {
+public:
+  static ThreadIndexRegistry &Instance() {
+    static ThreadIndexRegistry *registry = new ThreadIndexRegistry; // Never destroyed: threads may exit after main
+    return *registry;
+  }
+
+  unsigned int Acquire() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_free.empty()) return _next++;
+    const unsigned int index = _free.top();
+    _free.pop();
+    return index;
+  }
+
+  void Release(unsigned int index) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _free.push(index);
+  }
+
+private:
+  ThreadIndexRegistry() : _next{0} {}
+
+  std::mutex _mutex;
+  unsigned int _next;
+  std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int>> _free;
+};
+
+struct ThreadIndexHolder {
+  ThreadIndexHolder() : index{ThreadIndexRegistry::Instance().Acquire()} {}
+  ~ThreadIndexHolder() { ThreadIndexRegistry::Instance().Release(index); }
+  const unsigned int index;
+};
+
+} // namespace detail
+
+/*! @brief Index of the calling thread, dense among the threads alive: 0 for the first thread asking for it, then 1, 2, ...
+ *
+ * The index is assigned on the first call from each thread and never changes afterwards, so it can be used to pick a
+ * per-thread slot (e.g. a histogram shard) without any locking. When a thread exits its index goes back to the pool and
+ * the next new thread gets the smallest free one, so the indices stay below the number of threads alive at the same
+ * time, however many pools are created and destroyed during the job. The registry lock is only taken at the first call
+ * of a thread and at its exit.
+ */
+inline unsigned int CurrentThreadIndex() {
+  thread_local detail::ThreadIndexHolder holder;
+  return holder.index;
+}
+
+} // namespace Herd
+
+#endif /* HERD_THREADINDEX_H_ */
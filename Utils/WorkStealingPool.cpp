@@ -0,0 +1,109 @@
+/*! @file WorkStealingPool.cpp WorkStealingPool class implementation. */
+
+#include "WorkStealingPool.h"
+
+namespace Herd {
+
+WorkStealingPool::WorkStealingPool(unsigned int nthreads)
+    : _nthreads{nthreads > 0 ? nthreads : 1}, _generation{0}, _busy{0}, _stop{false}, _fn{nullptr}, _ctx{nullptr} {
+
+  for (unsigned int ithread = 0; ithread < _nthreads; ithread++) {
+    _slots.emplace_back(new Slot);
+    _slots.back()->begin = _slots.back()->end = 0;
+  }
+  for (unsigned int ithread = 1; ithread < _nthreads; ithread++) _threads.emplace_back(&WorkStealingPool::WorkerLoop, this, ithread);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (auto &thread : _threads) thread.join();
+}
+
+void WorkStealingPool::Run(size_t ntasks, TaskFn fn, void *ctx) {
+
+  if (_nthreads == 1 || ntasks <= 1) {
+    for (size_t index = 0; index < ntasks; index++) fn(ctx, index, 0);
+    return;
+  }
+
+  for (unsigned int ithread = 0; ithread < _nthreads; ithread++) {
+    _slots[ithread]->begin = ntasks * ithread / _nthreads;
+    _slots[ithread]->end = ntasks * (ithread + 1) / _nthreads;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fn = fn;
+    _ctx = ctx;
+    _busy = _nthreads - 1;
+    _generation++;
+  }
+  _wake.notify_all();
+
+  Work(0);
+
+  // The task lives on the caller's stack: wait until every worker has left it
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done.wait(lock, [this] { return _busy == 0; });
+}
+
+void WorkStealingPool::WorkerLoop(unsigned int thread) {
+
+  unsigned long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _wake.wait(lock, [this, seen] { return _stop || _generation != seen; });
+      if (_stop) return;
+      seen = _generation;
+    }
+    Work(thread);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (--_busy == 0) _done.notify_one();
+    }
+  }
+}
+
+void WorkStealingPool::Work(unsigned int thread) {
+
+  size_t index;
+  for (;;) {
+    while (Pop(thread, index)) _fn(_ctx, index, thread);
+    bool stolen = false;
+    for (unsigned int i = 1; i < _nthreads && !stolen; i++) stolen = Steal((thread + i) % _nthreads, thread);
+    if (!stolen) return;
+  }
+}
+
+bool WorkStealingPool::Pop(unsigned int thread, size_t &index) {
+
+  Slot &slot = *_slots[thread];
+  std::lock_guard<std::mutex> lock(slot.mutex);
+  if (slot.begin >= slot.end) return false;
+  index = slot.begin++;
+  return true;
+}
+
+bool WorkStealingPool::Steal(unsigned int victim, unsigned int thief) {
+
+  size_t begin, end;
+  {
+    Slot &slot = *_slots[victim];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.begin >= slot.end) return false;
+    end = slot.end;
+    begin = slot.end - (slot.end - slot.begin + 1) / 2;
+    slot.end = begin;
+  }
+  Slot &slot = *_slots[thief];
+  std::lock_guard<std::mutex> lock(slot.mutex);
+  slot.begin = begin;
+  slot.end = end;
+  return true;
+}
+
+} // namespace Herd
@@ -0,0 +1,83 @@
+/*! @file WorkStealingPool.h WorkStealingPool class declaration. */
+
+#ifndef HERD_WORKSTEALINGPOOL_H_
+#define HERD_WORKSTEALINGPOOL_H_
+
+// C/C++ standard headers
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Herd {
+
+/*! @brief Fixed-size thread pool running indexed loops with range stealing.
+ * @class WorkStealingPool WorkStealingPool.h
+ *
+ * ParallelFor splits the index range evenly among the participants (the calling thread plus the workers). Each
+ * participant consumes its own range from the front; when it is empty it steals the back half of the range of another
+ * participant. Tasks are identified by their index only, so results written to per-index slots do not depend on the
+ * number of threads or on the scheduling. The task is passed by reference without type erasure into a
+ * std::function, so a call does not allocate.
+ */
+class WorkStealingPool {
+public:
+  /*! @brief Constructor.
+   *
+   * @param nthreads Total number of threads running the tasks, including the caller of ParallelFor.
+   */
+  explicit WorkStealingPool(unsigned int nthreads);
+
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  unsigned int NThreads() const { return _nthreads; }
+
+  /*! @brief Runs task(index, thread) for every index in [0, ntasks) and waits for completion.
+   *
+   * thread is the participant running the task (0 for the caller), in [0, NThreads()).
+   */
+  template <class Task> void ParallelFor(size_t ntasks, Task &&task) {
+    Run(ntasks, &Invoke<typename std::remove_reference<Task>::type>, &task);
+  }
+
+private:
+  typedef void (*TaskFn)(void *, size_t, unsigned int);
+  template <class Task> static void Invoke(void *task, size_t index, unsigned int thread) {
+    (*static_cast<Task *>(task))(index, thread);
+  }
+
+  struct alignas(64) Slot {
+    std::mutex mutex;
+    size_t begin, end;
+  };
+
+  void Run(size_t ntasks, TaskFn fn, void *ctx);
+  void WorkerLoop(unsigned int thread);
+  void Work(unsigned int thread);
+  bool Pop(unsigned int thread, size_t &index);
+  bool Steal(unsigned int victim, unsigned int thief);
+
+  const unsigned int _nthreads;
+  std::vector<std::unique_ptr<Slot>> _slots;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  unsigned long _generation;
+  unsigned int _busy;
+  bool _stop;
+
+  TaskFn _fn;
+  void *_ctx;
+};
+
+} // namespace Herd
+
+#endif /* HERD_WORKSTEALINGPOOL_H_ */